@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "Arena.h"
+
+using namespace std;
+
+void Arena::grow(size_t minBytes) {
+	size_t size = max(nextSize, minBytes + HEADER_SIZE);
+	char* memory = static_cast<char*>(::operator new(size));
+	Block* block = new (memory) Block{ blocks, size };
+	blocks = block;
+	cursor = memory + HEADER_SIZE;
+	end = memory + size;
+	nextSize = size * 2;
+}
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+	bytes = max<size_t>(bytes, 1); // never hand out the same address twice
+	void* p = cursor;
+	size_t space = end - cursor;
+	if (!align(alignment, bytes, p, space)) {
+		grow(bytes + alignment);
+		p = cursor;
+		space = end - cursor;
+		align(alignment, bytes, p, space);
+	}
+	cursor = static_cast<char*>(p) + bytes;
+	used += bytes;
+	return p;
+}
+
+string_view Arena::copy(string_view s) {
+	char* chars = static_cast<char*>(allocate(s.size(), 1));
+	memcpy(chars, s.data(), s.size());
+	return { chars, s.size() };
+}
+
+void Arena::release() {
+	if (blocks == nullptr) return;
+	// blocks only grow, so the most recent is the largest
+	Block* keep = blocks;
+	Block* b = keep->next;
+	while (b != nullptr) {
+		Block* next = b->next;
+		::operator delete(b);
+		b = next;
+	}
+	keep->next = nullptr;
+	cursor = reinterpret_cast<char*>(keep) + HEADER_SIZE;
+	end = reinterpret_cast<char*>(keep) + keep->size;
+	used = 0;
+}
+
+Arena::~Arena() {
+	Block* b = blocks;
+	while (b != nullptr) {
+		Block* next = b->next;
+		::operator delete(b);
+		b = next;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+/*
+Monotonic arena, for trees of small nodes that are built once and thrown away together (e.g. a parsed input).
+Allocating bumps a pointer through large blocks, each twice the size of the last, and nothing is freed
+individually: the blocks all go at once on release() or destruction.
+
+It's a std::pmr::memory_resource, so containers inside the nodes (std::pmr::vector, std::pmr::set, ...)
+can take their memory from the same arena. Objects from make() never have their destructors run,
+so they mustn't own anything outside the arena.
+*/
+class Arena : public std::pmr::memory_resource {
+private:
+	struct Block {
+		Block* next; // previously allocated (smaller) block
+		std::size_t size; // including this header
+	};
+
+	// Header rounded up, so allocations after it start suitably aligned
+	static constexpr std::size_t HEADER_SIZE = (sizeof(Block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	Block* blocks = nullptr; // most recent first
+	char* cursor = nullptr;
+	char* end = nullptr;
+	std::size_t nextSize;
+	std::size_t used = 0;
+
+	void grow(std::size_t minBytes);
+
+	void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+	// only ever freed in bulk
+	void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	static const std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	// Nothing is allocated until first used, so a rough guess of the total size up front makes it one block
+	explicit Arena(std::size_t firstBlockSize = DEFAULT_BLOCK_SIZE) : nextSize(firstBlockSize) {}
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	template <typename T, typename... Args>
+	T* make(Args&&... args) {
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	// Copy of the characters, living as long as the arena (e.g. names that only pointed into the input text)
+	std::string_view copy(std::string_view s);
+
+	// Frees everything allocated so far, but keeps the largest block to reuse
+	void release();
+
+	// Bytes handed out since construction/release, not counting alignment padding
+	std::size_t bytesUsed() const {
+		return used;
+	}
+};
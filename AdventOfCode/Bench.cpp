@@ -0,0 +1,354 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cmath>
+
+#include "Registry.h"
+#include "CommandLine.h"
+#include "Input.h"
+#include "Memory.h"
+#include "PerfCounters.h"
+#include "Checkpoint.h"
+#include "Generators.h"
+#include "Output.h"
+
+using namespace std;
+
+/*
+Benchmark for every day/part: a few untimed warm-up runs, then repeated timed runs,
+reported as JSON so results can be compared between builds.
+Parsing is measured separately, reported as part 0. Parts 1 and 2 then only time solving,
+every run reusing the one parsed input.
+Heap allocations and peak RSS are reported from the last timed run.
+Hardware counters (cycles, instructions, cache and branch misses) are averaged over the timed runs,
+and are null wherever perf_event_open isn't available. They include the pool threads days run work on.
+With --scale, each day is instead benchmarked on generated inputs of each size, to see how the solvers scale.
+On the days' own inputs every run's answer is checked against the expected one, exiting with EXIT_WRONG_ANSWER
+if any are wrong.
+*/
+
+struct BenchOptions {
+	vector<int> days; // empty = all
+	vector<int> parts{ 1, 2 };
+	string inputDir = defaultInputDir();
+	int warmup = 1;
+	int iterations = 10;
+	double timeLimit = 10; // seconds per part, stop early once exceeded (always at least 1 timed run)
+	string outputPath; // empty = stdout
+	vector<double> scales; // empty = the real inputs, otherwise generated inputs of these sizes
+	uint64_t seed = 1;
+	string checkpointDir; // empty = always simulate from the start
+	bool help = false;
+};
+
+struct BenchResult {
+	int day;
+	int part; // 0 = parse
+	string inputPath; // or a description of the generated input
+	double scale; // 0 = real input
+	uintmax_t inputBytes;
+	vector<double> samples; // ms, sorted
+	memory::Usage memory; // last timed run
+	perf::Counts counters; // mean per timed run
+	int verified; // 1 = every run gave the expected answer, 0 = one didn't, -1 = nothing to check against
+};
+
+struct Samples {
+	vector<double> times; // ms, sorted
+	memory::Usage memory; // last timed run
+	perf::Counts counters; // mean per timed run
+};
+
+void printUsage(const char* program) {
+	cout << "Usage: " << program << " [options]\n"
+		<< "  -d, --day LIST         days to benchmark, e.g. 16 or 1,3,5-7 (default: all)\n"
+		<< "  -p, --part N           only benchmark part 1 or 2 (default: both)\n"
+		<< "      --dir DIR          directory containing DayN.txt inputs (default: " << defaultInputDir() << ")\n"
+		<< "  -w, --warmup N         untimed runs before measuring (default: 1)\n"
+		<< "  -n, --iterations N     timed runs per part, and of parsing (default: 10)\n"
+		<< "  -t, --time-limit SECS  stop timing a part early after this long (default: 10)\n"
+		<< "  -o, --output PATH      write JSON results to PATH instead of stdout\n"
+		<< "  -s, --scale LIST       benchmark generated inputs of these sizes relative to the real ones, e.g. 1,10,100\n"
+		<< "      --seed N           random seed for generated inputs (default: 1)\n"
+		<< "      --checkpoint DIR   start long simulations from snapshots left in DIR by aoc --checkpoint\n"
+		<< "  -h, --help             show this message" << endl;
+}
+
+// e.g. "0.5,1,10"
+vector<double> parseScaleList(const string& list) {
+	vector<double> scales;
+	size_t start = 0;
+	while (start <= list.size()) {
+		size_t end = min(list.find(',', start), list.size());
+		size_t used = 0;
+		const string item = list.substr(start, end - start);
+		double scale = item.empty() ? 0 : stod(item, &used);
+		if (used != item.size() || !(scale > 0)) throw invalid_argument("Invalid scale '" + item + "'");
+		scales.push_back(scale);
+		start = end + 1;
+	}
+	return scales;
+}
+
+BenchOptions parseArgs(int argc, char* argv[]) {
+	BenchOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		const string arg = argv[i];
+		auto value = [&]() -> string {
+			if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		if (arg == "-h" || arg == "--help") options.help = true;
+		else if (arg == "-d" || arg == "--day") options.days = parseDayList(value());
+		else if (arg == "-p" || arg == "--part") options.parts = { parsePart(value()) };
+		else if (arg == "--dir") options.inputDir = value();
+		else if (arg == "-w" || arg == "--warmup") options.warmup = parseInt(value());
+		else if (arg == "-n" || arg == "--iterations") options.iterations = parseInt(value());
+		else if (arg == "-t" || arg == "--time-limit") options.timeLimit = stod(value());
+		else if (arg == "-o" || arg == "--output") options.outputPath = value();
+		else if (arg == "-s" || arg == "--scale") options.scales = parseScaleList(value());
+		else if (arg == "--seed") options.seed = stoull(value());
+		else if (arg == "--checkpoint") options.checkpointDir = value();
+		else throw invalid_argument("Unknown option " + arg);
+	}
+
+	if (options.warmup < 0) throw invalid_argument("Warm-up count can't be negative");
+	if (options.iterations < 1) throw invalid_argument("Need at least 1 iteration");
+
+	if (options.days.empty()) {
+		for (const Day& day : allDays()) options.days.push_back(day.number);
+	}
+
+	return options;
+}
+
+// Nearest-rank percentile of already sorted samples
+double percentile(const vector<double>& sorted, double p) {
+	size_t rank = static_cast<size_t>(ceil(p / 100 * sorted.size()));
+	return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+double median(const vector<double>& sorted) {
+	size_t n = sorted.size();
+	return n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+// Warm-up then timed runs of one thing, returning sorted times in ms
+Samples sample(const function<void()>& run, const BenchOptions& options, perf::Counters& counters) {
+	// solvers may print as they go, which would otherwise swamp the results
+	ostringstream discarded;
+	streambuf* original = cout.rdbuf(discarded.rdbuf());
+
+	Samples samples;
+	try {
+		for (int i = 0; i < options.warmup; i++) {
+			run();
+			discarded.str("");
+		}
+
+		double elapsed = 0;
+		for (int i = 0; i < options.iterations && elapsed < options.timeLimit * 1000; i++) {
+			memory::Measure measure;
+			counters.start();
+			auto start = chrono::steady_clock::now();
+			run();
+			auto end = chrono::steady_clock::now();
+			perf::Counts counts = counters.stop();
+			samples.memory = measure.result();
+			if (i == 0) samples.counters = counts;
+			else samples.counters += counts;
+			discarded.str("");
+
+			double ms = chrono::duration<double, milli>(end - start).count();
+			samples.times.push_back(ms);
+			elapsed += ms;
+		}
+	}
+	catch (...) {
+		cout.rdbuf(original);
+		throw;
+	}
+	cout.rdbuf(original);
+
+	sort(samples.times.begin(), samples.times.end());
+	samples.counters = samples.counters / samples.times.size();
+	return samples;
+}
+
+// Parse timings, then each requested part solved from the last parse.
+// Every run's answer is checked when the input is the day's own (see Day::isDefaultInput).
+vector<BenchResult> benchmark(const Day& day, string_view text, const string& inputName, double scale, const BenchOptions& options, perf::Counters& counters) {
+	uintmax_t inputBytes = text.size();
+	bool checked = scale == 0 && day.isDefaultInput(inputName);
+
+	Day::Parsed parsed;
+	vector<BenchResult> results;
+	Samples parseSamples = sample([&]() { parsed = day.parse(text); }, options, counters);
+	results.push_back({ day.number, 0, inputName, scale, inputBytes, move(parseSamples.times), parseSamples.memory, parseSamples.counters, -1 });
+
+	for (int part : options.parts) {
+		const Day::Part& solve = day.part(part);
+		const string& expected = day.expected(part);
+		int verified = checked && !expected.empty() ? 1 : -1;
+		Samples partSamples = sample([&]() {
+			string answer = solve(parsed);
+			if (verified == 1 && answer != expected) verified = 0;
+		}, options, counters);
+		results.push_back({ day.number, part, inputName, scale, inputBytes, move(partSamples.times), partSamples.memory, partSamples.counters, verified });
+	}
+
+	return results;
+}
+
+string jsonString(const string& s) {
+	string escaped = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') escaped += '\\';
+		escaped += c;
+	}
+	return escaped + "\"";
+}
+
+void writeJson(ostream& out, const vector<BenchResult>& results, const BenchOptions& options) {
+	out << "{\n"
+		<< "  \"warmup\": " << options.warmup << ",\n"
+		<< "  \"seed\": " << options.seed << ",\n"
+		<< "  \"benchmarks\": [";
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		double med = median(r.samples);
+		double mean = 0;
+		for (double s : r.samples) mean += s;
+		mean /= r.samples.size();
+
+		out << (i == 0 ? "\n" : ",\n")
+			<< "    {\n"
+			<< "      \"day\": " << r.day << ",\n"
+			<< "      \"part\": " << r.part << ",\n"
+			<< "      \"input\": " << jsonString(r.inputPath) << ",\n"
+			<< "      \"scale\": ";
+		if (r.scale > 0) out << r.scale;
+		else out << "null";
+		out << ",\n"
+			<< "      \"input_bytes\": " << r.inputBytes << ",\n"
+			<< "      \"iterations\": " << r.samples.size() << ",\n"
+			<< "      \"min_ms\": " << r.samples.front() << ",\n"
+			<< "      \"median_ms\": " << med << ",\n"
+			<< "      \"p99_ms\": " << percentile(r.samples, 99) << ",\n"
+			<< "      \"max_ms\": " << r.samples.back() << ",\n"
+			<< "      \"mean_ms\": " << mean << ",\n"
+			<< "      \"runs_per_sec\": " << 1000 / med << ",\n"
+			<< "      \"mb_per_sec\": " << r.inputBytes / (med * 1000) << ",\n"
+			<< "      \"allocations\": " << r.memory.allocations << ",\n"
+			<< "      \"alloc_bytes\": " << r.memory.bytes << ",\n"
+			<< "      \"peak_rss_kb\": " << r.memory.peakRssKb << ",\n";
+		for (int e = 0; e < perf::EVENT_COUNT; e++) {
+			out << "      \"" << perf::eventNames[e] << "\": ";
+			if (r.counters.valid[e]) out << r.counters.values[e];
+			else out << "null";
+			out << ",\n";
+		}
+		double ipc = r.counters.ipc();
+		out << "      \"ipc\": ";
+		if (ipc >= 0) out << ipc;
+		else out << "null";
+		out << ",\n"
+			<< "      \"verified\": " << (r.verified < 0 ? "null" : r.verified ? "true" : "false") << "\n"
+			<< "    }";
+	}
+
+	out << "\n  ]\n}" << endl;
+}
+
+int main(int argc, char* argv[]) {
+	BenchOptions options;
+	try {
+		options = parseArgs(argc, argv);
+	}
+	catch (const exception& e) {
+		cerr << e.what() << endl;
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (options.help) {
+		printUsage(argv[0]);
+		return 0;
+	}
+
+	// what days print along the way is discarded anyway, so don't time producing it
+	diagnostics::verbosity = Verbosity::QUIET;
+
+	// only ever read, so every run starts from the same point
+	if (!options.checkpointDir.empty()) checkpoint::configure(options.checkpointDir, 0);
+
+	// before anything starts the thread pool, so its threads are counted as well
+	perf::Counters counters;
+	if (!counters.anyAvailable()) cerr << "Hardware counters unavailable (" << counters.unavailableReason() << "), timing only" << endl;
+	else if (!counters.unavailableReason().empty()) cerr << "Some hardware counters unavailable: " << counters.unavailableReason() << endl;
+
+	vector<BenchResult> results;
+	int wrong = 0;
+	auto record = [&](vector<BenchResult> dayResults) {
+		for (BenchResult& result : dayResults) {
+			// progress on stderr, so stdout is just the JSON
+			cerr << "Day " << result.day;
+			if (result.scale > 0) cerr << " x" << result.scale;
+			cerr << (result.part == 0 ? " parse" : " part " + to_string(result.part))
+				<< ": median " << median(result.samples) << " ms over " << result.samples.size() << " runs";
+			if (result.counters.ipc() >= 0) cerr << ", IPC " << result.counters.ipc();
+			if (result.verified == 0) {
+				cerr << ", WRONG ANSWER";
+				wrong++;
+			}
+			cerr << endl;
+			results.push_back(move(result));
+		}
+	};
+
+	try {
+		for (int number : options.days) {
+			const Day& day = getDay(number);
+			if (options.scales.empty()) {
+				const string inputPath = resolveInput(day, options.inputDir);
+				InputFile input(inputPath);
+				record(benchmark(day, input.text(), inputPath, 0, options, counters));
+			}
+			for (double scale : options.scales) {
+				const string text = generateInput(day.number, scale, options.seed);
+				ostringstream name;
+				name << "generated day " << day.number << " scale " << scale << " seed " << options.seed;
+				record(benchmark(day, text, name.str(), scale, options, counters));
+			}
+		}
+	}
+	catch (const exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+
+	if (options.outputPath.empty()) {
+		writeJson(cout, results, options);
+	}
+	else {
+		ofstream output{ options.outputPath };
+		if (!output) {
+			cerr << "Failed to open " << options.outputPath << endl;
+			return 1;
+		}
+		writeJson(output, results, options);
+	}
+
+	// timings of wrong answers are meaningless, but still written out to see what happened
+	return wrong > 0 ? EXIT_WRONG_ANSWER : 0;
+}
@@ -0,0 +1,60 @@
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "Checkpoint.h"
+
+using namespace std;
+
+namespace checkpoint {
+	namespace {
+		string directory; // empty = disabled
+		int steps = 0;
+	}
+
+	void configure(const string& dir, int interval) {
+		if (interval < 0) throw invalid_argument("Checkpoint interval can't be negative");
+		directory = dir;
+		steps = interval;
+		if (!dir.empty() && interval > 0) filesystem::create_directories(dir);
+	}
+
+	Simulation::Simulation(int day, int part, int version, const cache::Writer& start)
+		: key(cache::keyFor(day, version, start.data())) {
+		if (directory.empty()) return;
+		ostringstream name;
+		name << "Day" << day << "-part" << part << "-" << hex << setw(16) << setfill('0') << key.inputHash << ".snapshot";
+		path = (filesystem::path(directory) / name.str()).string();
+	}
+
+	int Simulation::interval() const {
+		return steps;
+	}
+
+	int64_t Simulation::resume(const function<void(cache::Reader& in)>& load) {
+		if (!enabled()) return 0;
+		optional<cache::Entry> entry = cache::findFile(path, key);
+		if (!entry) return 0;
+
+		cache::Reader in = entry->payload();
+		int64_t progress = in.get<int64_t>();
+		load(in);
+		// written whole then renamed into place, so anything else means it's not from this version of the code
+		if (!in.atEnd()) throw invalid_argument("Snapshot has extra data, remove it to start over: " + path);
+		lastSaved = progress;
+		return progress;
+	}
+
+	void Simulation::store(int64_t progress, const cache::Writer& snapshot) {
+		cache::storeFile(path, key, snapshot);
+		lastSaved = progress;
+	}
+
+	void Simulation::finish() {
+		if (!enabled() || interval() == 0) return;
+		error_code error;
+		filesystem::remove(path, error); // fine if there never was one
+		cache::removeTemporaries(path); // in case a run was killed mid-write
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <functional>
+
+#include "ParseCache.h"
+
+/*
+Snapshots of long-running simulations (day 23's rounds, day 17's rocks, ...), so an interrupted run can
+pick up where it left off. Off unless a directory is configured (aoc --checkpoint DIR):
+
+	checkpoint::Simulation snapshots(23, 2, SNAPSHOT_VERSION, start);
+	int round = snapshots.resume([&](cache::Reader& in) { ... read state ... });
+	while (...) {
+		round++;
+		...
+		snapshots.maybeSave(round, [&](cache::Writer& out) { ... write state ... });
+	}
+	snapshots.finish();
+
+Snapshots use the parse cache's file format (see ParseCache.h), keyed by a hash of the simulation's starting state,
+so one from a different input is never resumed. When disabled, resume and maybeSave do nothing.
+*/
+namespace checkpoint {
+	// Snapshots in dir every `interval` steps, where a step is whatever the simulation counts progress in.
+	// An interval of 0 only resumes from snapshots already there, without saving or removing any (e.g. for benchmarks).
+	// Not thread safe, call before solving anything.
+	void configure(const std::string& dir, int interval);
+
+	class Simulation {
+	private:
+		std::string path; // empty = disabled
+		cache::Key key;
+		int64_t lastSaved = 0;
+
+	public:
+		// start: the simulation's starting state (or whatever determines it), just to tell inputs apart.
+		// The version must be bumped whenever what's saved changes.
+		Simulation(int day, int part, int version, const cache::Writer& start);
+
+		bool enabled() const {
+			return !path.empty();
+		}
+
+		// Steps between snapshots, 0 if never saving them
+		int interval() const;
+
+		// Calls load with the latest snapshot, returning the progress it was saved at,
+		// or 0 without calling load if there isn't one
+		int64_t resume(const std::function<void(cache::Reader& in)>& load);
+
+		// Calls save to write a snapshot, if progress is at least an interval on from the last one
+		template <typename Save>
+		void maybeSave(int64_t progress, Save&& save) {
+			if (!enabled() || interval() == 0 || progress < lastSaved + interval()) return;
+			cache::Writer out;
+			out.put(progress);
+			save(out);
+			store(progress, out);
+		}
+
+		// Simulation complete, so removes its snapshot, and a rerun starts from the beginning
+		void finish();
+
+	private:
+		void store(int64_t progress, const cache::Writer& snapshot);
+	};
+}
@@ -0,0 +1,97 @@
+#include <stdexcept>
+#include <filesystem>
+#include <string_view>
+#include <algorithm>
+
+#include "CommandLine.h"
+
+using namespace std;
+
+int parseInt(const string& s) {
+	size_t end;
+	int value = stoi(s, &end);
+	if (end != s.length()) throw invalid_argument("Expected a number, got '" + s + "'");
+	return value;
+}
+
+vector<int> parseDayList(const string& list) {
+	vector<int> days;
+	size_t start = 0;
+	while (start <= list.length()) {
+		size_t comma = list.find(',', start);
+		if (comma == string::npos) comma = list.length();
+		string item = list.substr(start, comma - start);
+
+		size_t dash = item.find('-');
+		if (dash == string::npos) {
+			days.push_back(parseInt(item));
+		}
+		else {
+			int from = parseInt(item.substr(0, dash));
+			int to = parseInt(item.substr(dash + 1));
+			if (from > to) throw invalid_argument("Empty day range " + item);
+			for (int day = from; day <= to; day++) days.push_back(day);
+		}
+
+		start = comma + 1;
+	}
+	return days;
+}
+
+int parsePart(const string& s) {
+	int part = parseInt(s);
+	if (part != 1 && part != 2) throw invalid_argument("Part must be 1 or 2");
+	return part;
+}
+
+namespace {
+	// * is any run of characters, ? any one
+	bool matches(string_view pattern, string_view name) {
+		size_t p = 0, n = 0;
+		size_t starP = string::npos, starN = 0; // last * seen, and where in name it's matched up to
+		while (n < name.size()) {
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+				p++;
+				n++;
+			}
+			else if (p < pattern.size() && pattern[p] == '*') {
+				starP = p++;
+				starN = n;
+			}
+			else if (starP != string::npos) {
+				// let the last * take one more character
+				p = starP + 1;
+				n = ++starN;
+			}
+			else return false;
+		}
+		while (p < pattern.size() && pattern[p] == '*') p++;
+		return p == pattern.size();
+	}
+}
+
+vector<string> expandInputs(const string& path) {
+	namespace fs = filesystem;
+	vector<string> files;
+
+	fs::path asPath(path);
+	string pattern = asPath.filename().string();
+	if (fs::is_directory(asPath)) {
+		for (const auto& entry : fs::directory_iterator(asPath)) {
+			if (entry.is_regular_file()) files.push_back(entry.path().string());
+		}
+	}
+	else if (pattern.find_first_of("*?") != string::npos) {
+		fs::path dir = asPath.has_parent_path() ? asPath.parent_path() : fs::path(".");
+		if (fs::is_directory(dir)) {
+			for (const auto& entry : fs::directory_iterator(dir)) {
+				if (entry.is_regular_file() && matches(pattern, entry.path().filename().string())) files.push_back(entry.path().string());
+			}
+		}
+	}
+	else if (fs::is_regular_file(asPath)) files.push_back(path);
+
+	if (files.empty()) throw invalid_argument("No input files found for " + path);
+	sort(files.begin(), files.end());
+	return files;
+}
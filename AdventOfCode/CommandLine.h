@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Shared argument parsing for the runner and benchmark executables
+
+// Whole string must be a number, throws invalid_argument otherwise
+int parseInt(const std::string& s);
+
+// e.g. "1,3,5-7" -> { 1, 3, 5, 6, 7 }
+std::vector<int> parseDayList(const std::string& list);
+
+// 1 or 2, throws invalid_argument otherwise
+int parsePart(const std::string& s);
+
+// Files a path refers to, in name order: a directory gives every file in it, a pattern with * or ?
+// in its last part (e.g. "inputs/day23-*.txt") the files matching it, anything else just itself.
+// Throws invalid_argument if nothing matches.
+std::vector<std::string> expandInputs(const std::string& path);
@@ -1,76 +1,85 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
+#include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm> // sort
+#include <array>
+#include <utility>
+#include <memory>
 
-using namespace std;
-
+#include "Input.h"
+#include "StreamInput.h"
 
-int elfTotal = 0;
-int maxElfTotal = 0;
+using namespace std;
 
-void elfFinished() {
-    if (elfTotal > maxElfTotal) maxElfTotal = elfTotal;
-    elfTotal = 0;
-}
 
 namespace day1 {
 
-    void part1()
+    // calories carried by each elf, in input order
+    struct Input {
+        vector<int> elves;
+    };
+
+    shared_ptr<const Input> parse(string_view text)
     {
-        ifstream input("Day1.txt");
-
-        string line;
-        // getline returns the passed input stream,
-        // io evaulates to true as long as neither failbit or badbit set, get updated by reading (e.g. EOF)
-        while (getline(input, line)) {
-            if (line.length() == 0) elfFinished();
-            else elfTotal += stoi(line); // stoi = string-to-int
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
+
+        int elfTotal = 0;
+        string_view line;
+        // next returns false once all lines have been handed out, each line is a view into the text
+        while (inputLines.next(line)) {
+            if (line.length() == 0) {
+                input->elves.push_back(elfTotal);
+                elfTotal = 0;
+            }
+            else elfTotal += parseNumber<int>(line);
         }
-        elfFinished();
+        input->elves.push_back(elfTotal);
 
-        cout << maxElfTotal << endl; // 71471
+        return input;
     }
 
-
-
-
-    vector<int> elves;
-
-    void elfFinished2() {
-        elves.push_back(elfTotal);
-        elfTotal = 0;
+    string solve1(const Input& input)
+    {
+        return to_string(*max_element(input.elves.begin(), input.elves.end())); // 71471
     }
 
-    void part2()
+    string solve2(const Input& input)
     {
-        ifstream input("Day1.txt");
-
-        string line;
-        while (getline(input, line)) {
-            if (line.length() == 0) elfFinished2();
-            else elfTotal += stoi(line);
-        }
-        elfFinished2();
+        vector<int> elves = input.elves;
 
         // now sort to get top 3
         // sort takes 2 "Random access iterators" for range to sort, plus comparator to get descending order
         // (alternative solution is to provide 'reverse' iterators rbegin and rend
         sort(elves.begin(), elves.end(), greater<>());
 
-        // C++ does implicit conversion, will happily work out how to combine ints/strings
-        cout << elves[0] << " " << elves[1] << " " << elves[2] << endl; // 71471 70523 69195
-        cout << elves[0] + elves[1] + elves[2] << endl; // 211189
+        // top 3 are 71471 70523 69195
+        return to_string(elves[0] + elves[1] + elves[2]); // 211189
     }
 
-    int main() {
-        part2();
+    // Only the top 3 so far need remembering, largest first
+    void keepTop3(array<int, 3>& top, int elfTotal) {
+        for (int& t : top) {
+            if (elfTotal > t) swap(elfTotal, t); // bumps the smaller ones down
+        }
+    }
 
-        // wait to close
-        cin.get();
+    pair<string, string> solveStream(StreamInput& in)
+    {
+        array<int, 3> top{};
+
+        int elfTotal = 0;
+        string_view line;
+        while (in.nextLine(line)) {
+            if (line.length() == 0) {
+                keepTop3(top, elfTotal);
+                elfTotal = 0;
+            }
+            else elfTotal += parseNumber<int>(line);
+        }
+        keepTop3(top, elfTotal);
 
-        return 0;
+        return { to_string(top[0]), to_string(top[0] + top[1] + top[2]) };
     }
 }
 
@@ -1,6 +1,19 @@
 #pragma once
 
+#include <string>
+#include <string_view>
+#include <memory>
+#include <utility>
+
+class StreamInput;
+
 namespace day1 {
-	int main();
-}
+	struct Input;
 
+	std::shared_ptr<const Input> parse(std::string_view text);
+	std::string solve1(const Input& input);
+	std::string solve2(const Input& input);
+
+	// Both answers in a single pass over the input, without keeping all of it
+	std::pair<std::string, std::string> solveStream(StreamInput& in);
+}
@@ -1,9 +1,13 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <set>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
+#include <stdexcept>
 #include <cassert>
+#include <utility>
+
+#include "Input.h"
+#include "StreamInput.h"
 
 using namespace std;
 
@@ -31,52 +35,78 @@ public:
 };
 
 namespace day10 {
-    template<typename Callback>
-    void runMachine(const Callback& callback) {
-        ifstream input("Day10.txt");
+    // noop, or addx with its argument
+    struct Instruction {
+        bool addx;
+        int arg;
+    };
 
-        Machine machine(callback);
+    struct Input {
+        vector<Instruction> program;
+    };
 
-        string op;
-        int arg;
+    // False once there are no words left
+    bool readInstruction(Tokens& words, Instruction& instruction) {
+        string_view op;
+        string_view arg;
 
-        while (input >> op) {
-            if (op == "noop") {
-                machine.noop();
-            }
-            else if (op == "addx") {
-                input >> arg;
-                machine.addx(arg);
-            }
-            else {
-                string errorMsg = "Unknown operation " + op;
-                throw invalid_argument(errorMsg);
-            }
+        if (!words.next(op)) return false;
+        if (op == "noop") {
+            instruction = { false, 0 };
+        }
+        else if (op == "addx") {
+            words.next(arg);
+            instruction = { true, parseNumber<int>(arg) };
         }
+        else {
+            string errorMsg = "Unknown operation " + string(op);
+            throw invalid_argument(errorMsg);
+        }
+        return true;
+    }
+
+    shared_ptr<const Input> parse(string_view text) {
+        Tokens words(text);
+        auto input = make_shared<Input>();
+
+        Instruction instruction;
+        while (readInstruction(words, instruction)) {
+            input->program.push_back(instruction);
+        }
+
+        return input;
     }
 
-    void part1() {
-        int strength = 0;
+    // Part 1, signal strength summed over the interesting cycles
+    class SignalStrength {
+    private:
+        int total = 0;
 
-        runMachine([&strength](const int cycle, const int regX) {
+    public:
+        void update(const int cycle, const int regX) {
             if (cycle == 20 || cycle == 60 || cycle == 100 || cycle == 140 || cycle == 180 || cycle == 220) {
-                strength += cycle * regX;
+                total += cycle * regX;
             }
-        });
+        }
 
-        cout << strength << endl; // 13520
-    }
+        int get() const {
+            return total;
+        }
+    };
 
-    void part2() {
-        char display[6][40];
+    // Part 2, pixels drawn by the CRT. The size is fixed by the puzzle, so only ever a compile time constant.
+    template <int WIDTH = 40, int HEIGHT = 6>
+    class Display {
+    private:
+        char display[HEIGHT][WIDTH];
 
-        runMachine([&display](const int cycle, const int regX)
-        {
+    public:
+        void update(const int cycle, const int regX) {
             int cycleZeroIndex = cycle - 1;
-            int x = cycleZeroIndex % 40;
-            int y = cycleZeroIndex / 40;
+            int x = cycleZeroIndex % WIDTH;
+            int y = cycleZeroIndex / WIDTH;
 
-            if (y >= 6) return; // unnecessary code after display fully drawn (possibly due to proactively sending next value)
+            if (y >= HEIGHT) return; // unnecessary code after display fully drawn (possibly due to proactively sending next value)
 
             if (x >= regX - 1 && x <= regX + 1) {
                 display[y][x] = '#';
@@ -84,18 +114,65 @@ namespace day10 {
             else {
                 display[y][x] = '.';
             }
-        });
+        }
+
+        // answer is the letters drawn on the display
+        string rows() const {
+            string rows;
+            for (int i = 0; i < HEIGHT; i++) {
+                if (i > 0) rows += '\n';
+                rows.append(display[i], WIDTH);
+            }
+            return rows;
+        }
+    };
 
-        for (int i = 0; i < 6; i++) {
-            cout << string(display[i], 40) << endl;
+    template<typename Callback>
+    void runMachine(const Input& input, const Callback& callback) {
+        Machine machine(callback);
+
+        for (const auto& [addx, arg] : input.program) {
+            if (addx) machine.addx(arg);
+            else machine.noop();
         }
     }
 
+    string solve1(const Input& input) {
+        SignalStrength strength;
 
-    int main() {
-        part2();
+        runMachine(input, [&strength](const int cycle, const int regX) { strength.update(cycle, regX); });
+
+        return to_string(strength.get()); // 13520
+    }
+
+    string solve2(const Input& input) {
+        Display<> display;
+
+        runMachine(input, [&display](const int cycle, const int regX) { display.update(cycle, regX); });
+
+        return display.rows();
+    }
+
+    // Both parts watch the same run of the machine
+    pair<string, string> solveStream(StreamInput& in) {
+        SignalStrength strength;
+        Display<> display;
+        Machine machine([&](const int cycle, const int regX) {
+            strength.update(cycle, regX);
+            display.update(cycle, regX);
+        });
+
+        string_view line;
+        Instruction instruction;
+        while (in.nextLine(line)) {
+            Tokens words(line);
+            if (!readInstruction(words, instruction)) continue; // blank line
+
+            if (instruction.addx) machine.addx(instruction.arg);
+            else machine.noop();
+        }
 
-        return 0;
+        return { to_string(strength.get()), display.rows() };
     }
 
 }
\ No newline at end of file
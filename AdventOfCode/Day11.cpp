@@ -1,16 +1,51 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <sstream> // string -> stream
+#include <string>
+#include <string_view>
 #include <queue>
 #include <vector>
 #include <cassert>
 #include <numeric>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <functional>
+#include <span>
+
+#include "Input.h"
+#include "Scanner.h"
+#include "Parallel.h"
+#include "Checkpoint.h"
 
 using namespace std;
 
 enum Op { ADD, MULT, SQUARE };
 
+uint64_t applyOp(Op op, int value, uint64_t val) {
+    if (op == ADD) {
+        return (val + value);
+    }
+    else if (op == MULT) {
+        return (val * value);
+    }
+    else if (op == SQUARE) {
+        return (val * val);
+    }
+    else {
+        string errorMsg = "Unknown operation " + to_string(op);
+        throw invalid_argument(errorMsg);
+    }
+}
+
+// What's parsed for each monkey, before any items are thrown
+struct MonkeyNotes {
+    Op op;
+    int value;
+    int divTest;
+    int caseTrueMonkey;
+    int caseFalseMonkey;
+    vector<int> items;
+};
+
 class Monkey {
     const Op op;
     const int value;
@@ -33,19 +68,7 @@ private:
     }
 
     uint64_t newVal(uint64_t val) {
-        if (op == ADD) {
-            return (val + value);
-        }
-        else if (op == MULT) {
-            return (val * value);
-        }
-        else if (op == SQUARE) {
-            return (val * val);
-        }
-        else {
-            string errorMsg = "Unknown operation " + op;
-            throw invalid_argument(errorMsg);
-        }
+        return applyOp(op, value, val);
     }
 
     void forward(uint64_t val) {
@@ -59,16 +82,11 @@ private:
 
 public:
     Monkey(
-        const Op op,
-        const int value,
-        const int divTest,
-        const int caseTrueMonkey,
-        const int caseFalseMonkey,
-        queue<int>& items,
+        const MonkeyNotes& notes,
         vector<Monkey>& monkeys,
         uint64_t& lcm
-    ) : op(op), value(value), divTest(divTest), caseTrueMonkey(caseTrueMonkey), caseFalseMonkey(caseFalseMonkey), items(items),
-        monkeys(monkeys), lcm(lcm) {}
+    ) : op(notes.op), value(notes.value), divTest(notes.divTest), caseTrueMonkey(notes.caseTrueMonkey), caseFalseMonkey(notes.caseFalseMonkey),
+        items(deque<int>(notes.items.begin(), notes.items.end())), monkeys(monkeys), lcm(lcm) {}
 
 
     void inspect(bool divide) {
@@ -88,54 +106,52 @@ public:
     }
 };
 
-istringstream getUnindentedLine(ifstream& input) {
-    string line;
-    getline(input, line);
-    istringstream lineStream = istringstream(line);
-    lineStream >> ws;
-    return lineStream;
+Scanner getUnindentedLine(Splitter& input) {
+    string_view line;
+    input.next(line);
+    Scanner lineScanner(line);
+    lineScanner.skipSpaces();
+    return lineScanner;
 }
 
-// LCM needs passing in, since it goes into the Monkey objects as a reference,
-// and a reference to a variable in this method will be invalid once this returns.
-vector<Monkey> readMonkeys(uint64_t &lcm) {
-    ifstream input("Day11.txt");
+vector<MonkeyNotes> readMonkeys(string_view text, uint64_t &lcm) {
+    Splitter input(text);
 
-    vector<Monkey> monkeys;
+    vector<MonkeyNotes> monkeys;
 
-    string line;
-    string placeholderWord;
-    int monkeyIdx;
+    string_view line;
 
     lcm = 1;
 
-    while (getline(input, line)) {
+    while (input.next(line)) {
 
         // First line, index of monkey (not strictly necessary)
-        istringstream lineStream(line);
-        lineStream.ignore(strlen("Monkey ")) >> monkeyIdx;
+        Scanner lineScanner(line);
+        lineScanner.expect("Monkey ");
+        lineScanner.number<int>();
 
         // Second line: '   Starting items: 62, 92, 50, 63, 62, 93, 73, 50'
-        lineStream = getUnindentedLine(input);
-        lineStream.ignore(strlen("Starting items: "));
+        lineScanner = getUnindentedLine(input);
+        lineScanner.expect("Starting items: ");
 
-        queue<int> items;
+        vector<int> items;
         int item;
-        char c;
-        while (lineStream >> item) {
-            items.push(item);
-            lineStream >> c; // skip ',' delimeter
+        while (lineScanner.tryNumber(item)) {
+            items.push_back(item);
+            lineScanner.consume(", "); // skip delimeter
         }
 
         // Third line: '   Operation: new = old * 7'
-        lineStream = getUnindentedLine(input);
-        lineStream.ignore(strlen("Operation: new = old "));
-        char opChar;
+        lineScanner = getUnindentedLine(input);
+        lineScanner.expect("Operation: new = old ");
+        char opChar = lineScanner.peek();
+        lineScanner.skip();
+        lineScanner.expect(" ");
         int val;
-        lineStream >> opChar;
         Op op;
-        if (!(lineStream >> val)) {
-            // failed to read an integer, line was instead 'old * old'
+        if (!lineScanner.tryNumber(val)) {
+            // not an integer, line was instead 'old * old'
+            lineScanner.expect("old");
             op = SQUARE;
             val = 0;
         }
@@ -145,52 +161,93 @@ vector<Monkey> readMonkeys(uint64_t &lcm) {
 
 
         // Fourth line: '  Test: divisible by 2'
-        lineStream = getUnindentedLine(input);
-        lineStream.ignore(strlen("Test: divisible by "));
-        int divTest;
-        lineStream >> divTest;
+        lineScanner = getUnindentedLine(input);
+        lineScanner.expect("Test: divisible by ");
+        int divTest = lineScanner.number<int>();
         lcm = std::lcm(lcm, divTest);
 
         // Fifth line: '    If true: throw to monkey 7'
-        lineStream = getUnindentedLine(input);
-        lineStream.ignore(strlen("If true: throw to monkey "));
-        int trueMonkey;
-        lineStream >> trueMonkey;
+        lineScanner = getUnindentedLine(input);
+        lineScanner.expect("If true: throw to monkey ");
+        int trueMonkey = lineScanner.number<int>();
 
         // Sixth line: '    If false: throw to monkey 1'
-        lineStream = getUnindentedLine(input);
-        lineStream.ignore(strlen("If false: throw to monkey "));
-        int falseMonkey;
-        lineStream >> falseMonkey;
+        lineScanner = getUnindentedLine(input);
+        lineScanner.expect("If false: throw to monkey ");
+        int falseMonkey = lineScanner.number<int>();
 
-        monkeys.emplace_back(Monkey(op, val, divTest, trueMonkey, falseMonkey, items, monkeys, lcm));
+        monkeys.push_back({ op, val, divTest, trueMonkey, falseMonkey, items });
 
-        getline(input, line); // trailing blank line
+        input.next(line); // trailing blank line
     }
 
     return monkeys;
 }
 
 namespace day11 {
+    struct Input {
+        vector<MonkeyNotes> monkeys;
+        uint64_t lcm; // of all the divisibility tests
+    };
+
+    shared_ptr<const Input> parse(string_view text) {
+        auto input = make_shared<Input>();
+        input->monkeys = readMonkeys(text, input->lcm);
+        return input;
+    }
+
+    // LCM needs passing in, since it goes into the Monkey objects as a reference,
+    // so must outlive them.
+    vector<Monkey> buildMonkeys(const Input& input, uint64_t& lcm) {
+        vector<Monkey> monkeys;
+        // Monkeys hold a reference to the vector (not to each other), so growing it is fine
+        for (const MonkeyNotes& notes : input.monkeys) {
+            monkeys.emplace_back(notes, monkeys, lcm);
+        }
+        return monkeys;
+    }
+
+    // Product of the two highest inspection counts
+    uint64_t getMonkeyBusiness(vector<uint64_t> inspected) {
+        std::partial_sort(inspected.begin(), inspected.begin() + 2, inspected.end(), greater<uint64_t>());
+        return inspected[0] * inspected[1];
+    }
+
     uint64_t getMonkeyBusiness(vector<Monkey>& monkeys) {
-        // Need to take a copy (of pointers), since ordering of monkeys matters for how they pass elements,
-        // and can only move around pointers due to const members of Monkey preventing assignment
-        vector<Monkey*> topMonkeys;
+        vector<uint64_t> inspected;
         for (Monkey& monkey : monkeys) {
-            topMonkeys.emplace_back(&monkey);
+            inspected.push_back(monkey.getInspected());
         }
+        return getMonkeyBusiness(inspected);
+    }
 
-        std::partial_sort(topMonkeys.begin(), topMonkeys.begin() + 2, topMonkeys.end(), [](Monkey* const x, Monkey* const y) {
-            return x->getInspected() > y->getInspected();
-        });
-
-        return topMonkeys[0]->getInspected() * topMonkeys[1]->getInspected();
+    /*
+    Items never affect each other once worry levels are kept modulo the LCM (part 2), so rather than
+    running every monkey round by round, each item can be followed through all of its rounds on its own,
+    counting which monkeys inspect it. Monkeys take turns in order, so an item thrown to a later monkey
+    gets inspected again in the same round, and to an earlier one in the next.
+    */
+    struct Item {
+        int monkey; // holding it at the start of the next round
+        uint64_t val;
+    };
+
+    void followItem(const vector<MonkeyNotes>& monkeys, uint64_t lcm, Item& item, int rounds, vector<uint64_t>& inspected) {
+        int round = 0;
+        while (round < rounds) {
+            const MonkeyNotes& notes = monkeys[item.monkey];
+            inspected[item.monkey]++;
+            item.val = applyOp(notes.op, notes.value, item.val) % lcm;
+            int target = item.val % notes.divTest == 0 ? notes.caseTrueMonkey : notes.caseFalseMonkey;
+            if (target <= item.monkey) round++;
+            item.monkey = target;
+        }
     }
 
-    void part1() {
+    string solve1(const Input& input) {
         // unused for pt. 1
-        uint64_t lcm = 1;
-        vector<Monkey> monkeys = readMonkeys(lcm);
+        uint64_t lcm = input.lcm;
+        vector<Monkey> monkeys = buildMonkeys(input, lcm);
 
         for (int i = 0; i < 20; i++) {
             for (Monkey& monkey : monkeys) {
@@ -198,26 +255,77 @@ namespace day11 {
             }
         }
 
-        cout << getMonkeyBusiness(monkeys) << endl; // 90882
+        return to_string(getMonkeyBusiness(monkeys)); // 90882
+    }
+
+    // Of what part 2 snapshots (see Checkpoint.h): how many times each monkey has inspected so far, and where every item is
+    const int SNAPSHOT_VERSION = 2;
+
+    cache::Writer startingState(const Input& input) {
+        cache::Writer start;
+        for (const MonkeyNotes& notes : input.monkeys) {
+            start.put(notes.op);
+            start.put(notes.value);
+            start.put(notes.divTest);
+            start.put(notes.caseTrueMonkey);
+            start.put(notes.caseFalseMonkey);
+            start.putVector(notes.items);
+        }
+        return start;
     }
 
-    void part2() {
-        uint64_t lcm = 1;
-        vector<Monkey> monkeys = readMonkeys(lcm);
+    string solve2(const Input& input) {
+        const int ROUNDS = 10000;
 
-        for (int i = 0; i < 10000; i++) {
-            for (Monkey& monkey : monkeys) {
-                monkey.inspect(false);
+        // every item, to split across threads
+        vector<Item> items;
+        for (size_t i = 0; i < input.monkeys.size(); i++) {
+            for (int item : input.monkeys[i].items) {
+                items.push_back({ static_cast<int>(i), static_cast<uint64_t>(item) });
             }
         }
 
-        cout << getMonkeyBusiness(monkeys) << endl; // 30893109657
-    }
-
-    int main() {
-        part2();
+        typedef vector<uint64_t> Counts;
+        Counts inspected(input.monkeys.size(), 0);
+
+        // Progress is in rounds, so with snapshots every item is followed a batch of rounds at a time,
+        // with a snapshot between batches
+        checkpoint::Simulation snapshots(11, 2, SNAPSHOT_VERSION, startingState(input));
+        int64_t round = snapshots.resume([&](cache::Reader& in) {
+            in.getSpan(span<uint64_t>(inspected));
+            in.getSpan(span<Item>(items));
+            for (const Item& item : items) {
+                if (item.monkey < 0 || item.monkey >= static_cast<int>(input.monkeys.size())) {
+                    throw invalid_argument("Snapshot doesn't match the monkeys");
+                }
+            }
+        });
+        int batch = snapshots.enabled() && snapshots.interval() > 0 ? snapshots.interval() : ROUNDS;
+
+        while (round < ROUNDS) {
+            int rounds = static_cast<int>(min<int64_t>(batch, ROUNDS - round));
+            // each chunk only moves its own items, so they can be updated in place
+            Counts counts = parallel::reduce<Counts, size_t>(0, items.size(), Counts(input.monkeys.size(), 0), [&](size_t from, size_t to) {
+                Counts counts(input.monkeys.size(), 0);
+                for (size_t i = from; i < to; i++) {
+                    followItem(input.monkeys, input.lcm, items[i], rounds, counts);
+                }
+                return counts;
+            }, [](Counts left, const Counts& right) {
+                for (size_t i = 0; i < left.size(); i++) left[i] += right[i];
+                return left;
+            });
+            for (size_t i = 0; i < inspected.size(); i++) inspected[i] += counts[i];
+            round += rounds;
+
+            snapshots.maybeSave(round, [&](cache::Writer& out) {
+                out.putVector(inspected);
+                out.putVector(items);
+            });
+        }
+        snapshots.finish();
 
-        return 0;
+        return to_string(getMonkeyBusiness(inspected)); // 30893109657
     }
 
 }
\ No newline at end of file
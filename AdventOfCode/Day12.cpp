@@ -1,15 +1,17 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <sstream> // string -> stream
+#include <string>
+#include <string_view>
 #include <stdexcept>
 #include <vector>
 #include <set>
 #include <map>
+#include <memory>
+#include <limits>
 
 #include <functional>
 
 #include "Point.h"
+#include "Input.h"
+#include "Grid2D.h"
 
 using namespace std;
 
@@ -19,23 +21,58 @@ int getHeight(char c) {
         : c - 'a';
 }
 
+namespace day12 {
+    struct Input {
+        Point<int> start;
+        Point<int> end;
+        Grid2D<int> grid; // heights, surrounded by EDGE
+    };
+
+    // Off the edge of the map, never a step either way from a real height
+    const int EDGE = -100;
+
+    shared_ptr<const Input> parse(string_view text) {
+        Splitter inputLines(text);
+        vector<string_view> lines;
+        string_view line;
+        while (inputLines.next(line)) {
+            lines.push_back(line);
+        }
+
+        auto input = make_shared<Input>();
+        int height = static_cast<int>(lines.size());
+        int width = height == 0 ? 0 : static_cast<int>(lines[0].size());
+        input->grid = Grid2D<int>(width, height, 0, 1, EDGE);
+
+        for (int y = 0; y < height; y++) {
+            if (static_cast<int>(lines[y].size()) != width) throw invalid_argument("Rows of the height map differ in length");
+            for (int x = 0; x < width; x++) {
+                char c = lines[y][x];
+                if (c == 'S') input->start = Point<int>(x, y);
+                else if (c == 'E') input->end = Point<int>(x, y);
+                input->grid(x, y) = getHeight(c);
+            }
+        }
+
+        return input;
+    }
+}
+
+// State of one search over the (shared, unchanging) height map
 class Grid {
 private:
-    Point<int> start;
-    Point<int> end;
+    const Point<int>& start;
+    const Point<int>& end;
 
-    size_t grid_width;
-    size_t grid_height;
-
-    vector<vector<int>> grid;
-    map<Point<int>, int> distances;
+    const Grid2D<int>& grid;
+    Grid2D<int> distances; // UNSEEN until first reached
 
     // std::priority_queue doesn't support remove/update, so can't 'improve' priority as shorter paths found.
     // instead just remove/reinsert into set whenever distance changes (remove first, update distance, reinsert).
     // (since set still supports ordering)
     const std::function<bool(const Point<int>&, const Point<int>&)> priorityQueueComparator = [this](const Point<int>& p1, const Point<int>& p2) {
         // Needs to compare by distance first, but then by points if not equal!
-        auto res = distances.at(p1) <=> distances.at(p2);
+        auto res = distances[p1] <=> distances[p2];
         if (res == 0) return p1 < p2; // fall back to comparing points
         else return res < 0; // equivalent to less
     };
@@ -44,20 +81,23 @@ private:
 
     Fringe fringe{ priorityQueueComparator };
 
+    static const int UNSEEN = numeric_limits<int>::max();
+
     int get(const Point<int>& p) {
-        return grid[p.y][p.x];
+        return grid[p];
     }
 
     void explore(Point<int> p, int currentHeight, int currentDistance, bool forwards) {
         int newHeight = get(p);
+        if (newHeight == day12::EDGE) return;
         if (forwards && newHeight > currentHeight + 1
             || !forwards && newHeight < currentHeight - 1) return;
 
-        auto oldDist = distances.find(p);
-        if (oldDist != distances.end() && oldDist->second <= currentDistance + 1) return;
+        int oldDist = distances[p];
+        if (oldDist <= currentDistance + 1) return;
 
         // never seen before (can't do fringe.contains(), since it does a lookup of distances in comparator)
-        if (!distances.contains(p)) {
+        if (oldDist == UNSEEN) {
             distances[p] = currentDistance + 1;
             fringe.insert(p);
             return;
@@ -70,32 +110,8 @@ private:
     }
 
 public:
-    Grid(istream&& input) {
-    
-        vector<int> row;
-        char c;
-        while (input.get(c)) {
-            if (c == '\n') {
-                grid.push_back(row);
-                row.clear();
-            }
-            else {
-                if (c == 'S') {
-                    start = Point<int>(static_cast<int>(row.size()), static_cast<int>(grid.size()));
-                    distances[start] = 0;
-                }
-                else if (c == 'E') {
-                    end = Point<int>(static_cast<int>(row.size()), static_cast<int>(grid.size()));
-                }
-
-                row.push_back(getHeight(c));
-            }
-        }
-        if (row.size() > 0) grid.push_back(row);
-
-        grid_height = grid.size();
-        grid_width = grid[0].size();
-    }
+    Grid(const day12::Input& input) : start(input.start), end(input.end), grid(input.grid),
+        distances(input.grid.width(), input.grid.height(), UNSEEN) {}
 
     bool isEnd(const Point<int>& p) {
         return p == end;
@@ -105,7 +121,8 @@ public:
 
     int dijkstra(bool forwards, PointPredicate finished) {
         Point<int> beginning = forwards ? start : end;
-        
+        distances[beginning] = 0;
+
         fringe.insert(beginning);
 
         while (!fringe.empty()) {
@@ -119,10 +136,11 @@ public:
                 return distance;
             }
 
-            if (p.x > 0) explore(Point{ p.x - 1, p.y }, height, distance, forwards);
-            if (p.x < grid_width - 1) explore(Point{ p.x + 1, p.y }, height, distance, forwards);
-            if (p.y > 0) explore(Point{ p.x, p.y - 1 }, height, distance, forwards);
-            if (p.y < grid_height - 1) explore(Point{ p.x, p.y + 1 }, height, distance, forwards);
+            // edges are padded, so no need for bounds checks
+            explore(Point{ p.x - 1, p.y }, height, distance, forwards);
+            explore(Point{ p.x + 1, p.y }, height, distance, forwards);
+            explore(Point{ p.x, p.y - 1 }, height, distance, forwards);
+            explore(Point{ p.x, p.y + 1 }, height, distance, forwards);
         }
 
         throw invalid_argument("Exhausted queue without finding end point");
@@ -130,26 +148,20 @@ public:
 };
 
 namespace day12 {
-    void part1() {
-        Grid grid(ifstream("Day12.txt"));
+    string solve1(const Input& input) {
+        Grid grid(input);
 
         int dist = grid.dijkstra(true, [&grid](const Point<int>& p, const int& height) { return grid.isEnd(p); });
 
-        cout << dist << endl; // 447
+        return to_string(dist); // 447
     }
 
-    void part2() {
-        Grid grid(ifstream("Day12.txt"));
+    string solve2(const Input& input) {
+        Grid grid(input);
 
         int dist = grid.dijkstra(false, [&grid](const Point<int>& p, const int& height) { return height == 0; });
 
-        cout << dist << endl; // 446
-    }
-
-    int main() {
-        part2();
-
-        return 0;
+        return to_string(dist); // 446
     }
 
 }
\ No newline at end of file
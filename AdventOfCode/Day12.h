@@ -1,4 +1,13 @@
 #pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+
 namespace day12 {
-	int main();
+	struct Input;
+
+	std::shared_ptr<const Input> parse(std::string_view text);
+	std::string solve1(const Input& input);
+	std::string solve2(const Input& input);
 }
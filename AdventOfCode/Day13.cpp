@@ -1,14 +1,19 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <sstream> // string -> stream
+#include <string>
+#include <string_view>
+#include <charconv>
 #include <stdexcept>
 #include <cassert>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
+
+#include "Input.h"
+#include "Arena.h"
 
 using namespace std;
 
+// Packets of a list are made in (and freed along with) an Arena, so lists don't delete their elements
 class Packet {
 private:
     enum Type { VALUE, LIST } type;
@@ -17,7 +22,7 @@ private:
         int val;
         // vector of pointers, since don't want to move/copy around a bunch of Packets if vector resizes
         // (could use Packets themselves, but then need to define either move or copy constructor/assignment)
-        vector<Packet*> values;
+        pmr::vector<Packet*> values;
         // need to provide a default constructor
         constexpr Value() {
             val = 0;
@@ -32,19 +37,20 @@ public:
         value.val = num;
     }
 
-    explicit Packet(Packet* const parent) : parent(parent), type(LIST) {
-        value.values = vector<Packet*>();
+    explicit Packet(Packet* const parent, Arena& arena) : parent(parent), type(LIST) {
+        // union member starts out as an int, so the vector has to be constructed in place rather than assigned
+        new (&value.values) pmr::vector<Packet*>(&arena);
     }
 
+    Packet(const Packet&) = delete;
+    Packet& operator=(const Packet&) = delete;
+
     Packet* add(Packet* const p) {
         return value.values.emplace_back(p);
     }
 
     ~Packet() {
-        if (type == LIST) {
-            for (auto p : value.values) delete p;
-            value.values.~vector();
-        }
+        if (type == LIST) value.values.~vector();
     }
 
     strong_ordering operator<=>(const Packet& other) const {
@@ -81,39 +87,42 @@ public:
 };
 
 namespace day13 {
-    Packet* readPacket(ifstream& input) {
-        string line;
+    Packet* readPacket(Splitter& input, Arena& arena) {
+        string_view line;
         // After last ']', current = nullptr, so remember root separately
         Packet *root = nullptr, *current = nullptr;
 
-        while (getline(input, line)) {
+        while (input.next(line)) {
             if (line.length() == 0) { // blank line, move onto next pair
                 continue;
             }
 
-            istringstream lineStream(line);
-            char c;
-            while ((c = lineStream.peek()) != EOF) {
-                if (c == ',') lineStream.ignore(1);
+            const char* pos = line.data();
+            const char* end = pos + line.size();
+            while (pos != end) {
+                char c = *pos;
+                if (c == ',') pos++;
                 else if (c == '[') {
                     if (current == nullptr) { // top-level packets
-                        root = current = new Packet(current);
+                        root = current = arena.make<Packet>(current, arena);
                     }
                     else { // element of current packet
-                        current = current->add(new Packet(current));
+                        current = current->add(arena.make<Packet>(current, arena));
                     }
-                    lineStream.ignore(1);
+                    pos++;
                 }
                 else if (c == ']') {
                     assert(current != nullptr);
                     current = current->parent;
-                    lineStream.ignore(1);
+                    pos++;
                 }
                 else {
                     assert(current != nullptr);
                     int num;
-                    if (!(lineStream >> num)) throw invalid_argument("Malformed line!");
-                    current->add(new Packet(current, num));
+                    auto [numEnd, ec] = from_chars(pos, end, num);
+                    if (ec != errc()) throw invalid_argument("Malformed line!");
+                    pos = numEnd;
+                    current->add(arena.make<Packet>(current, num));
                 }
             }
 
@@ -123,44 +132,51 @@ namespace day13 {
         return nullptr;
     }
 
-    void part1() {
-        ifstream input{ "Day13.txt" };
+    // Packets in input order, so pairs are at indices (0, 1), (2, 3), ...
+    struct Input {
+        Arena arena; // owns every packet
+        vector<Packet*> packets;
 
-        Packet* p1 = nullptr;
-        Packet* p2 = nullptr;
-        int idx = 1;
-
-        int sum = 0;
+        // Packets take a few times the space of the text they're parsed from
+        explicit Input(size_t textSize) : arena(max<size_t>(Arena::DEFAULT_BLOCK_SIZE, textSize * 16)) {}
+    };
 
-        while ((p1 = readPacket(input)) != nullptr) {
-            assert((p2 = readPacket(input)) != nullptr);
-            if (*p1 < *p2) {
-                sum += idx;
-            }
+    shared_ptr<const Input> parse(string_view text) {
+        Splitter inputLines(text);
+        auto input = make_shared<Input>(text.size());
 
-            idx++;
-            delete p1;
-            delete p2;
+        Packet* p = nullptr;
+        while ((p = readPacket(inputLines, input->arena)) != nullptr) {
+            input->packets.push_back(p);
         }
+        if (input->packets.size() % 2 != 0) throw invalid_argument("Packets should come in pairs");
 
-        cout << sum << endl; // 6235
+        return input;
     }
 
-    void part2() {
-        ifstream input{ "Day13.txt" };
+    string solve1(const Input& input) {
+        const vector<Packet*>& packets = input.packets;
 
-        Packet* div1 = new Packet(nullptr, 2);
-        Packet* div2 = new Packet(nullptr, 6);
+        int sum = 0;
 
-        // Divider packets
-        vector<Packet*> packets{ div1, div2 };
+        for (size_t i = 0; i < packets.size(); i += 2) {
+            if (*packets[i] < *packets[i + 1]) {
+                sum += static_cast<int>(i / 2 + 1);
+            }
+        }
 
+        return to_string(sum); // 6235
+    }
 
-        Packet* p = nullptr;
+    string solve2(const Input& input) {
+        // Divider packets
+        Packet divider1(nullptr, 2);
+        Packet divider2(nullptr, 6);
+        Packet* div1 = &divider1;
+        Packet* div2 = &divider2;
 
-        while ((p = readPacket(input)) != nullptr) {
-            packets.push_back(p);
-        }
+        vector<Packet*> packets{ div1, div2 };
+        packets.insert(packets.end(), input.packets.begin(), input.packets.end());
 
         auto packetPtrComparator = [](Packet* const& p1, Packet* const& p2) {return *p1 < *p2; };
 
@@ -172,16 +188,9 @@ namespace day13 {
         assert(div2Pos != packets.end());
 
         // +1 to account for 0 vs 1 indexing
-        cout << (div1Pos - packets.begin() + 1) * (div2Pos - packets.begin() + 1) << endl; // 22866
-
-        // contains div1 and div2
-        for (Packet* p : packets) delete p;
-    }
-
-    int main() {
-        part2();
+        auto decoderKey = (div1Pos - packets.begin() + 1) * (div2Pos - packets.begin() + 1);
 
-        return 0;
+        return to_string(decoderKey); // 22866
     }
 
 }
\ No newline at end of file
@@ -1,16 +1,21 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <map>
-#include <set>
+#include <string_view>
+#include <vector>
 #include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+#include "Input.h"
+#include "Output.h"
+#include "Point.h"
+#include "Grid2D.h"
 
 using namespace std;
 
 namespace day14 {
 
-	void order(int& x, int& y, int& from, int& to) {
+	void order(int x, int y, int& from, int& to) {
 		if (x < y) {
 			from = x;
 			to = y;
@@ -21,161 +26,134 @@ namespace day14 {
 		}
 	}
 
-	bool readCoords(istringstream& input, int& x, int& y, int& yMax) {
-		char comma;
-		if (!(input >> x >> comma >> y)) return false;
+	bool readCoords(Tokens& input, int& x, int& y, int& yMax) {
+		string_view coords;
+		if (!input.next(coords)) return false;
+		size_t comma = coords.find(',');
+		x = parseNumber<int>(coords.substr(0, comma));
+		y = parseNumber<int>(coords.substr(comma + 1));
 		yMax = max(yMax, y);
-		input.ignore(strlen(" -> ")); // no-op for last entry of line
+		string_view arrow;
+		input.next(arrow); // " -> ", no-op for last entry of line
 		return true;
 	}
 
-	// represent as map of x -> set of occupied y coords
-	// keeps structure relatively sparse, easy to build initially, and scan to where sand falls to in column
-	// log(n) to find location in neighbour column though.
-	// returns max y coordinate
-	int readStructure(ifstream& input, map<int, set<int>>& occupied) {
+	const char EMPTY = '.';
+	const char ROCK = '#';
+	const char SAND = 'o';
+
+	struct Segment {
+		int x1, y1, x2, y2;
+	};
+
+	/*
+	Cave from x = xMin, with rows down to the part 2 floor.
+	Wide enough either side of the source that sand can't leave it: falling diagonally one column per row,
+	any that gets below the rock in part 1 is still within 500 +- floor, and part 2's pile is no wider than that.
+	*/
+	struct Input {
+		Grid2D<char> cave; // rock only
+		int xMin;
+		int yMax; // lowest rock
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		vector<Segment> segments;
 		int yMax = 0;
+		int rockXMin = 500, rockXMax = 500;
 
-		string line;
-		while (getline(input, line)) {
-			istringstream linestream{ line };
+		Splitter inputLines(text);
+		string_view line;
+		while (inputLines.next(line)) {
+			Tokens linestream{ line };
 			int lastX, lastY;
-			readCoords(linestream, lastX, lastY, yMax);
+			if (!readCoords(linestream, lastX, lastY, yMax)) continue;
 
 			int x, y;
 			while (readCoords(linestream, x, y, yMax)) {
-				int from, to;
-				if (x == lastX) {
-					// vertical
-					set<int>& column = occupied[x]; // creates empty set if not present
-
-					order(y, lastY, from, to);
-
-					for (int i = from; i <= to; i++) {
-						column.insert(i);
-					}
-				}
-				else {
-					// horizontal
-					order(x, lastX, from, to);
-
-					for (int i = from; i <= to; i++) {
-						occupied[i].insert(y); // creates empty set first if not present
-					}
-				}
-
+				segments.push_back({ lastX, lastY, x, y });
 				lastX = x;
 				lastY = y;
 			}
 		}
+		for (const Segment& s : segments) {
+			rockXMin = min({ rockXMin, s.x1, s.x2 });
+			rockXMax = max({ rockXMax, s.x1, s.x2 });
+		}
 
-		return yMax;
-	}
-
-	void printStructure(const map<int, set<int>>& occupied, const map<int, set<int>>& original, int floor) {
-		if (occupied.size() == 0) return;
-		int xMin = occupied.begin()->first;
-		int xMax = (occupied.rbegin())->first;
-
-		for (int y = 0; y < floor; y++) {
-			for (int x = xMin; x <= xMax; x++) {
-				if (!occupied.contains(x) || !occupied.at(x).contains(y)) cout << '.';
-				else if (!original.contains(x) || !original.at(x).contains(y)) cout << 'o';
-				else cout << '#';
+		int floor = yMax + 2;
+		auto input = make_shared<Input>();
+		input->yMax = yMax;
+		input->xMin = min(rockXMin, 500 - floor) - 1;
+		int xMax = max(rockXMax, 500 + floor) + 1;
+		input->cave = Grid2D<char>(xMax - input->xMin + 1, floor + 1, EMPTY);
+
+		for (const Segment& s : segments) {
+			int fromX, toX, fromY, toY;
+			order(s.x1, s.x2, fromX, toX);
+			order(s.y1, s.y2, fromY, toY);
+			if (fromX != toX && fromY != toY) throw invalid_argument("Rock paths must be horizontal or vertical");
+			for (int y = fromY; y <= toY; y++) {
+				for (int x = fromX; x <= toX; x++) {
+					input->cave(x - input->xMin, y) = ROCK;
+				}
 			}
-			cout << endl;
 		}
 
-		// floor
-		for (int x = xMin; x <= xMax; x++) cout << '#';
-		cout << endl;
+		return input;
 	}
 
-	set<int>& getColumn(map<int, set<int>>& occupied, int x, set<int>& defaultColumn) {
-		if (!occupied.contains(x)) occupied[x] = defaultColumn;
-		return occupied[x];
+	void printStructure(const Grid2D<char>& cave) {
+		for (int y = 0; y < cave.height(); y++) {
+			for (char c : cave.row(y)) DAY_LOG(DETAIL) << c;
+			DAY_LOG(DETAIL) << endl;
+		}
 	}
 
-	int fill(map<int, set<int>>& occupied, set<int>& defaultColumn) {
+	/*
+	Drops sand from the source until it either comes to rest there, or falls below yLimit (so forever).
+	Each grain would follow the same path as the last until where that one stopped,
+	so keeps the path and starts the next grain from the step before the last one settled.
+	*/
+	int fill(Grid2D<char>& cave, int xMin, int yLimit) {
 		int sandCount = 0;
-		bool progress = true;
-		while (progress) {
-			progress = false;
-			int x = 500, y = 0;
-			set<int>& column = getColumn(occupied, x, defaultColumn);
-			if (column.contains(y)) break; // source blocked
-
-			while (true) {
-				set<int>& column = getColumn(occupied, x, defaultColumn);
-
-				auto below = column.lower_bound(y);
-				if (below == column.end()) break; // falls forever
-				// will go to this level and 1 to the side if possible
-				int belowY = *below;
-
-				// try falling left
-				set<int>& left = getColumn(occupied, x - 1, defaultColumn);
-				if (!left.contains(belowY)) {
-					x -= 1;
-					y = belowY;
-					continue;
-				}
+		vector<Point<int>> path{ { 500 - xMin, 0 } };
 
-				// try falling right
-				set<int>& right = getColumn(occupied, x + 1, defaultColumn);
-				if (!right.contains(belowY)) {
-					x += 1;
-					y = belowY;
-					continue;
-				}
+		while (!path.empty()) {
+			Point<int> p = path.back();
+			if (p.y >= yLimit) break; // falls forever
 
-				// just insert at bottom of current column
-				column.insert(belowY - 1);
-				progress = true;
+			if (cave(p.x, p.y + 1) == EMPTY) path.push_back({ p.x, p.y + 1 });
+			else if (cave(p.x - 1, p.y + 1) == EMPTY) path.push_back({ p.x - 1, p.y + 1 });
+			else if (cave(p.x + 1, p.y + 1) == EMPTY) path.push_back({ p.x + 1, p.y + 1 });
+			else {
+				cave[p] = SAND;
 				sandCount++;
-				break;
+				path.pop_back();
 			}
 		}
 
 		return sandCount;
 	}
 
-	void part1() {
-		ifstream input{ "Day14.txt" };
+	string solve1(const Input& input) {
+		Grid2D<char> cave = input.cave;
 
-		map<int, set<int>> occupied;
-		int yMax = readStructure(input, occupied);
+		// anything below the lowest rock has nothing left to land on
+		int sandCount = fill(cave, input.xMin, input.yMax + 1);
 
-		set<int> defaultColumn {};
-
-		int sandCount = fill(occupied, defaultColumn);
-
-		cout << sandCount << endl; // 774
+		return to_string(sandCount); // 774
 	}
 
-	void part2() {
-		ifstream input{ "Day14.txt" };
-
-		map<int, set<int>> occupied;
-		int yMax = readStructure(input, occupied);
-		int yFloor = yMax + 2;
-
-		set<int> defaultColumn{ yFloor };
+	string solve2(const Input& input) {
+		Grid2D<char> cave = input.cave;
+		int yFloor = input.yMax + 2;
 
 		// fill in the 'floor'
-		for (auto& [key, column] : occupied) {
-			column.insert(yFloor);
-		}
-
-		int sandCount = fill(occupied, defaultColumn);
-
-		cout << sandCount << endl; // 22499
-	}
-
+		for (char& c : cave.row(yFloor)) c = ROCK;
 
-	int main() {
-		part2();
+		int sandCount = fill(cave, input.xMin, yFloor);
 
-		return 0;
+		return to_string(sandCount); // 22499
 	}
 }
\ No newline at end of file
@@ -1,12 +1,18 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+
+#include "Input.h"
+#include "Scanner.h"
+#include "Output.h"
+#include "Parallel.h"
+#include "Dispatch.h"
 
 using namespace std;
 
@@ -17,28 +23,48 @@ namespace day15 {
 		EMPTY
 	};
 
-	bool readCoords(ifstream& input, int& sensorX, int& sensorY, int& beaconX, int& beaconY) {
-		input.ignore(strlen("Sensor at x="));
-		if (!(input >> sensorX)) return false;
-		input.ignore(strlen(", y="));
-		input >> sensorY;
-
-		input.ignore(strlen(": closest beacon is at x="));
-		input >> beaconX;
-		input.ignore(strlen(", y="));
-		input >> beaconY;
-		input.ignore(numeric_limits<streamsize>::max(), '\n');
+	bool readCoords(Splitter& lines, int& sensorX, int& sensorY, int& beaconX, int& beaconY) {
+		string_view line;
+		if (!lines.next(line)) return false;
+		Scanner input(line);
+
+		if (!input.consume("Sensor at x=")) return false;
+		sensorX = input.number<int>();
+		input.expect(", y=");
+		sensorY = input.number<int>();
+
+		input.expect(": closest beacon is at x=");
+		beaconX = input.number<int>();
+		input.expect(", y=");
+		beaconY = input.number<int>();
 		return true;
 	}
 
-	void part1() {
-		ifstream input{ "Day15.txt" };
+	struct Reading {
+		int sensorX, sensorY, beaconX, beaconY;
+	};
+
+	struct Input {
+		vector<Reading> readings;
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		Splitter inputLines(text);
+		auto input = make_shared<Input>();
+
+		Reading r;
+		while (readCoords(inputLines, r.sensorX, r.sensorY, r.beaconX, r.beaconY)) {
+			input->readings.push_back(r);
+		}
+
+		return input;
+	}
 
+	string solve1(const Input& input) {
 		const int yRowIndex = 2000000;
 		map<int, Cell> yRow;
 
-		int sensorX, sensorY, beaconX, beaconY;
-		while (readCoords(input, sensorX, sensorY, beaconX, beaconY)) {
+		for (const auto& [sensorX, sensorY, beaconX, beaconY] : input.readings) {
 			if (sensorY == yRowIndex) yRow[sensorX] = SENSOR;
 			if (beaconY == yRowIndex) {
 				yRow[beaconX] = BEACON;
@@ -46,7 +72,7 @@ namespace day15 {
 			int distance = abs(sensorX - beaconX) + abs(sensorY - beaconY);
 			int yRowDistance = distance - abs(yRowIndex - sensorY);
 
-			cout << "Sensor = (" << sensorX << ", " << sensorY << "), Beacon = " << beaconX << ", " << beaconY
+			DAY_LOG(DETAIL) << "Sensor = (" << sensorX << ", " << sensorY << "), Beacon = " << beaconX << ", " << beaconY
 				<< "), distance=" << distance 
 				<< ", y row distance=" << yRowDistance << endl;
 
@@ -61,7 +87,7 @@ namespace day15 {
 			nonBeaconCount += (value != BEACON);
 		}
 
-		cout << nonBeaconCount << endl; // 5147333
+		return to_string(nonBeaconCount); // 5147333
 	}
 
 	void bound(int& value, int min, int max, int& distance) {
@@ -75,122 +101,152 @@ namespace day15 {
 		}
 	}
 
-	void part2() {
-		ifstream input{ "Day15.txt" };
+	// Removes [xMin, xMax] from a row's ordered intervals of [from, to] possible positions
+	void removeRange(vector<pair<int, int>>& row, int xMin, int xMax) {
+		// just do linear scan, at most numPairs distinct intervals in a row
+		auto it = row.begin();
+		while (it != row.end()) {
+			auto& [start, end] = *it;
+
+			if (start > xMax) break; // past relevant range, stop
+
+
+			if (end < xMin) {
+				it++;
+				continue; // too early, skip
+			}
+
+			// xMin <= end, start <= xMax, so at least some part overlaps
+			if (end <= xMax) { // end of existing interval can be truncated
+				if (start >= xMin) { // completely contained
+					it = row.erase(it);
+				}
+				else { // just truncate end
+					end = xMin - 1;
+					it++;
+				}
+				continue; // end overlapped with interval, next segment may overlap too
+			}
+			else { // end outside covered range, so only start/middle overlap (and no point checking further)
+				if (start >= xMin) { // truncate start
+					start = xMax + 1;
+					it++;
+				}
+				else { // split out middle
+					int originalEnd = end;
+					end = xMin - 1;
+					// insert new value to split range
+					it++;
+					row.insert(it, { xMax + 1, originalEnd });
+				}
+				break;
+			}
+		}
+	}
+
+	// A sensor clamped to the search area, and how far it rules out beacons from there
+	struct Coverage {
+		int sensorX;
+		int sensorY;
+		int distance;
+	};
+
+	// (x, y) of each cell left over in a range of rows
+	typedef vector<pair<int, int>> Cells;
 
-		// For each y coordinate, store intervals of possible positions (in 0-4M range), reduced by processing each sensor/beacon pair.
+	// Cells in [0, LIMIT] x [0, LIMIT] not ruled out by any sensor, specialised on LIMIT (see Dispatch.h)
+	template <int LIMIT>
+	Cells findUncovered(const Input& input, int limit) {
+		// For each y coordinate, find the intervals of possible positions (in 0-4M range), reduced by each sensor/beacon pair in turn.
 		// At end, will have only a singly entry.
 		// Alternative would be to start from (0,0), see which sensor(s) rule that out,
 		// then skip to the next point that sensor doesn't rule out and repeat, until 1 valid cell found.
 
-		// Complexity: ~30 sensor/beacon pairs * 4M rows * O(pairs) scan/update to the row = 4M * 30^2 -> a bit slow, but tractable
+		// Complexity: ~30 sensor/beacon pairs * 4M rows * O(pairs) scan/update to the row = 4M * 30^2 -> a bit slow, but tractable.
+		// Rows don't depend on each other though, so are split across threads, and each only needs its own row of intervals at a time
+		// (rather than keeping all 4M rows around, as when going sensor by sensor).
 
-		const int LIMIT = 4'000'000;
-		// Pairs are ordered intervals of [from, to]
-		vector<pair<int, int>>* grid = new vector<pair<int, int>>[LIMIT + 1];
-		vector<pair<int, int>> fullRow { { 0, LIMIT } };
-		fill(grid, grid + LIMIT + 1, fullRow);
+		const int size = fixedOr<LIMIT>(limit);
 
-
-		int sensorX, sensorY, beaconX, beaconY;
-		while (readCoords(input, sensorX, sensorY, beaconX, beaconY)) {
+		vector<Coverage> sensors;
+		// copies, since the sensor position gets clamped to the grid
+		for (auto [sensorX, sensorY, beaconX, beaconY] : input.readings) {
 
 			int distance = abs(sensorX - beaconX) + abs(sensorY - beaconY);
 
 			// adjust sensor coordinates to closest point of grid (never seems to be the case in practice)
-			bound(sensorX, 0, LIMIT, distance);
-			bound(sensorY, 0, LIMIT, distance);
+			bound(sensorX, 0, size, distance);
+			bound(sensorY, 0, size, distance);
 
 			if (distance < 0) continue; // out of range
 
 
 			int yMin = max(0, sensorY - distance);
-			int yMax = min(LIMIT, sensorY + distance);
+			int yMax = min(size, sensorY + distance);
 
-			cout << "Sensor = (" << sensorX << ", " << sensorY << "), Beacon = " << beaconX << ", " << beaconY
+			DAY_LOG(DETAIL) << "Sensor = (" << sensorX << ", " << sensorY << "), Beacon = " << beaconX << ", " << beaconY
 				<< "), distance=" << distance
 				<< ", y min=" << yMin << ", y max=" << yMax << endl;
 
-			for (int y = yMin; y <= yMax; y++) {
-				int xDistance = distance - abs(y - sensorY);
-				int xMin = sensorX - xDistance;
-				int xMax = sensorX + xDistance;
-
-				// remove range [xMin, xMax] from the row
-				vector<pair<int, int>>& row = grid[y];
-				// just do linear scan, at most numPairs distinct intervals in a row
-				auto it = row.begin();
-				while (it != row.end()) {
-					auto& [start, end] = *it;
-
-					if (start > xMax) break; // past relevant range, stop
-
-
-					if (end < xMin) {
-						it++;
-						continue; // too early, skip
-					}
-
-					// xMin <= end, start <= xMax, so at least some part overlaps
-					if (end <= xMax) { // end of existing interval can be truncated
-						if (start >= xMin) { // completely contained
-							it = row.erase(it);
-						}
-						else { // just truncate end
-							end = xMin - 1;
-							it++;
-						}
-						continue; // end overlapped with interval, next segment may overlap too
-					}
-					else { // end outside covered range, so only start/middle overlap (and no point checking further)
-						if (start >= xMin) { // truncate start
-							start = xMax + 1;
-							it++;
-						}
-						else { // split out middle
-							int originalEnd = end;
-							end = xMin - 1;
-							// insert new value to split range
-							it++;
-							row.insert(it, { xMax + 1, originalEnd });
-						}
-						break;
-					}
+			sensors.push_back({ sensorX, sensorY, distance });
+		}
+
+		return parallel::reduce(0, size + 1, Cells(), [&](int from, int to) {
+			Cells found;
+			// Pairs are ordered intervals of [from, to]
+			vector<pair<int, int>> row;
+			for (int y = from; y < to; y++) {
+				row.assign(1, { 0, size });
+				for (const auto& [sensorX, sensorY, distance] : sensors) {
+					int xDistance = distance - abs(y - sensorY);
+					if (xDistance < 0) continue; // out of range of this row
+					removeRange(row, sensorX - xDistance, sensorX + xDistance);
+				}
+
+				if (row.size() == 0) continue;
+				if (row.size() > 1) {
+					throw invalid_argument("Expected at most 1 remaining value, found row " + to_string(y) + " with multiple intervals: " + to_string(row.size()));
 				}
+				const auto& [xMin, xMax] = row[0];
+				if (xMin < xMax) {
+					throw invalid_argument("Expected at most 1 remaining value, found row " + to_string(y) + " with range: " + to_string(xMin) + " to " + to_string(xMax));
+				}
+				found.push_back({ xMin, y });
 			}
+			return found;
+		}, [](Cells left, Cells right) {
+			left.insert(left.end(), right.begin(), right.end());
+			return left;
+		});
+	}
+
+	// The puzzle searches 0-4M, except in its example where every sensor is within 0-20
+	int searchLimit(const Input& input) {
+		const int EXAMPLE_LIMIT = 20;
+		for (const Reading& r : input.readings) {
+			if (r.sensorX < 0 || r.sensorX > EXAMPLE_LIMIT || r.sensorY < 0 || r.sensorY > EXAMPLE_LIMIT) return 4'000'000;
 		}
+		return EXAMPLE_LIMIT;
+	}
+
+	string solve2(const Input& input) {
+		const int limit = searchLimit(input);
+		Cells remaining = dispatch<4'000'000, 20>(limit, [&](auto l) { return findUncovered<decltype(l)::value>(input, limit); });
 
 		// find the single remaining value
 		int64_t resultX = -1;
 		int64_t resultY = -1;
-		for (int i = 0; i <= LIMIT; i++) {
-			const auto& row = grid[i];
-			if (row.size() == 0) continue;
-			if (row.size() > 1) {
-				throw invalid_argument("Expected at most 1 remaining value, found row " + to_string(i) + " with multiple intervals: " + to_string(row.size()));
-			}
-			const auto& [xMin, xMax] = row[0];
-			if (xMin < xMax) {
-				throw invalid_argument("Expected at most 1 remaining value, found row " + to_string(i) + " with range: " + to_string(xMin) + " to " + to_string(xMax));
-			}
-
+		for (const auto& [x, y] : remaining) {
 			if (resultX != -1) {
-				throw invalid_argument("Found cell (" + to_string(xMin) + "), " + to_string(i) + ", but already had cell (" + to_string(resultX) + "," + to_string(resultY) + ")");
+				throw invalid_argument("Found cell (" + to_string(x) + "), " + to_string(y) + ", but already had cell (" + to_string(resultX) + "," + to_string(resultY) + ")");
 			}
 
-			resultX = xMin;
-			resultY = i;
+			resultX = x;
+			resultY = y;
 		}
 
-		cout << resultX << ", " << resultY << endl; 
-		cout << 4000000 * resultX + resultY << endl; // 13734006908372
-
-		delete[] grid;
-	}
-
-	int main() {
-		part2();
+		DAY_LOG(SUMMARY) << resultX << ", " << resultY << endl;
 
-		return 0;
+		return to_string(4000000 * resultX + resultY); // 13734006908372
 	}
 }
\ No newline at end of file
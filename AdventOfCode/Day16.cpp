@@ -1,13 +1,22 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
 #include <set>
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <atomic>
+
+#include "Input.h"
+#include "Trace.h"
+#include "SearchStats.h"
+#include "Scanner.h"
+#include "Output.h"
+#include "Parallel.h"
+#include "ParseCache.h"
 
 using namespace std;
 
@@ -21,38 +30,33 @@ namespace day16 {
 		Valve(string key, int flow) : key(key), flow(flow) {}
 	};
 
-	void readNode(ifstream& input, map<string, Valve>& valves) {
-		string line;
-		while (getline(input, line)) {
-			istringstream iss{ line };
+	void readNode(string_view text, map<string, Valve>& valves) {
+		TRACE_SCOPE("readNode");
+		Splitter inputLines(text);
+		string_view line;
+		while (inputLines.next(line)) {
+			Scanner valveLine(line);
 
 			// Valve XD has flow rate=10; tunnels lead to valves AB, NQ, VT, SC, MU
 			// Valve VM has flow rate=18; tunnel leads to valve HQ
-			iss.ignore(strlen("Valve "));
-			string key;
-			if (!(iss >> key)) return;
+			if (!valveLine.consume("Valve ")) return;
+			string key{ valveLine.until(' ') };
 
-			iss.ignore(strlen(" has flow rate="));
-			int flow;
-			iss >> flow;
+			valveLine.expect(" has flow rate=");
+			int flow = valveLine.number<int>();
 			// emplace returns pair {iterator to element, bool if inserted or existing element updated}
 			Valve& valve = valves.emplace(key, Valve(key, flow)).first->second;
 
-			iss.ignore(strlen("; "));
-
-			string placeholder;
-			for (int i = 0; i < 4; i++) iss >> placeholder;
+			if (!valveLine.consume("; tunnels lead to valves ")) valveLine.expect("; tunnel leads to valve ");
 
-			string tunnel;
-			iss >> ws;
-			while (getline(iss, tunnel, ',')) {
-				valve.tunnels[tunnel] = 1;
-				iss >> ws; // skip whitespace after comma
-			}
+			do {
+				valve.tunnels[string(valveLine.until(','))] = 1;
+			} while (valveLine.consume(", "));
 		}
 	}
 
 	void deleteIntermediates(map<string, Valve>& valves) {
+		TRACE_SCOPE("deleteIntermediates");
 		auto it = valves.begin();
 		while (it != valves.end()) {
 			auto& [removedKey, removedValve] = *it;
@@ -95,6 +99,7 @@ namespace day16 {
 		Note: This implementation does not include self loops (weight 0, but useless)
 	*/
 	void floydWarshall(map<string, Valve>& graph, map<string, map<string, int>>& shortestDistances) {
+		TRACE_SCOPE("floydWarshall");
 		// initially, shortest paths are just the direct paths
 		for (const auto& [key, valve] : graph) {
 			for (const auto& [destination, weight] : valve.tunnels) {
@@ -118,6 +123,16 @@ namespace day16 {
 		}
 	}
 
+	// Raises best to score if that's higher, returning whether it did. Relaxed, since it's only a bound to prune against
+	// (seeing another thread's improvement late just means pruning a little less).
+	bool improve(atomic<int>& best, int score) {
+		int current = best.load(memory_order_relaxed);
+		while (score > current) {
+			if (best.compare_exchange_weak(current, score, memory_order_relaxed)) return true;
+		}
+		return false;
+	}
+
 	/*
 	* Before: Currently at valve, and it is either on or has 0 flow, and everything in 'visited' is on (in order visited).
 	 */
@@ -125,14 +140,18 @@ namespace day16 {
 		const map<string, Valve>& valves,
 		const map<string, map<string, int>>& shortestPaths,
 		set<string>& visited,
-		int& bestScore,
+		atomic<int>& bestScore,
 		int currentScore,
 		int remainingFlow,
 		int remainingTime,
 		const Valve& valve
 	) {
 		int maxDistance = remainingTime - 2; // at least 1 min to turn on + 1 min to accumulate any flow
-		if (currentScore + maxDistance * remainingFlow <= bestScore) return; // even if all switched on, can't beat top score
+		if (currentScore + maxDistance * remainingFlow <= bestScore.load(memory_order_relaxed)) { // even if all switched on, can't beat top score
+			SEARCH_STAT(pruned);
+			return;
+		}
+		SEARCH_STAT(expanded);
 
 		const string& currentKey = valve.key;
 		visited.insert(currentKey);
@@ -150,7 +169,7 @@ namespace day16 {
 		}
 
 		// in case we ended up skipping all of them (either already visited or no time left)
-		if (!progressing) bestScore = max(currentScore, bestScore);
+		if (!progressing && improve(bestScore, currentScore)) SEARCH_STAT(improvements);
 
 		visited.erase(currentKey);
 	}
@@ -168,7 +187,7 @@ namespace day16 {
 		const map<string, Valve>& valves,
 		const map<string, map<string, int>>& shortestPaths,
 		set<string>& visited,
-		int& bestScore,
+		atomic<int>& bestScore,
 		int currentScore,
 		int remainingFlow,
 		int remainingTime,
@@ -178,11 +197,15 @@ namespace day16 {
 	) {
 		// effectively a prefix of the search space
 		if (valve1.key == "AA") {
-			cout << "T=" << remainingTime << ": v1=" << valve1.key << ", v2=" << valve2.key 
-				<< ", score=" << currentScore << ", best=" << bestScore << endl;
+			DAY_LOG(DETAIL) << "T=" << remainingTime << ": v1=" << valve1.key << ", v2=" << valve2.key 
+				<< ", score=" << currentScore << ", best=" << bestScore.load() << endl;
 		}
 		int maxDistance = remainingTime - 2; // at least 1 min to turn on + 1 min to accumulate any flow
-		if (currentScore + maxDistance * remainingFlow <= bestScore) return; // even if all switched on, can't beat top score
+		if (currentScore + maxDistance * remainingFlow <= bestScore.load(memory_order_relaxed)) { // even if all switched on, can't beat top score
+			SEARCH_STAT(pruned);
+			return;
+		}
+		SEARCH_STAT(expanded);
 
 		const string& currentKey = valve1.key;
 		visited.insert(currentKey);
@@ -224,53 +247,97 @@ namespace day16 {
 		visited.erase(currentKey);
 	}
 
-	void part1() {
-		ifstream input{ "Day16.txt" };
-
+	// Graph reduced to just the valves worth opening (plus AA), with distances between every pair of them
+	struct Input {
 		map<string, Valve> valves;
-		readNode(input, valves);
+		map<string, map<string, int>> shortestPaths;
+		int totalFlow = 0;
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		auto input = make_shared<Input>();
+		map<string, Valve>& valves = input->valves;
+
+		readNode(text, valves);
 
-		cout << "Original number of nodes: " << valves.size() << endl;
+		DAY_LOG(SUMMARY) << "Original number of nodes: " << valves.size() << endl;
 
 		deleteIntermediates(valves);
 
-		cout << "Reduced number of nodes: " << valves.size() << endl;
+		DAY_LOG(SUMMARY) << "Reduced number of nodes: " << valves.size() << endl;
 
-		map<string, map<string, int>> shortestPaths;
-		floydWarshall(valves, shortestPaths);
+		floydWarshall(valves, input->shortestPaths);
 
-		int totalFlow = 0;
-		for (const auto& [_, valve] : valves) totalFlow += valve.flow;
+		for (const auto& [_, valve] : valves) input->totalFlow += valve.flow;
 
-		int bestScore = -1;
-		set<string> visited;
-		dfs(valves, shortestPaths, visited, bestScore, 0, totalFlow, 30, valves.at("AA"));
+		return input;
+	}
+
+	void saveWeights(const map<string, int>& weights, cache::Writer& out) {
+		out.put<uint64_t>(weights.size());
+		for (const auto& [key, weight] : weights) {
+			out.putString(key);
+			out.put(weight);
+		}
+	}
 
-		cout << bestScore << endl; // 2124
+	map<string, int> loadWeights(cache::Reader& in) {
+		map<string, int> weights;
+		for (uint64_t n = in.get<uint64_t>(); n > 0; n--) {
+			string key{ in.getString() };
+			weights.emplace_hint(weights.end(), key, in.get<int>());
+		}
+		return weights;
 	}
 
-	void part2() {
-		ifstream input{ "Day16.txt" };
+	// Reduced graph and its distances, so loading skips the Floyd-Warshall as well as the parsing
+	void save(const Input& input, cache::Writer& out) {
+		out.put<uint64_t>(input.valves.size());
+		for (const auto& [key, valve] : input.valves) {
+			out.putString(key);
+			out.put(valve.flow);
+			saveWeights(valve.tunnels, out);
+		}
+		out.put<uint64_t>(input.shortestPaths.size());
+		for (const auto& [key, distances] : input.shortestPaths) {
+			out.putString(key);
+			saveWeights(distances, out);
+		}
+		out.put(input.totalFlow);
+	}
 
-		map<string, Valve> valves;
-		readNode(input, valves);
+	shared_ptr<const Input> load(cache::Reader& in) {
+		auto input = make_shared<Input>();
+		for (uint64_t n = in.get<uint64_t>(); n > 0; n--) {
+			string key{ in.getString() };
+			int flow = in.get<int>();
+			Valve& valve = input->valves.emplace_hint(input->valves.end(), key, Valve(key, flow))->second;
+			valve.tunnels = loadWeights(in);
+		}
+		for (uint64_t n = in.get<uint64_t>(); n > 0; n--) {
+			string key{ in.getString() };
+			input->shortestPaths.emplace_hint(input->shortestPaths.end(), key, loadWeights(in));
+		}
+		input->totalFlow = in.get<int>();
+		return input;
+	}
 
-		cout << "Original number of nodes: " << valves.size() << endl;
+	string solve1(const Input& input) {
+		const map<string, Valve>& valves = input.valves;
 
-		deleteIntermediates(valves);
+		atomic<int> bestScore{ -1 };
+		set<string> visited;
+		TRACE_SCOPE("dfs");
+		dfs(valves, input.shortestPaths, visited, bestScore, 0, input.totalFlow, 30, valves.at("AA"));
 
-		cout << "Reduced number of nodes: " << valves.size() << endl;
+		return to_string(bestScore.load()); // 2124
+	}
 
-		map<string, map<string, int>> shortestPaths;
-		floydWarshall(valves, shortestPaths);
+	string solve2(const Input& input) {
+		const map<string, Valve>& valves = input.valves;
 
-		int bestScore = -1;
-		set<string> visited;
 		const Valve& startValve = valves.at("AA");
 
-		int totalFlow = 0;
-		for (const auto& [_, valve] : valves) totalFlow += valve.flow;
-
 		// Possible optimisations:
 		// 1. make visited a set - log(n) lookup + insert + remove, rather than O(n) lookup for each neighbour + constant insert/remove
 		//		time taken = 1191 = 20mnis
@@ -278,18 +345,43 @@ namespace day16 {
 		//		only takes 15s with upper bound!
 		// 3. do a full search with 1 person, then just repeat for the other with a reduced visited set
 		//		54s, slower since we can't estimate the max value from the second path well until we finish the first player's path
-		time_t start, end;
-		time(&start);
-		dfs2(valves, shortestPaths, visited, bestScore, 0, totalFlow, 26, startValve, startValve, 0);
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
-
-		cout << bestScore << endl; // 2775
-	}
+		// 4. split on the first move (below), to search each subtree on a different thread
+		TRACE_SCOPE("dfs2");
+		const int time = 26;
+		atomic<int> sharedBest{ 0 };
+		DAY_LOG(DETAIL) << "T=" << time << ": v1=" << startValve.key << ", v2=" << startValve.key
+			<< ", score=0, best=" << sharedBest.load() << endl;
+
+		// Both start at AA, and dfs2 from there immediately hands over to the second player,
+		// so the first real choice is which valve they head to. Each is an independent subtree,
+		// only sharing the best score so far (doing nothing scores 0), which every subtree prunes against
+		// and raises as soon as it finds better, so they all benefit from whichever finds a good one first.
+		vector<pair<string, int>> firstMoves;
+		for (const auto& [next, weight] : input.shortestPaths.at(startValve.key)) {
+			if (weight <= time - 2) firstMoves.push_back({ next, weight });
+		}
 
+		vector<string> logs(firstMoves.size());
+		vector<SearchStats> stats(firstMoves.size());
+		parallel::forEach<size_t>(0, firstMoves.size(), [&](size_t i) {
+			const auto& [next, weight] = firstMoves[i];
+			const Valve& nextValve = valves.at(next);
+			OutputCapture capture;
+
+			set<string> visited{ startValve.key };
+			stats[i] = countSearch([&]() {
+				dfs2(valves, input.shortestPaths, visited, sharedBest, nextValve.flow * (time - weight - 1), input.totalFlow - nextValve.flow,
+					time, startValve, nextValve, weight + 1);
+			});
+			logs[i] = capture.str();
+		}, 1);
+
+		// each subtree's output together, in order (already only what was wanted)
+		for (size_t i = 0; i < firstMoves.size(); i++) {
+			DAY_LOG(SUMMARY) << logs[i];
+			searchStats() += stats[i];
+		}
 
-	void main() {
-		part2();
+		return to_string(sharedBest.load()); // 2775
 	}
 }
\ No newline at end of file
@@ -1,14 +1,22 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <span>
 #include <numeric>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 
 #include "Point.h"
+#include "FlatPointSet.h"
+#include "Input.h"
+#include "Output.h"
+#include "Checkpoint.h"
 
 using namespace std;
 
@@ -42,7 +50,7 @@ namespace day17 {
 			Coordinates indexed from 1 (so 0 is the floor tiles), to match height.
 			Valid tiles are (xmin, xmax]
 		*/
-		bool move(const Point<int64_t>& direction, const int xmin, const int xmax, const set<Point<int64_t>>& occupied) {
+		bool move(const Point<int64_t>& direction, const int xmin, const int xmax, const FlatPointSet<int64_t>& occupied) {
 			Point newLowerLeft = lowerLeft + direction;
 			// floor is y=0, so lowest a rock can be is y=1
 			if (newLowerLeft.x <= xmin || newLowerLeft.y <= 0) return false;
@@ -55,7 +63,7 @@ namespace day17 {
 			return true;
 		}
 
-		void rest(set<Point<int64_t>>& occupied) {
+		void rest(FlatPointSet<int64_t>& occupied) {
 			for (const auto& offset : offsets) {
 				const Point newOccupied = lowerLeft + offset;
 				occupied.insert(newOccupied);
@@ -90,20 +98,25 @@ namespace day17 {
 		return dir;
 	}
 
-	vector<Point<int64_t>> readDirections() {
-		ifstream input{ "Day17.txt" };
+	// jet pattern, as LEFT/RIGHT unit steps
+	struct Input {
 		vector<Point<int64_t>> directions;
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		auto input = make_shared<Input>();
+		vector<Point<int64_t>>& directions = input->directions;
 
-		char dir;
-		while (input >> dir) {
-			if (dir == '<') directions.push_back(Point<int64_t>::LEFT);
+		for (char dir : text) {
+			if (dir == '\n') continue;
+			else if (dir == '<') directions.push_back(Point<int64_t>::LEFT);
 			else if (dir == '>') directions.push_back(Point<int64_t>::RIGHT);
 			else {
-				throw invalid_argument("Unrecognised input: " + dir);
+				throw invalid_argument("Unrecognised input: " + string(1, dir));
 			}
 		}
 
-		return directions;
+		return input;
 	}
 
 	class Cave {
@@ -114,7 +127,7 @@ namespace day17 {
 		const Point<int64_t> offset{ 3, 4 }; // 2 empty spaces to left, 3 empty spaces below
 		RockCallback rockPlacedCallback = [](auto& rock) {}; // called after a rock comes to rest, with rocksPlaced updated
 		RockCallback stepCallback = [](auto& rock) {}; // called after every downwards step, before rock (possibly) comes to rest
-		set<Point<int64_t>> occupied;
+		FlatPointSet<int64_t> occupied;
 		Rock currentRock;
 
 		/*
@@ -169,10 +182,85 @@ namespace day17 {
 			while (!p()) step();
 		}
 
+		/*
+		Lowest row a falling rock could still get into, found by flood filling the empty cells down from above the stack
+		(a single cell can go anywhere a rock can). Rows below are sealed off, so never looked at again.
+		*/
+		int64_t lowestReachable() const {
+			FlatPointSet<int64_t> reached;
+			vector<Point<int64_t>> toVisit;
+			for (int64_t x = 1; x <= 7; x++) toVisit.push_back({ x, ymax + 1 });
+			int64_t lowest = ymax + 1;
+			while (!toVisit.empty()) {
+				Point<int64_t> p = toVisit.back();
+				toVisit.pop_back();
+				if (p.x < 1 || p.x > 7 || p.y < 1 || occupied.contains(p) || !reached.insert(p)) continue;
+				lowest = min(lowest, p.y);
+				toVisit.push_back(p + Point<int64_t>::LEFT);
+				toVisit.push_back(p + Point<int64_t>::RIGHT);
+				toVisit.push_back(p + Point<int64_t>::DOWN);
+			}
+			return lowest;
+		}
+
+		/*
+		What decides where every rock from here on ends up, relative to the top of the stack: the next rock and jet,
+		then the rows rocks can still reach or rest on, top down, a bit per cell. Equal for two points in the fall
+		only if everything after them repeats.
+		*/
+		string state() const {
+			string key;
+			key.push_back(static_cast<char>(arrangementIdx));
+			key.append(reinterpret_cast<const char*>(&dirIdx), sizeof(dirIdx));
+			int64_t lowest = lowestReachable() - 1;
+			for (int64_t y = ymax; y >= max<int64_t>(lowest, 1); y--) {
+				char row = 0;
+				for (int64_t x = 1; x <= 7; x++) {
+					if (occupied.contains({ x, y })) row |= 1 << (x - 1);
+				}
+				key.push_back(row);
+			}
+			if (lowest < 1) key.push_back(static_cast<char>(0xFF)); // down to the floor, which no row can look like
+			return key;
+		}
+
+		// Everything needed to carry on from here, for a snapshot (see Checkpoint.h).
+		// Only the rows rocks can still reach, or rest on, so it stays small however tall the stack gets.
+		void save(cache::Writer& out) const {
+			out.put(arrangementIdx);
+			out.put(dirIdx);
+			out.put(rocksPlaced);
+			out.put(ymax);
+			out.put(currentRock.position());
+
+			vector<Point<int64_t>> points;
+			for (int64_t y = max<int64_t>(lowestReachable() - 1, 1); y <= ymax; y++) {
+				for (int64_t x = 1; x <= 7; x++) {
+					if (occupied.contains({ x, y })) points.push_back({ x, y });
+				}
+			}
+			out.putVector(points);
+		}
+
+		void load(cache::Reader& in) {
+			arrangementIdx = in.get<int>();
+			dirIdx = in.get<int>();
+			if (arrangementIdx < 0 || arrangementIdx >= Rock::arrangements.size() || dirIdx < 0 || dirIdx >= directions.size()) {
+				throw invalid_argument("Snapshot doesn't match the jet pattern");
+			}
+			rocksPlaced = in.get<int64_t>();
+			ymax = in.get<int64_t>();
+			currentRock = Rock(in.get<Point<int64_t>>(), Rock::arrangements[arrangementIdx]);
+
+			occupied.clear();
+			for (const Point<int64_t>& p : in.getVector<Point<int64_t>>()) occupied.insert(p);
+		}
+
 		void skip(size_t heightSkipped, size_t rocksSkipped) {
 			rocksPlaced += rocksSkipped;
 
-			set<Point<int64_t>> newOccupied;
+			FlatPointSet<int64_t> newOccupied;
+			newOccupied.reserve(occupied.size());
 			for (const auto& [x, y] : occupied) newOccupied.insert(Point<int64_t>(x, y + heightSkipped));
 			occupied = newOccupied;
 
@@ -183,69 +271,65 @@ namespace day17 {
 		}
 	};
 
-	void part1() {
-		vector<Point<int64_t>> directions = readDirections();
-		Cave cave{ directions };
+	// Of what's snapshotted while rocks fall (see Checkpoint.h): the cave
+	const int SNAPSHOT_VERSION = 3;
+
+	cache::Writer startingState(const Input& input) {
+		cache::Writer start;
+		start.putVector(input.directions);
+		return start;
+	}
+
+	string solve1(const Input& input) {
+		Cave cave{ input.directions };
 
-		cave.runUntil([&]() {return cave.rocksPlaced == 2022; });
+		checkpoint::Simulation snapshots(17, 1, SNAPSHOT_VERSION, startingState(input));
+		snapshots.resume([&](cache::Reader& in) { cave.load(in); });
 
-		cout << "At end, ymax = " << cave.ymax << endl; // 3168
+		cave.runUntil([&]() {
+			snapshots.maybeSave(cave.rocksPlaced, [&](cache::Writer& out) { cave.save(out); });
+			return cave.rocksPlaced == 2022;
+		});
+		snapshots.finish();
+
+		return to_string(cave.ymax); // 3168
 	}
 
-	void part2() {
-		vector<Point<int64_t>> directions = readDirections();
-		Cave cave{ directions };
-
-		// Cycle - direction index reaching the same value, when the same rock has just been selected as previously.
-		// Also verify at that point that the 'floor' is effectively the same:
-		//	Strictly - anything that went below ymax at the point the new rock had been selected, ends up in same place.
-		//  Simple verification - with another cycle of rocks (or 2 after this), get exact same layout
-		// Given it's a cycle, look at first 'new' rock after direction index resets
-		// More generally, due to rocks taking a few steps to fall, could actually be several alternating cycles,
-		// so don't overwrite the index after the first time it is set.
-		vector<int> perRockCycleIdx;
-		vector<int64_t> perRockRocksPlaced; // work out how large the loop is
-		
-		// validate loop
+	string solve2(const Input& input) {
+		Cave cave{ input.directions };
+
+		// Cycle - the whole state (see Cave::state) after a rock comes to rest matching an earlier one, so everything
+		// from there repeats. Usually found within a pass or two of the jet pattern, though where depends on the jets.
+		unordered_map<string, int64_t> rocksPlacedAt;
 		int64_t loopRockCount = -1;
 		int loopNextRockIdx;
 		int loopNextDirIdx;
 
-		for (const auto& arrangement : Rock::arrangements) {
-			perRockCycleIdx.push_back(-1);
-			perRockRocksPlaced.push_back(0);
-		}
-		perRockCycleIdx[0] = 0; // first action first rock is the direction at index 0
-		bool firstRockAfterCycle = false;
-
-		cave.setStepCallback([&](auto& rock) {
-			if (cave.dirIdx == 0) firstRockAfterCycle = true;
-		});
 		cave.setRockPlacedCallback([&](auto& rock) {
-			int nextRockIdx = cave.arrangementIdx;
-
-			if (firstRockAfterCycle) {
-				firstRockAfterCycle = false;
-				int previousCycleIdx = perRockCycleIdx[nextRockIdx];
-				if (previousCycleIdx == -1) {
-					// first time we've seen this as the first rock after a loop
-					perRockCycleIdx[nextRockIdx] = cave.dirIdx;
-					perRockRocksPlaced[nextRockIdx] = cave.rocksPlaced;
-				}
-				else if (previousCycleIdx == cave.dirIdx) {
-					// found a loop!
-					loopNextDirIdx = cave.dirIdx;
-					loopNextRockIdx = nextRockIdx;
-					loopRockCount = cave.rocksPlaced - perRockRocksPlaced[nextRockIdx];
-				}
+			auto [it, added] = rocksPlacedAt.try_emplace(cave.state(), cave.rocksPlaced);
+			if (!added) {
+				loopNextDirIdx = cave.dirIdx;
+				loopNextRockIdx = cave.arrangementIdx;
+				loopRockCount = cave.rocksPlaced - it->second;
 			}
 		});
 
-		cave.runUntil([&]() {return loopRockCount != -1; });
-
-		cave.setStepCallback([](auto& rock) {});
+		// only finding the cycle can take a while, the rest is at most a couple of loops.
+		// The states seen so far aren't saved, so a resumed run finds the cycle a little further on.
+		checkpoint::Simulation snapshots(17, 2, SNAPSHOT_VERSION, startingState(input));
+		snapshots.resume([&](cache::Reader& in) { cave.load(in); });
+
+		// more than this and there's no cycle to be found in any reasonable time
+		const int64_t maxRocksToCycle = 20 * static_cast<int64_t>(input.directions.size()) + 10000;
+		cave.runUntil([&]() {
+			snapshots.maybeSave(cave.rocksPlaced, [&](cache::Writer& out) { cave.save(out); });
+			if (loopRockCount == -1 && cave.rocksPlaced > maxRocksToCycle) {
+				throw invalid_argument("No cycle after " + to_string(cave.rocksPlaced) + " rocks");
+			}
+			return loopRockCount != -1;
+		});
 
-		cout << "Loop on dirIdx=" << loopNextDirIdx << " and rockIdx=" << loopNextRockIdx << ", num rocks=" << loopRockCount
+		DAY_LOG(SUMMARY) << "Loop on dirIdx=" << loopNextDirIdx << " and rockIdx=" << loopNextRockIdx << ", num rocks=" << loopRockCount
 			<< ", starting from rocks placed=" << cave.rocksPlaced << endl;
 
 		// validate that we have a loop:
@@ -266,7 +350,7 @@ namespace day17 {
 		int64_t ymaxAfterLoop = cave.ymax;
 		int64_t loopHeight = ymaxAfterLoop - ymaxBeforeLoop;
 
-		cout << "Loop height = " << loopHeight << endl;
+		DAY_LOG(SUMMARY) << "Loop height = " << loopHeight << endl;
 
 		// second loop, confirm only difference is height (based on how big one loop is)
 		int64_t loopStart = cave.rocksPlaced;
@@ -291,16 +375,12 @@ namespace day17 {
 		// update both accordingly
 		cave.skip(heightSkipped, rocksSkipped);
 
-		cout << "Skipped " << rocksSkipped << " rocks, now at " << cave.rocksPlaced << ", remaining=" << targetRocks - cave.rocksPlaced << endl;
+		DAY_LOG(SUMMARY) << "Skipped " << rocksSkipped << " rocks, now at " << cave.rocksPlaced << ", remaining=" << targetRocks - cave.rocksPlaced << endl;
 
 		cave.runUntil([&]() {return cave.rocksPlaced == targetRocks; });
 
-		cout << "Final ymax=" << cave.ymax << endl; // 1554117647070
-	}
-
+		snapshots.finish();
 
-	void main() {
-		part1();
-		part2();
+		return to_string(cave.ymax); // 1554117647070
 	}
 }
\ No newline at end of file
@@ -1,30 +1,39 @@
-#include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <set>
+#include <string_view>
 #include <vector>
-#include <numeric>
-#include <functional>
+#include <tuple>
+#include <limits>
+#include <memory>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "Input.h"
+#include "Simd.h"
 
 using namespace std;
 
 namespace day18 {
 	typedef tuple<int, int, int> Voxel;
 
-	class Shape {
+	/*
+	Which cells are filled, as one long mask of bits (see Simd.h) with a cell of empty padding all round:
+	(x, y) plane after plane, each plane starting on a new word.
+	A cell's neighbours are then the bits 1, width and a whole plane away, so shifting the whole mask
+	that far lines each cell up with one of its neighbours.
+	*/
+	class Volume {
 	public:
-		// bounds
-		int xmin = numeric_limits<int>::max();
-		int xmax = numeric_limits<int>::min();
-		int ymin = numeric_limits<int>::max();
-		int ymax = numeric_limits<int>::min();
-		int zmin = numeric_limits<int>::max();
-		int zmax = numeric_limits<int>::min();
-
-		const set<Voxel> cells;
-
-		Shape(const set<Voxel>& cells) : cells(cells) {
+		int width = 0;
+		int height = 0;
+		int depth = 0;
+		size_t planeWords = 0;
+		vector<uint64_t> bits;
+
+		explicit Volume(const vector<Voxel>& cells) {
+			if (cells.empty()) return;
+			int xmin = numeric_limits<int>::max(), ymin = numeric_limits<int>::max(), zmin = numeric_limits<int>::max();
+			int xmax = numeric_limits<int>::min(), ymax = numeric_limits<int>::min(), zmax = numeric_limits<int>::min();
 			for (const auto& [x, y, z] : cells) {
 				xmin = min(x, xmin);
 				xmax = max(x, xmax);
@@ -33,49 +42,90 @@ namespace day18 {
 				zmin = min(z, zmin);
 				zmax = max(z, zmax);
 			}
+
+			width = xmax - xmin + 3;
+			height = ymax - ymin + 3;
+			depth = zmax - zmin + 3;
+			planeWords = simd::wordsFor(static_cast<size_t>(width) * height);
+			bits.assign(depth * planeWords, 0);
+			for (const auto& [x, y, z] : cells) set(x - xmin + 1, y - ymin + 1, z - zmin + 1);
 		}
-	};
 
-	Shape readShape() {
-		ifstream input{ "Day18.txt" };
-		set<Voxel> result;
+		size_t words() const {
+			return bits.size();
+		}
 
-		string line;
-		while (getline(input, line)) {
-			istringstream iss{ line };
-			int x, y, z;
-			char comma;
+		void set(int x, int y, int z) {
+			size_t bit = static_cast<size_t>(y) * width + x;
+			bits[z * planeWords + bit / 64] |= uint64_t{ 1 } << (bit % 64);
+		}
 
-			iss >> x >> comma >> y >> comma >> z;
-			result.insert({ x, y, z });
+		// How far to shift the mask to line a cell up with its neighbour along each axis
+		array<size_t, 3> steps() const {
+			return { 1, static_cast<size_t>(width), planeWords * 64 };
 		}
 
-		return { result };
-	}
+		// Every cell of the volume, padding included
+		vector<uint64_t> all() const {
+			Volume full = *this;
+			fill(full.bits.begin(), full.bits.end(), 0);
+			for (int z = 0; z < depth; z++) {
+				for (int y = 0; y < height; y++) {
+					for (int x = 0; x < width; x++) full.set(x, y, z);
+				}
+			}
+			return full.bits;
+		}
+	};
 
-	void forEachNeighbour(const Voxel& point, const function<void(const Voxel&)>& op) {
-		const auto& [x, y, z] = point;
+	struct Input {
+		Volume cubes;
+	};
 
-		op({ x - 1, y, z });
-		op({ x + 1, y, z });
-		op({ x, y - 1, z });
-		op({ x, y + 1, z });
-		op({ x, y, z - 1 });
-		op({ x, y, z + 1 });
-	}
+	shared_ptr<const Input> parse(string_view text) {
+		Splitter inputLines(text);
+		vector<Voxel> cells;
+
+		// e.g. 2,2,2
+		string_view line, coord;
+		while (inputLines.next(line)) {
+			Splitter coords(line, ',');
+			coords.next(coord);
+			int x = parseNumber<int>(coord);
+			coords.next(coord);
+			int y = parseNumber<int>(coord);
+			coords.next(coord);
+			int z = parseNumber<int>(coord);
+
+			cells.push_back({ x, y, z });
+		}
 
-	void part1() {
-		Shape shape = readShape();
-		const auto& cells = shape.cells;
+		return make_shared<Input>(Input{ Volume(cells) });
+	}
 
-		int openFaces = 0;
-		for (const auto& point : cells) {
-			forEachNeighbour(point, [&](const auto& neighbour) {
-				if (!cells.contains(neighbour)) openFaces++;
-			});
+	// Faces of cells in `from` whose neighbour is in `to`, or with complement, isn't in it
+	size_t touchingFaces(const Volume& volume, const vector<uint64_t>& from, const vector<uint64_t>& to, bool complement) {
+		size_t n = volume.words();
+		vector<uint64_t> neighbours(n);
+		size_t faces = 0;
+		for (size_t step : volume.steps()) {
+			for (bool up : { true, false }) {
+				if (up) simd::shiftUp(to.data(), neighbours.data(), n, step);
+				else simd::shiftDown(to.data(), neighbours.data(), n, step);
+				if (complement) simd::andNotMasks(from.data(), neighbours.data(), neighbours.data(), n);
+				else simd::andMasks(from.data(), neighbours.data(), neighbours.data(), n);
+				faces += simd::popcount(neighbours.data(), n);
+			}
 		}
+		return faces;
+	}
 
-		cout << "Open faces: " << openFaces << endl; // 3448
+	string solve1(const Input& input) {
+		const Volume& cubes = input.cubes;
+		// faces whose neighbour isn't a cube
+		size_t openFaces = touchingFaces(cubes, cubes.bits, cubes.bits, true);
+
+		return to_string(openFaces); // 3448
 	}
 
 	/* various options of different complexity:
@@ -85,48 +135,42 @@ namespace day18 {
 	*		Gets complex tracking surfaces/if two faces on adjacent cubes count as joined or not (no diagnoal cube separating them)
 	* 3. Bound space around the shape, add a buffer, and fill with a space-filling 'steam' shape.
 	*		Then either count internal faces of trivial 'steam' object, or faces of shape facing the steam
+	*
+	* Doing 3, growing the steam a step in every direction at once across the whole volume until it stops growing.
+	* Shifts also carry bits from the end of one row or plane to the start of the next, but only ever from padding to padding,
+	* which is all steam anyway.
 	*/
-	void part2() {
-		Shape shape = readShape();
-		const auto& cells = shape.cells;
-
-		// build bounding shape with 1 cell padding
-		int xmin = shape.xmin - 1;
-		int xmax = shape.xmax + 1;
-		int ymin = shape.ymin - 1;
-		int ymax = shape.ymax + 1;
-		int zmin = shape.zmin - 1;
-		int zmax = shape.zmax + 1;
-
-		// build filling shape
-		set<Voxel> filledSpace{ { xmin, ymin, zmin } }; // initial cell
-		vector<Voxel> queue = { {xmin, ymin, zmin} };
-
-		while (!queue.empty()) {
-			Voxel point = queue.back(); queue.pop_back();
-			forEachNeighbour(point, [&](const auto& neighbour) {
-				const auto& [x, y, z] = neighbour;
-				if (x < xmin || x > xmax || y < ymin || y > ymax || z < zmin || z > zmax) return;
-
-				if (cells.contains(neighbour) || filledSpace.contains(neighbour)) return;
-
-				filledSpace.insert(neighbour);
-				queue.push_back(neighbour);
-			});
-		}
+	string solve2(const Input& input) {
+		const Volume& cubes = input.cubes;
+		size_t n = cubes.words();
+		if (n == 0) return "0";
+
+		// anywhere not a cube
+		vector<uint64_t> space = cubes.all();
+		simd::andNotMasks(space.data(), cubes.bits.data(), space.data(), n);
+
+		vector<uint64_t> steam(n, 0);
+		steam[0] = 1; // corner of the padding
+		vector<uint64_t> grown(n), neighbours(n);
+		size_t filled = 1;
+		while (true) {
+			grown = steam;
+			for (size_t step : cubes.steps()) {
+				simd::shiftUp(steam.data(), neighbours.data(), n, step);
+				simd::orMasks(grown.data(), neighbours.data(), grown.data(), n);
+				simd::shiftDown(steam.data(), neighbours.data(), n, step);
+				simd::orMasks(grown.data(), neighbours.data(), grown.data(), n);
+			}
+			simd::andMasks(grown.data(), space.data(), steam.data(), n);
 
-		// having identified filled space, now check touching neighbours
-		int openFaces = 0;
-		for (const auto& point : cells) {
-			forEachNeighbour(point, [&](const auto& neighbour) {
-				if (filledSpace.contains(neighbour)) openFaces++;
-			});
+			size_t count = simd::popcount(steam.data(), n);
+			if (count == filled) break;
+			filled = count;
 		}
 
-		cout << "Open faces: " << openFaces << endl; // 2052
-	}
+		// having identified filled space, now check touching neighbours
+		size_t openFaces = touchingFaces(cubes, cubes.bits, steam, false);
 
-	void main() {
-		part2();
+		return to_string(openFaces); // 2052
 	}
 }
@@ -1,11 +1,18 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <numeric>
 #include <algorithm>
+#include <memory>
+
+#include "Input.h"
+#include "Trace.h"
+#include "SearchStats.h"
+#include "Scanner.h"
+#include "Output.h"
+#include "Parallel.h"
 
 using namespace std;
 
@@ -211,7 +218,11 @@ namespace day19 {
 		}
 
 		void search(map<Resource, int>& miners, map<Resource, int>& resources, int timeRemaining, int& bestScore) const {
-			if (upperBoundScore(miners, resources, timeRemaining) <= bestScore) return; // not going to find better result
+			if (upperBoundScore(miners, resources, timeRemaining) <= bestScore) { // not going to find better result
+				SEARCH_STAT(pruned);
+				return;
+			}
+			SEARCH_STAT(expanded);
 
 			// consider each possible choice for next miner to build
 			bool terminal = true;
@@ -241,44 +252,75 @@ namespace day19 {
 				int score = resources[GEODE] + miners[GEODE] * timeRemaining;
 				if (score > bestScore) {
 					bestScore = score;
+					SEARCH_STAT(improvements);
 				}
 			}
 		}
 	};
 
-	vector<Blueprint> readBlueprints() {
-		ifstream input{ "Day19.txt" };
+	struct Input {
 		vector<Blueprint> blueprints;
+	};
 
-		string line;
-		while (getline(input, line)) {
-			istringstream iss{ line };
+	shared_ptr<const Input> parse(string_view text) {
+		Splitter inputLines(text);
+		auto input = make_shared<Input>();
+		vector<Blueprint>& blueprints = input->blueprints;
 
-			int id, oreRobotOreCost, clayRobotOreCost, obsidianRobotOreCost, obsidianRobotClayCost, geodeRobotOreCost, geodeRobotObsidianCost;
+		string_view line;
+		while (inputLines.next(line)) {
+			Scanner blueprint(line);
 
-			iss.ignore(strlen("Blueprint "));
-			iss >> id;
+			blueprint.expect("Blueprint ");
+			int id = blueprint.number<int>();
 
-			iss.ignore(strlen(": Each ore robot costs "));
-			iss >> oreRobotOreCost;
+			blueprint.expect(": Each ore robot costs ");
+			int oreRobotOreCost = blueprint.number<int>();
 
-			iss.ignore(strlen(" ore. Each clay robot costs "));
-			iss >> clayRobotOreCost;
+			blueprint.expect(" ore. Each clay robot costs ");
+			int clayRobotOreCost = blueprint.number<int>();
 
-			iss.ignore(strlen(" ore. Each obsidian robot costs "));
-			iss >> obsidianRobotOreCost;
-			iss.ignore(strlen(" ore and "));
-			iss >> obsidianRobotClayCost;
+			blueprint.expect(" ore. Each obsidian robot costs ");
+			int obsidianRobotOreCost = blueprint.number<int>();
+			blueprint.expect(" ore and ");
+			int obsidianRobotClayCost = blueprint.number<int>();
 
-			iss.ignore(strlen(" clay. Each geode robot costs "));
-			iss >> geodeRobotOreCost;
-			iss.ignore(strlen(" ore and "));
-			iss >> geodeRobotObsidianCost;
+			blueprint.expect(" clay. Each geode robot costs ");
+			int geodeRobotOreCost = blueprint.number<int>();
+			blueprint.expect(" ore and ");
+			int geodeRobotObsidianCost = blueprint.number<int>();
 
 			blueprints.emplace_back(Blueprint(id, oreRobotOreCost, clayRobotOreCost, obsidianRobotOreCost, obsidianRobotClayCost, geodeRobotOreCost, geodeRobotObsidianCost));
 		}
 
-		return blueprints;
+		return input;
+	}
+
+	// Best number of geodes for each of the first count blueprints, searched in parallel since they're independent
+	vector<int> bestScores(const vector<Blueprint>& blueprints, size_t count, int minutes) {
+		vector<int> scores(count, 0);
+		vector<SearchStats> stats(count);
+		parallel::forEach<size_t>(0, count, [&](size_t i) {
+			const Blueprint& blueprint = blueprints[i];
+			map<Resource, int> initialResources;
+			map<Resource, int> initialMiners = { {ORE, 1} };
+			stats[i] = countSearch([&]() {
+				TRACE_SCOPE_ARG("Blueprint::search", "id", blueprint.id);
+				blueprint.search(initialMiners, initialResources, minutes, scores[i]);
+			});
+		}, 1);
+
+		// reported once all are done, so the output stays in order
+		for (size_t i = 0; i < count; i++) {
+			searchStats() += stats[i];
+			DAY_LOG(DETAIL) << "Blueprint id=" << blueprints[i].id << endl;
+			// at the level they were always printed at before, so naming the blueprint, whose other lines are more detail
+			if constexpr (searchStatsCompiledIn) {
+				DAY_LOG(SUMMARY) << "Search for blueprint " << blueprints[i].id << ": " << stats[i] << endl;
+			}
+			DAY_LOG(DETAIL) << "High score=" << scores[i] << endl;
+		}
+		return scores;
 	}
 
 	/*
@@ -286,22 +328,16 @@ namespace day19 {
 		1. Making actions reversible to avoid copying maps: at least 10x faster (enough to solve in reasonable time)
 		2. upper bounding score, to prune search early: another ~10x faster, solves part 1 in a couple seconds.
 	*/
-	void part1() {
-		vector<Blueprint> blueprints = readBlueprints();
-		int totalQuality = 0;
+	string solve1(const Input& input) {
+		const vector<Blueprint>& blueprints = input.blueprints;
+		vector<int> scores = bestScores(blueprints, blueprints.size(), 24);
 
-		for (const auto& blueprint : blueprints) {
-			cout << "Blueprint id=" << blueprint.id << endl;
-			int bestScore = 0;
-			map<Resource, int> initialResources;
-			map<Resource, int> initialMiners = { {ORE, 1} };
-			blueprint.search(initialMiners, initialResources, 24, bestScore);
-			int quality = bestScore * blueprint.id;
-			cout << "High score=" << bestScore << ", quality=" << quality << endl;
-			totalQuality += quality;
+		int totalQuality = 0;
+		for (size_t i = 0; i < blueprints.size(); i++) {
+			totalQuality += scores[i] * blueprints[i].id;
 		}
 
-		cout << "Total quality: " << totalQuality << endl; // 1266
+		return to_string(totalQuality); // 1266
 	}
 
 	/*
@@ -310,32 +346,13 @@ namespace day19 {
 		Can stop making any more of miner X once we have N = greatest requirement of X for any miner.
 		After that, again only takes a couple seconds.
 	*/
-	void part2() {
-		vector<Blueprint> blueprints = readBlueprints();
+	string solve2(const Input& input) {
 		int total = 1;
-
-		for (int i = 0; i < 3; i++) {
-			const Blueprint& blueprint = blueprints[i];
-			cout << "Blueprint id=" << blueprint.id << endl;
-
-			time_t start, end;
-			time(&start);
-			int bestScore = 0;
-			map<Resource, int> initialResources;
-			map<Resource, int> initialMiners = { {ORE, 1} };
-			blueprint.search(initialMiners, initialResources, 32, bestScore);
-			time(&end);
-
-			cout << "Blueprint " << blueprint.id << " took " << (double)(end - start) << endl;
-
-			total *= bestScore;
+		for (int score : bestScores(input.blueprints, 3, 32)) {
+			total *= score;
 		}
 
-		cout << "Product of first 3 scores: " << total << endl; // 5800
-	}
-
-	void main() {
-		part2();
+		return to_string(total); // 5800
 	}
 }
 
@@ -1,16 +1,20 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
+#include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm> // sort
 #include <map>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+
+#include "Input.h"
+#include "StreamInput.h"
 
 using namespace std;
 
 enum RPS { rock, paper, scissors };
 
-map<char, RPS> decodeRPS{
+const map<char, RPS> decodeRPS{
     {'A', rock}, {'B', paper}, {'C', scissors },
     {'X', rock}, {'Y', paper}, {'Z', scissors },
 };
@@ -56,53 +60,72 @@ RPS decodePart2(RPS& theirs, char outcome) {
 
 namespace day2 {
 
+    int score1(char theirMove, char ourMove) {
+        // array-style decodeRPS[key] does a default/zero insert if not already present, rather than throwing. 
+        // Instead use decodeRPS.at(key)
+        RPS theirs = decodeRPS.at(theirMove);
+        RPS mine = decodeRPS.at(ourMove);
+        return RpsResult(mine, theirs) + RpsValue(mine);
+    }
+
+    int score2(char theirMove, char outcome) {
+        RPS theirs = decodeRPS.at(theirMove);
+        RPS mine = decodePart2(theirs, outcome);
+        return RpsResult(mine, theirs) + RpsValue(mine);
+    }
 
-    void part1()
+    // each round is their move then our column ('X', 'Y' or 'Z'), interpreted differently by each part
+    struct Input {
+        vector<pair<char, char>> rounds;
+    };
+
+    shared_ptr<const Input> parse(string_view text)
     {
-        ifstream input("Day2.txt");
-        int total = 0;
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
 
-        string line;
-        // getline returns the passed input stream,
-        // io evaulates to true as long as neither failbit or badbit set, get updated by reading (e.g. EOF)
-        while (getline(input, line)) {
-            // array-style decodeRPS[key] does a default/zero insert if not already present, rather than throwing. 
-            // Instead use decodeRPS.at(key)
-            RPS theirs = decodeRPS.at(line[0]);
-            RPS mine = decodeRPS.at(line[2]);
-            total += RpsResult(mine, theirs) + RpsValue(mine);
+        string_view line;
+        while (inputLines.next(line)) {
+            input->rounds.push_back({ line[0], line[2] });
         }
 
-        cout << total << endl; // 14264
+        return input;
     }
 
-    void part2()
+    string solve1(const Input& input)
     {
-        ifstream input("Day2.txt");
         int total = 0;
 
-        string line;
-        // getline returns the passed input stream,
-        // io evaulates to true as long as neither failbit or badbit set, get updated by reading (e.g. EOF)
-        while (getline(input, line)) {
-            // array-style decodeRPS[key] does a default/zero insert if not already present, rather than throwing. 
-            // Instead use decodeRPS.at(key)
-            RPS theirs = decodeRPS.at(line[0]);
-            RPS mine = decodePart2(theirs, line[2]);
-            total += RpsResult(mine, theirs) + RpsValue(mine);
+        for (const auto& [theirMove, ourMove] : input.rounds) {
+            total += score1(theirMove, ourMove);
         }
 
-        cout << total << endl; // 12382
+        return to_string(total); // 14264
     }
 
+    string solve2(const Input& input)
+    {
+        int total = 0;
+
+        for (const auto& [theirMove, outcome] : input.rounds) {
+            total += score2(theirMove, outcome);
+        }
 
-    int main() {
-        part2();
+        return to_string(total); // 12382
+    }
 
-        // wait to close
-        cin.get();
+    pair<string, string> solveStream(StreamInput& in)
+    {
+        int total1 = 0;
+        int total2 = 0;
+
+        string_view line;
+        while (in.nextLine(line)) {
+            total1 += score1(line[0], line[2]);
+            total2 += score2(line[0], line[2]);
+        }
 
-        return 0;
+        return { to_string(total1), to_string(total2) };
     }
 
 }
\ No newline at end of file
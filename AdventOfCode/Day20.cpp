@@ -1,11 +1,15 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <set>
 #include <algorithm>
+#include <memory>
+
+#include "Input.h"
+#include "Trace.h"
+#include "Output.h"
 
 using namespace std;
 
@@ -65,6 +69,15 @@ namespace day20 {
 		}
 	}
 
+	/*
+		Without any improvements, takes about 5s
+		List has 5000 elements.
+		No real change from using rotate()
+			Numbers large enough to effectively be random swaps, so making nearby shift fast instead of 
+			insert/removes near the end of the list doesn't significantly improve performance.
+		Even 'rotating' wrapping around outside only helps marginally, only applicable half of the time,
+			and speedup only significant if 1-r << r (i.e. 40% vs 60% pretty negligible)
+	*/
 	void mix(vector<IndexedInt64>& values) {
 		const int N = static_cast<int>(values.size());
 
@@ -106,58 +119,52 @@ namespace day20 {
 		return v1 + v2 + v3;
 	}
 
-	void part1() {
-		ifstream input{ "Day20.txt" };
+	struct Input {
+		vector<int64_t> values;
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		Tokens words(text);
+		auto input = make_shared<Input>();
+
+		string_view value;
+		while (words.next(value)) input->values.push_back(parseNumber<int64_t>(value));
+
+		return input;
+	}
 
+	vector<IndexedInt64> indexValues(const Input& input, int64_t key) {
 		vector<IndexedInt64> values;
 		int count = 0;
-		int64_t value;
-		while (input >> value) values.push_back({ count++, value });
+		for (int64_t value : input.values) values.push_back({ count++, value * key });
+		return values;
+	}
+
+	string solve1(const Input& input) {
+		vector<IndexedInt64> values = indexValues(input, 1);
 
 		const int N = static_cast<int>(values.size());
 		
-		cout << "Num values: " << N << endl;
+		DAY_LOG(SUMMARY) << "Num values: " << N << endl;
 
-		mix(values);
+		{
+			TRACE_SCOPE_ARG("mix", "iteration", 0);
+			mix(values);
+		}
 
-		cout << getCoordSum(values) << endl; // 8302
+		return to_string(getCoordSum(values)); // 8302
 	}
 
-	void part2() {
-		ifstream input{ "Day20.txt" };
+	string solve2(const Input& input) {
 		const int64_t KEY = 811589153;
 
-		vector<IndexedInt64> values;
-		int count = 0;
-		int64_t value;
-		while (input >> value) values.push_back({ count++, value * KEY });
-
-		const int N = static_cast<int>(values.size());
-
+		vector<IndexedInt64> values = indexValues(input, KEY);
 
 		for (int iteration = 0; iteration < 10; iteration++) {
+			TRACE_SCOPE_ARG("mix", "iteration", iteration);
 			mix(values);
 		}
 
-		cout << getCoordSum(values) << endl; // 656575624777
-	}
-
-	/*
-		Without any improvements, takes about 5s
-		List has 5000 elements.
-		No real change from using rotate()
-			Numbers large enough to effectively be random swaps, so making nearby shift fast instead of 
-			insert/removes near the end of the list doesn't significantly improve performance.
-		Even 'rotating' wrapping around outside only helps marginally, only applicable half of the time,
-			and speedup only significant if 1-r << r (i.e. 40% vs 60% pretty negligible)
-	*/
-	void main() {
-		time_t start, end;
-		time(&start);
-		part1();
-		part2();
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
+		return to_string(getCoordSum(values)); // 656575624777
 	}
 }
\ No newline at end of file
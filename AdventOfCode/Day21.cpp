@@ -1,12 +1,18 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <map>
 #include <vector>
 #include <set>
 #include <algorithm>
 #include <optional>
+#include <memory>
+#include <stdexcept>
+
+#include "Input.h"
+#include "Scanner.h"
+#include "Output.h"
+#include "ParseCache.h"
 
 using namespace std;
 
@@ -71,6 +77,30 @@ namespace day21 {
 			return Monkey(name, op, {}, { left, right });
 		}
 
+		const string& getName() const {
+			return name;
+		}
+
+		// As parsed, i.e. before any values are computed or parents linked
+		void save(cache::Writer& out) const {
+			out.putString(name);
+			out.put(op);
+			if (op == VALUE) out.put(*value);
+			else {
+				out.putString(dependsOn[0]);
+				out.putString(dependsOn[1]);
+			}
+		}
+
+		static Monkey load(cache::Reader& in) {
+			string name{ in.getString() };
+			Op op = in.get<Op>();
+			if (op == VALUE) return fromValue(name, in.get<int64_t>());
+			string left{ in.getString() };
+			string right{ in.getString() };
+			return fromOp(name, op, left, right);
+		}
+
 		int64_t getValue(const map<string, Monkey>& monkeys) const {
 			if (!value) computeValue(monkeys);
 			return *value;
@@ -159,27 +189,29 @@ namespace day21 {
 		}
 	};
 
-	map<string, Monkey> readMonkeys(ifstream& input) {
+	map<string, Monkey> readMonkeys(string_view text) {
 		map<string, Monkey> monkeys;
 
-		string line;
-		while (getline(input, line)) {
-			istringstream iss{ line };
+		Splitter inputLines(text);
+		string_view line;
+		while (inputLines.next(line)) {
+			Scanner monkeyLine(line);
 
+			// 'root: pppw + sjmn' or 'dbpl: 5'
+			string name{ monkeyLine.until(':') };
+			monkeyLine.expect(": ");
 
-			string name;
-			getline(iss, name, ':');
-			iss >> ws;
-
-			if (isdigit(iss.peek())) {
-				int64_t value;
-				iss >> value;
+			int64_t value;
+			if (monkeyLine.tryNumber(value)) {
 				monkeys.emplace(name, Monkey::fromValue(name, value));
 			}
 			else {
-				string left, right;
-				char op;
-				iss >> left >> op >> right;
+				string left{ monkeyLine.until(' ') };
+				monkeyLine.expect(" ");
+				char op = monkeyLine.peek();
+				monkeyLine.skip();
+				monkeyLine.expect(" ");
+				string right{ monkeyLine.rest() };
 				monkeys.emplace(name, Monkey::fromOp(name, opFromChar(op), left, right));
 			}
 		}
@@ -187,20 +219,38 @@ namespace day21 {
 		return monkeys;
 	}
 
-	void part1() {
-		ifstream input{ "Day21.txt" };
-		if (!input) throw invalid_argument("Failed to open Day21.txt");
+	struct Input {
+		map<string, Monkey> monkeys;
+	};
 
-		map<string, Monkey> monkeys = readMonkeys(input);
+	shared_ptr<const Input> parse(string_view text) {
+		return make_shared<Input>(Input{ readMonkeys(text) });
+	}
 
-		cout << "Root monkey shouts: " << monkeys.at("root").getValue(monkeys) << endl; // 21208142603224
+	void save(const Input& input, cache::Writer& out) {
+		out.put<uint64_t>(input.monkeys.size());
+		for (const auto& [_, monkey] : input.monkeys) monkey.save(out);
+	}
+
+	shared_ptr<const Input> load(cache::Reader& in) {
+		auto input = make_shared<Input>();
+		for (uint64_t n = in.get<uint64_t>(); n > 0; n--) {
+			Monkey monkey = Monkey::load(in);
+			string name = monkey.getName();
+			input->monkeys.emplace_hint(input->monkeys.end(), name, std::move(monkey));
+		}
+		return input;
 	}
 
-	void part2() {
-		ifstream input{ "Day21.txt" };
-		if (!input) throw invalid_argument("Failed to open Day21.txt");
+	string solve1(const Input& input) {
+		// copy, as monkeys cache their values once computed
+		map<string, Monkey> monkeys = input.monkeys;
 
-		map<string, Monkey> monkeys = readMonkeys(input);
+		return to_string(monkeys.at("root").getValue(monkeys)); // 21208142603224
+	}
+
+	string solve2(const Input& input) {
+		map<string, Monkey> monkeys = input.monkeys;
 
 		// link parents
 		for (const auto& [_, monkey] : monkeys) monkey.linkFromDependents(monkeys);
@@ -211,21 +261,12 @@ namespace day21 {
 			size_t parents = monkey.getNumParents();
 			if (parents > 1) throw invalid_argument(name + " has " + to_string(parents) + " parent nodes. DAG not tree");
 		}
-		cout << "Graph is a tree" << endl;
+		DAY_LOG(SUMMARY) << "Graph is a tree" << endl;
 
 		monkeys.at("root").setOp(EQUALS);
 		const Monkey& human = monkeys.at("humn");
 		int64_t humanValue = human.solveForThis(monkeys);
 
-		cout << "Correct leaf value: " << humanValue << endl; // 3882224466191
-	}
-
-	void main() {
-		time_t start, end;
-		time(&start);
-		part2();
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
+		return to_string(humanValue); // 3882224466191
 	}
 }
\ No newline at end of file
@@ -1,16 +1,22 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <map>
+#include <string_view>
+#include <charconv>
+#include <array>
 #include <vector>
-#include <set>
 #include <algorithm>
 #include <cassert>
 #include <stdexcept>
+#include <memory>
+#include <limits>
 
 #include "Point.h"
 #include "Point3.h"
+#include "Input.h"
+#include "Output.h"
+#include "Grid2D.h"
+#include "ParseCache.h"
+#include "Dispatch.h"
 
 using namespace std;
 
@@ -41,9 +47,7 @@ namespace day22 {
 		return result;
 	}
 
-	const int TILE_SIZE = 50;
-	
-	// 0 <= original.x, y < TILE_SIZE
+	// 0 <= original.x, y < tile size
 	Point3 mapRelativeFacePointToCube(const Point<int>& original, const Face& netFace, const Face& cubeFace, const Line& edge) {
 		// work out coordinates in terms of face directions, then apply those to mapped face
 		assert(netFace.numPoints() == 4);
@@ -108,9 +112,24 @@ namespace day22 {
 			: UP;
 	}
 
-	Face getSharedFace(const Face& f, const Line& edge, const map<Face, Face>& cubeToNetFaces) {
-		const Face* newCubeFace = nullptr;
-		for (const auto& [cubeFace, _] : cubeToNetFaces) {
+	const int FACES = 6;
+
+	// Each face of the folded cube, alongside the face of the net it came from.
+	// Only 6 of them, so searching is quicker than a map, and needs no allocation.
+	struct CubeNet {
+		array<Face, FACES> cube;
+		array<Face, FACES> net;
+
+		const Face& netFace(const Face& cubeFace) const {
+			for (int i = 0; i < FACES; i++) {
+				if (cube[i] == cubeFace) return net[i];
+			}
+			throw invalid_argument("Not a face of the cube");
+		}
+	};
+
+	const Face& getSharedFace(const Face& f, const Line& edge, const CubeNet& cubeNet) {
+		for (const Face& cubeFace : cubeNet.cube) {
 			if (f.touches(cubeFace) == edge) {
 				return cubeFace;
 			}
@@ -128,58 +147,104 @@ namespace day22 {
 	Hence can track xmin/max for each row, and ymin/max for each column.
 	*/
 	class Grid {
+	private:
+		// Board is 1-indexed, stored from (0, 0), with a border of OFF_MAP
+		Grid2D<char> tiles;
+
 	public:
-		// false = empty tile, true = wall, absent = off of map
-		map<Point<int>, bool> walls {};
-		map<int, int> rowXMin;
-		map<int, int> rowXMax;
-		map<int, int> colYMin;
-		map<int, int> colYMax;
+		static const char OPEN = '.';
+		static const char WALL = '#';
+		static const char OFF_MAP = ' ';
 
-		void setTile(int x, int y, bool wall) {
-			walls[{x, y}] = wall;
+		// indexed by row/column number, only set for those with any tiles
+		vector<int> rowXMin;
+		vector<int> rowXMax;
+		vector<int> colYMin;
+		vector<int> colYMax;
+
+		Grid() = default;
 
-			// careful to avoid inserting default 0 values
-			if (rowXMin.contains(y)) rowXMin[y] = min(rowXMin[y], x);
-			else rowXMin[y] = x;
+		Grid(int width, int height) : tiles(width, height, OFF_MAP, 1, OFF_MAP),
+			rowXMin(height + 1, numeric_limits<int>::max()), rowXMax(height + 1, 0),
+			colYMin(width + 1, numeric_limits<int>::max()), colYMax(width + 1, 0) {}
 
-			if (rowXMax.contains(y)) rowXMax[y] = max(rowXMax[y], x);
-			else rowXMax[y] = x;
+		int width() const {
+			return tiles.width();
+		}
 
-			if (colYMin.contains(x)) colYMin[x] = min(colYMin[x], y);
-			else colYMin[x] = y;
+		int height() const {
+			return tiles.height();
+		}
 
-			if (colYMax.contains(x)) colYMax[x] = max(colYMax[x], y);
-			else colYMax[x] = y;
+		// Anything just off the edge of the board is OFF_MAP
+		char tile(const Point<int>& p) const {
+			return tiles(p.x - 1, p.y - 1);
 		}
 
-		Point<int> move(const Point<int>& p, const Direction d, int steps) {
+		void save(cache::Writer& out) const {
+			out.put(width());
+			out.put(height());
+			for (int y = 0; y < height(); y++) out.putSpan(tiles.row(y));
+			out.putVector(rowXMin);
+			out.putVector(rowXMax);
+			out.putVector(colYMin);
+			out.putVector(colYMax);
+		}
+
+		static Grid load(cache::Reader& in) {
+			int width = in.get<int>();
+			int height = in.get<int>();
+			// each row is its length then its tiles, so a corrupt size is caught before allocating for it
+			uint64_t rowBytes = sizeof(uint64_t) + static_cast<uint64_t>(max(width, 0));
+			if (width < 0 || height < 0 || static_cast<uint64_t>(height) > in.remaining() / rowBytes) {
+				throw invalid_argument("Cache file has the wrong grid size");
+			}
+			Grid grid(width, height);
+			for (int y = 0; y < height; y++) in.getSpan(grid.tiles.row(y));
+			grid.rowXMin = in.getVector<int>();
+			grid.rowXMax = in.getVector<int>();
+			grid.colYMin = in.getVector<int>();
+			grid.colYMax = in.getVector<int>();
+			return grid;
+		}
+
+		void setTile(int x, int y, bool wall) {
+			tiles(x - 1, y - 1) = wall ? WALL : OPEN;
+
+			rowXMin[y] = min(rowXMin[y], x);
+			rowXMax[y] = max(rowXMax[y], x);
+			colYMin[x] = min(colYMin[x], y);
+			colYMax[x] = max(colYMax[x], y);
+		}
+
+		Point<int> move(const Point<int>& p, const Direction d, int steps) const {
 			Point<int> result = p;
 			while (steps--) {
 				Point<int> next = day22::move(result, d);
-				if (walls.contains(next)) {
-					if (walls.at(next)) return result;
+				char nextTile = tile(next);
+				if (nextTile != OFF_MAP) {
+					if (nextTile == WALL) return result;
 					else result = next;
 				}
 				else {
 					// wrap around
 					switch (d) {
 					case RIGHT:
-						next.x = rowXMin[p.y];
+						next.x = rowXMin.at(p.y);
 						break;
 
 					case DOWN:
-						next.y = colYMin[p.x];
+						next.y = colYMin.at(p.x);
 						break;
 					case LEFT:
-						next.x = rowXMax[p.y];
+						next.x = rowXMax.at(p.y);
 						break;
 					case UP:
-						next.y = colYMax[p.x];
+						next.y = colYMax.at(p.x);
 						break;
 					}
-					assert(walls.contains(next));
-					if (walls[next]) return result;
+					assert(tile(next) != OFF_MAP);
+					if (tile(next) == WALL) return result;
 					else result = next;
 				}
 			}
@@ -189,12 +254,12 @@ namespace day22 {
 
 		tuple<Point<int>, Direction, Face> getNewCoords(
 			const Point<int> pointOnBoundary, const Face& cubeFace, const Face& flatFace,
-			const Line& cubeEdgeCrossed, const map<Face, Face>& cubeToFlatFace)
+			const Line& cubeEdgeCrossed, const CubeNet& cubeNet) const
 		{
 			const Point3 cubePoint = mapRelativeFacePointToCube(pointOnBoundary, flatFace, cubeFace, cubeEdgeCrossed);
 			
-			const Face newCubeFace = getSharedFace(cubeFace, cubeEdgeCrossed, cubeToFlatFace);
-			const auto& newFlatFace = cubeToFlatFace.at(newCubeFace);
+			const Face& newCubeFace = getSharedFace(cubeFace, cubeEdgeCrossed, cubeNet);
+			const auto& newFlatFace = cubeNet.netFace(newCubeFace);
 
 			Point<int> newFacePoint = mapCubePointToCoordsInFace(cubePoint, newCubeFace, newFlatFace, cubeEdgeCrossed.reversed());
 
@@ -208,14 +273,14 @@ namespace day22 {
 			const Point<int>& originalPoint, const Point<int>& newPoint,
 			const Direction& originalDir, const Direction& newDir,
 			const Face& originalFace, const Face& newFace,
-			map<Face, Face>& cubeToFlatFace)
+			const CubeNet& cubeNet) const
 		{
-			const auto& newFlatFace = cubeToFlatFace.at(newFace);
+			const auto& newFlatFace = cubeNet.netFace(newFace);
 			Point3 netPoint3 = newFlatFace[0] + newPoint;
 			assert(netPoint3.z == 0);
 			Point<int> netPoint = { netPoint3.x, netPoint3.y };
-			assert(walls.contains(netPoint));
-			if (walls.at(netPoint)) return { originalPoint, originalDir, originalFace };
+			assert(tile(netPoint) != OFF_MAP);
+			if (tile(netPoint) == WALL) return { originalPoint, originalDir, originalFace };
 			else return { newPoint, newDir, newFace };
 		}
 		
@@ -223,9 +288,12 @@ namespace day22 {
 		// e.g. (0,0,0) could be on any of 3 faces.
 		// Both current Face and Direction on a face can change while moving.
 		// args: 'p' and 'd' are as if looking at flat map (coords on flat face), face is the actual face on the cube
-		tuple<Point<int>, Direction, Face> moveOnCube(const Point<int>& p, const Direction d, const Face& face, map<Face, Face>& cubeToFlatFace) {
+		// Specialised on the tile size (see Dispatch.h), which is the same for every move.
+		template <int TILE_SIZE>
+		tuple<Point<int>, Direction, Face> moveOnCube(const Point<int>& p, const Direction d, const Face& face, const CubeNet& cubeNet, int tileSize) const {
+			const int size = fixedOr<TILE_SIZE>(tileSize);
 			const Point<int>& next = day22::move(p, d);
-			const auto& flatFace = cubeToFlatFace.at(face);
+			const auto& flatFace = cubeNet.netFace(face);
 
 			Line edgeCrossed = Line::NONE;
 
@@ -233,30 +301,31 @@ namespace day22 {
 			if (next.x < 0) {
 				edgeCrossed = { face[0], face[1] };
 			}
-			else if (next.x >= TILE_SIZE) {
+			else if (next.x >= size) {
 				edgeCrossed = { face[2], face[3] };
 			}
 			else if (next.y < 0) {
 				edgeCrossed = { face[3], face[0] };
 			}
-			else if (next.y >= TILE_SIZE) {
+			else if (next.y >= size) {
 				edgeCrossed ={ face[1], face[2] };
 			}
 
 			if (edgeCrossed != Line::NONE) {
-				const auto& [newP, newDir, newFace] = getNewCoords(p, face, flatFace, edgeCrossed, cubeToFlatFace);
-				return getNewPointIfNoWall(p, newP, d, newDir, face, newFace, cubeToFlatFace);
+				const auto& [newP, newDir, newFace] = getNewCoords(p, face, flatFace, edgeCrossed, cubeNet);
+				return getNewPointIfNoWall(p, newP, d, newDir, face, newFace, cubeNet);
 			} else {
 				// simple case, just check if that tile is free
-				return getNewPointIfNoWall(p, next, d, d, face, face, cubeToFlatFace);
+				return getNewPointIfNoWall(p, next, d, d, face, face, cubeNet);
 			}
 		}
 
-		tuple<Point<int>, Direction, Face> moveOnCube(const Point<int>& p, const Direction d, const Face& face, map<Face, Face>& cubeToFlatFace, int steps) {
+		template <int TILE_SIZE>
+		tuple<Point<int>, Direction, Face> moveOnCube(const Point<int>& p, const Direction d, const Face& face, const CubeNet& cubeNet, int tileSize, int steps) const {
 			tuple<Point<int>, Direction, Face> result = { p, d, face };
 			while (steps--) {
 				auto& [curP, curD, curF] = result;
-				tuple<Point<int>, Direction, Face> next = moveOnCube(curP, curD, curF, cubeToFlatFace);
+				tuple<Point<int>, Direction, Face> next = moveOnCube<TILE_SIZE>(curP, curD, curF, cubeNet, tileSize);
 				if (next == result) return result; // hit wall, return early
 				else result = next;
 			}
@@ -264,12 +333,19 @@ namespace day22 {
 		}
 	};
 
-	Grid readGrid(ifstream& input) {
-		Grid grid;
+	Grid readGrid(Splitter& input) {
+		vector<string_view> lines;
+		size_t width = 0;
+		string_view line;
+		while (input.next(line) && line.length() > 0) {
+			lines.push_back(line);
+			width = max(width, line.size());
+		}
+
+		Grid grid(static_cast<int>(width), static_cast<int>(lines.size()));
 
 		int y = 0;
-		string line;
-		while (getline(input, line) && line.length() > 0) {
+		for (string_view line : lines) {
 			y++;
 			int x = 0;
 			for (char c : line) {
@@ -294,51 +370,78 @@ namespace day22 {
 
 	// Returns final facing direction
 	template <typename Step>
-	Direction runCommands(ifstream& input, Step step) {
-		string commands;
-		getline(input, commands);
-		istringstream commandStream{ commands };
+	Direction runCommands(string_view commands, Step step) {
+		const char* pos = commands.data();
+		const char* end = pos + commands.size();
 
 		Direction dir = RIGHT;
-		char next;
-		while ((next = commandStream.peek()) != EOF) {
+		while (pos != end) {
+			char next = *pos;
 			if (next == 'L') {
 				dir = static_cast<Direction>((dir + 3) % 4);
-				commandStream.get();
+				pos++;
 				continue;
 			}
 			else if (next == 'R') {
 				dir = static_cast<Direction>((dir + 1) % 4);
-				commandStream.get();
+				pos++;
 				continue;
 			}
 			else {
 				int steps;
-				commandStream >> steps;
+				auto [stepsEnd, ec] = from_chars(pos, end, steps);
+				if (ec != errc()) throw invalid_argument("Unexpected command: " + string(pos, end));
+				pos = stepsEnd;
 				dir = step(dir, steps);
 			}
 		}
 		return dir;
 	}
 
-	Point<int> startPoint(Grid& grid) {
+	Point<int> startPoint(const Grid& grid) {
 		int y = 1;
-		int x = grid.rowXMin[y];
+		int x = grid.rowXMin.at(y);
 		Point<int> p{ x, y };
 		// first available tile on top row
-		while (grid.walls.at(p)) p.x++;
+		while (grid.tile(p) == Grid::WALL) p.x++;
 		return p;
 	}
 
-	void part1() {
-		ifstream input{ "Day22.txt" };
-		if (!input) throw invalid_argument("Failed to open Day22.txt");
+	struct Input {
+		Grid grid;
+		string commands;
+	};
 
-		Grid grid = readGrid(input);
+	shared_ptr<const Input> parse(string_view text) {
+		Splitter inputLines(text);
+		auto input = make_shared<Input>();
+
+		input->grid = readGrid(inputLines);
+		string_view commands;
+		inputLines.next(commands);
+		input->commands = commands;
+
+		return input;
+	}
+
+	void save(const Input& input, cache::Writer& out) {
+		input.grid.save(out);
+		out.putString(input.commands);
+	}
+
+	shared_ptr<const Input> load(cache::Reader& in) {
+		auto input = make_shared<Input>();
+		input->grid = Grid::load(in);
+		input->commands = in.getString();
+		return input;
+	}
+
+	string solve1(const Input& input) {
+		const Grid& grid = input.grid;
 
 		Point<int> p = startPoint(grid);
 		
-		Direction finalDir = runCommands(input, [&](Direction dir, int steps) {
+		Direction finalDir = runCommands(input.commands, [&](Direction dir, int steps) {
 			p = grid.move(p, dir, steps);
 			return dir;
 		});
@@ -346,10 +449,10 @@ namespace day22 {
 		// 1000 times the row, 4 times the column, and the facing.
 		int result = 1000 * p.y + 4 * p.x + static_cast<int>(finalDir);
 
-		cout << result << endl; // 109094
+		return to_string(result); // 109094
 	}
 
-	void checkIsCube(const vector<Face>& faces) {
+	void checkIsCube(const array<Face, FACES>& faces) {
 		for (const auto& f1 : faces) {
 			int touching = 0;
 			for (const auto& f2 : faces) {
@@ -358,49 +461,46 @@ namespace day22 {
 			}
 			if (touching != 4) throw invalid_argument("Appears to not be a cube, expected each face to have 4 neighbours at end");
 		}
-		cout << "Faces form a cube:" << endl;
-		for (auto const& f : faces) cout << "  " << f << endl;
+		DAY_LOG(DETAIL) << "Faces form a cube:" << endl;
+		for (auto const& f : faces) DAY_LOG(DETAIL) << "  " << f << endl;
 	}
 
-	void treeFromNet(const map<Face, Face>& netToCubeMapping, const Face& netFace, const Face* lastNetFace, map<Face, set<Face>>& dependents, set<Face>& visited) {
-		assert(!visited.contains(netFace)); // guard against loops, and ensure whole net gets explored
-		visited.insert(netFace);
+	// [parent][child] for the tree of faces spanning the net, by index of each face
+	typedef array<array<bool, FACES>, FACES> Dependents;
+
+	void treeFromNet(const array<Face, FACES>& cubeFaces, int face, int parent, Dependents& dependents, array<bool, FACES>& visited) {
+		assert(!visited[face]); // guard against loops, and ensure whole net gets explored
+		visited[face] = true;
 
-		const auto& cubeFace = netToCubeMapping.at(netFace);
-		for (const auto& [netF2, cubeF2] : netToCubeMapping) {
-			if (netFace == netF2 || (lastNetFace != nullptr && *lastNetFace == netF2)) continue; // same face, or parent we just came from
+		for (int f2 = 0; f2 < FACES; f2++) {
+			if (f2 == face || f2 == parent) continue; // same face, or parent we just came from
 
-			Line match = cubeFace.touches(cubeF2);
+			Line match = cubeFaces[face].touches(cubeFaces[f2]);
 			if (match == Line::NONE) continue; // not connected
 
-			dependents[netFace].insert(netF2);
-			treeFromNet(netToCubeMapping, netF2, &netFace, dependents, visited);
+			dependents[face][f2] = true;
+			treeFromNet(cubeFaces, f2, face, dependents, visited);
 		}
 	}
 
-	void rotateFaceAndDependents(const Face& netFace, const Line& edge, const map<Face, set<Face>>& netDependents, map<Face, Face>& netToCubeFace) {
-		Face& cubeFace = netToCubeFace.at(netFace);
-		cubeFace = cubeFace.turnAround(edge);
+	void rotateFaceAndDependents(int face, const Line& edge, const Dependents& dependents, array<Face, FACES>& cubeFaces) {
+		cubeFaces[face] = cubeFaces[face].turnAround(edge);
 
-		if (!netDependents.contains(netFace)) return; // leaf node, done.
-		for (const auto& dependent : netDependents.at(netFace)) {
-			rotateFaceAndDependents(dependent, edge, netDependents, netToCubeFace);
+		for (int dependent = 0; dependent < FACES; dependent++) {
+			if (dependents[face][dependent]) rotateFaceAndDependents(dependent, edge, dependents, cubeFaces);
 		}
 	}
 
-	void rotateAndBuildCube(const Face& currentFace, const map<Face, set<Face>>& netDependents, map<Face, Face>& netToCubeFace) {
-		if (!netDependents.contains(currentFace)) return; // leaf node, done.
-		const Face& cubeFace = netToCubeFace.at(currentFace);
-
-		for (const auto& f2 : netDependents.at(currentFace)) {
-			Face& cubeFace2 = netToCubeFace.at(f2);
+	void rotateAndBuildCube(int face, const Dependents& dependents, array<Face, FACES>& cubeFaces) {
+		for (int f2 = 0; f2 < FACES; f2++) {
+			if (!dependents[face][f2]) continue;
 
-			Line edge = cubeFace.touches(cubeFace2);
+			Line edge = cubeFaces[face].touches(cubeFaces[f2]);
 			if (edge == Line::NONE) throw invalid_argument("Connected faces no longer touching?");
 
-			rotateFaceAndDependents(f2, edge, netDependents, netToCubeFace);
+			rotateFaceAndDependents(f2, edge, dependents, cubeFaces);
 
-			rotateAndBuildCube(f2, netDependents, netToCubeFace);
+			rotateAndBuildCube(f2, dependents, cubeFaces);
 		}
 	}
 
@@ -409,14 +509,14 @@ namespace day22 {
 	so need to overlap 1 cell per face. i.e. [1-4][5-8] -> [1-4][4-7]
 	Each face shifted based on top-left corner, with global corner (1,1) remaining constant.
 	*/
-	Face toVoxelCoordinates(const Face& netFace) {
+	constexpr Face toVoxelCoordinates(const Face& netFace, int tileSize) {
 		const Point3& corner = netFace[0];
-		int xOffset = (corner.x - 1) / TILE_SIZE;
-		int yOffset = (corner.y - 1) / TILE_SIZE;
-		vector<Point3> newPoints;
+		int xOffset = (corner.x - 1) / tileSize;
+		int yOffset = (corner.y - 1) / tileSize;
+		array<Point3, Face::SIDES> newPoints;
 		for (int i = 0; i < netFace.numPoints(); i++) {
 			const Point3& p = netFace[i];
-			newPoints.push_back({ p.x - xOffset, p.y - yOffset, 0 });
+			newPoints[i] = { p.x - xOffset, p.y - yOffset, 0 };
 		}
 		return { newPoints };
 	}
@@ -430,111 +530,99 @@ namespace day22 {
 
 		Returns the faces in the same order, but their positions after being folded into a cube
 	*/
-	vector<Face> buildCube(const vector<Face>& originalNet) {
-		// map original -> new faces
-		map<Face, Face> faceMapping;
-		for (const Face& f1 : originalNet) faceMapping.insert({ f1, toVoxelCoordinates(f1) }); // initiall unmodified, just shifted to overlap 
-
-
-		if (originalNet.size() != 6) throw invalid_argument("Net must have 6 faces for a cube");
-
+	array<Face, FACES> buildCube(const array<Face, FACES>& originalNet, int tileSize) {
+		// initially unmodified, just shifted to overlap
+		array<Face, FACES> cubeFaces;
+		for (int i = 0; i < FACES; i++) cubeFaces[i] = toVoxelCoordinates(originalNet[i], tileSize);
 
-		// ordering of faces to visit
-		const Face& rootFace = originalNet[0];
-
-		map<Face, set<Face>> dependents;
-		set<Face> visited;
-		treeFromNet(faceMapping, rootFace, nullptr, dependents, visited);
-		assert(visited.size() == 6); // reached everywhere on net
+		// ordering of faces to visit, from the first
+		Dependents dependents{};
+		array<bool, FACES> visited{};
+		treeFromNet(cubeFaces, 0, -1, dependents, visited);
+		assert(all_of(visited.begin(), visited.end(), [](bool v) { return v; })); // reached everywhere on net
 
 		// Now rotate to build cube, based on found tree
-		rotateAndBuildCube(rootFace, dependents, faceMapping);
+		rotateAndBuildCube(0, dependents, cubeFaces);
 
-		vector<Face> result;
-		for (const auto& face : originalNet) {
-			result.push_back(faceMapping.at(face));
-		}
+		checkIsCube(cubeFaces);
 
-		checkIsCube(result);
+		return cubeFaces;
+	}
 
-		return result;
+	// Side length of each face, from the 6 faces' total area (50 for the puzzle, 4 for its example)
+	int faceSize(const Grid& grid) {
+		int area = 0;
+		for (int y = 1; y <= grid.height(); y++) {
+			if (grid.rowXMax[y] >= grid.rowXMin[y]) area += grid.rowXMax[y] - grid.rowXMin[y] + 1;
+		}
+		int size = 1;
+		while (FACES * size * size < area) size++;
+		if (FACES * size * size != area) throw invalid_argument("Board of " + to_string(area) + " tiles can't fold into a cube");
+		return size;
 	}
 
-	vector<Face> gridToFaces(const Grid& grid) {
-		vector<Face> netFaces;
-		for (const auto& [p, _] : grid.walls) {
-			// remember, cells of original grid are 1 indexed
-			if (p.x % TILE_SIZE == 1 && p.y % TILE_SIZE == 1) {
+	array<Face, FACES> gridToFaces(const Grid& grid, int tileSize) {
+		array<Face, FACES> netFaces;
+		int found = 0;
+		// column by column, the order faces were always found in
+		for (int x = 1; x <= grid.width(); x += tileSize) {
+			for (int y = 1; y <= grid.height(); y += tileSize) {
+				// remember, cells of original grid are 1 indexed
+				Point<int> p{ x, y };
+				if (grid.tile(p) == Grid::OFF_MAP) continue;
+				if (found == FACES) throw invalid_argument("More than 6 faces in net");
 				// Important that face is defined with points in this order
 				Point3 p1{ p.x, p.y, 0 };
-				Point3 p2{ p.x, p.y + TILE_SIZE - 1, 0 };
-				Point3 p3{ p.x + TILE_SIZE - 1, p.y + TILE_SIZE - 1, 0 };
-				Point3 p4{ p.x + TILE_SIZE - 1, p.y, 0 };
-				netFaces.push_back({ { p1, p2, p3, p4 } });
+				Point3 p2{ p.x, p.y + tileSize - 1, 0 };
+				Point3 p3{ p.x + tileSize - 1, p.y + tileSize - 1, 0 };
+				Point3 p4{ p.x + tileSize - 1, p.y, 0 };
+				netFaces[found++] = Face({ p1, p2, p3, p4 });
 			}
 		}
+		if (found != FACES) throw invalid_argument("Failed to find all 6 faces");
 		return netFaces;
 	}
 
-	void part2() {
-		ifstream input{ "Day22.txt" };
-		if (!input) throw invalid_argument("Failed to open Day22.txt");
-
-		Grid grid = readGrid(input);
+	string solve2(const Input& input) {
+		const Grid& grid = input.grid;
 
-		vector<Face> netFaces = gridToFaces(grid);
+		const int tileSize = faceSize(grid);
+		array<Face, FACES> netFaces = gridToFaces(grid, tileSize);
 
-		if (netFaces.size() != 6) throw invalid_argument("Failed to find all 6 faces");
-		cout << "Faces of net:" << endl;
-		for (auto const& f : netFaces) cout << "  " << f << endl;
+		DAY_LOG(DETAIL) << "Faces of net:" << endl;
+		for (auto const& f : netFaces) DAY_LOG(DETAIL) << "  " << f << endl;
 
-		vector<Face> cubeFaces = buildCube(netFaces);
-
-		// Map of cube -> net face
-		map<Face, Face> cubeToNetFace;
-		for (int i = 0; i < 6; i++) {
-			cubeToNetFace.insert({ cubeFaces[i], netFaces[i] });
-		}
+		const CubeNet cubeNet{ buildCube(netFaces, tileSize), netFaces };
 
 		Point<int> p = startPoint(grid);
 
 		// Find corresponding face on net of starting point, and which face of the cube that is
-		auto it = find_if(cubeToNetFace.begin(), cubeToNetFace.end(), [&](const auto& cubeFaceNetFace) {
-			const auto& [cubeFace, netFace] = cubeFaceNetFace;
+		auto it = find_if(cubeNet.net.begin(), cubeNet.net.end(), [&](const Face& netFace) {
 			int xCoord = p.x - netFace[0].x;
 			int yCoord = p.y - netFace[0].y;
-			return xCoord >= 0 && xCoord < TILE_SIZE && yCoord >= 0 && yCoord < TILE_SIZE;
+			return xCoord >= 0 && xCoord < tileSize && yCoord >= 0 && yCoord < tileSize;
 		});
-		assert(it != cubeToNetFace.end());
+		assert(it != cubeNet.net.end());
 
-		Face cubeFace = it->first;
-		const Face netFace = it->second;
-		// adjust from grid coordinates to coordinates on tile (0 <= x,y < TILE_SIZE)
+		Face cubeFace = cubeNet.cube[it - cubeNet.net.begin()];
+		const Face netFace = *it;
+		// adjust from grid coordinates to coordinates on tile (0 <= x,y < tileSize)
 		p.x -= netFace[0].x;
 		p.y -= netFace[0].y;
 
-		Direction finalDir = runCommands(input, [&](Direction dir, int steps) {
-			tie(p, dir, cubeFace) = grid.moveOnCube(p, dir, cubeFace, cubeToNetFace, steps);
-			return dir;
+		Direction finalDir = dispatch<50, 4>(tileSize, [&](auto size) {
+			return runCommands(input.commands, [&](Direction dir, int steps) {
+				tie(p, dir, cubeFace) = grid.moveOnCube<decltype(size)::value>(p, dir, cubeFace, cubeNet, tileSize, steps);
+				return dir;
+			});
 		});
 
 		// map back to actual grid coordinate
-		Point3 netPosition = cubeToNetFace.at(cubeFace)[0] + p;
+		Point3 netPosition = cubeNet.netFace(cubeFace)[0] + p;
 
 		// 1000 times the row, 4 times the column, and the facing.
 		int result = 1000 * netPosition.y + 4 * netPosition.x + static_cast<int>(finalDir);
 
-		cout << result << endl; // 53324
-	}
-
-
-	void main() {
-		time_t start, end;
-		time(&start);
-		part1();
-		part2();
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
+		return to_string(result); // 53324
 	}
 }
\ No newline at end of file
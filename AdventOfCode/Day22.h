@@ -1,5 +1,23 @@
 #pragma once
 
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace cache {
+	class Writer;
+	class Reader;
+}
+
 namespace day22 {
-	void main();
-}
\ No newline at end of file
+	struct Input;
+
+	std::shared_ptr<const Input> parse(std::string_view text);
+	std::string solve1(const Input& input);
+	std::string solve2(const Input& input);
+
+	// Parsed model as a cache file, bump the version whenever what's written changes
+	const int MODEL_VERSION = 1;
+	void save(const Input& input, cache::Writer& out);
+	std::shared_ptr<const Input> load(cache::Reader& in);
+}
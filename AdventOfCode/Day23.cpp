@@ -1,25 +1,139 @@
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
-#include <unordered_set>
 #include <deque>
 #include <algorithm>
 #include <stdexcept>
-#include <bitset>
-#include <boost/pool/pool_alloc.hpp>
+#include <limits>
+#include <memory>
+#include <bit>
+#include <cstdint>
 
 #include "Point.h"
+#include "Input.h"
+#include "Output.h"
+#include "Scratch.h"
+#include "Checkpoint.h"
+#include "Simd.h"
 
 using namespace std;
 
 namespace day23 {
 
-	// Annoyingly, have to give all of the other defaults in order to just change the last one.
-	// Using boost pool allocator, since updates will remove and re-insert elements, without actually growing/shrinking set
-	typedef unordered_set<Point<int>, std::hash<Point<int>>, std::equal_to<Point<int>>, boost::fast_pool_allocator<Point<int>>> ElfGrid;
+	// Empty cells kept round the elves when the grid is laid out, so it only needs redoing every so often as they spread
+	const int MARGIN = 16;
+
+	/*
+	Elves as rows of bits (see Simd.h), so each round moves all of them at once.
+	Shifting the whole grid a bit lines each elf up with the cell east or west of it, and a whole row with the cell north or south.
+	At least 2 empty cells are kept on every side, so a round can't move an elf off the grid,
+	and shifts only ever carry empty cells from the end of one row into the next.
+	*/
+	class ElfGrid {
+	private:
+		Point<int> origin; // where the first bit of the first row is
+		int rows = 0;
+		size_t rowWords = 0;
+		vector<uint64_t> bits;
+
+	public:
+		// Lays out the grid afresh to fit them
+		void assign(const vector<Point<int>>& elves) {
+			int xMin = 0, xMax = 0, yMin = 0, yMax = 0;
+			if (!elves.empty()) {
+				xMin = yMin = numeric_limits<int>::max();
+				xMax = yMax = numeric_limits<int>::min();
+			}
+			for (const auto& [x, y] : elves) {
+				xMin = min(x, xMin);
+				xMax = max(x, xMax);
+				yMin = min(y, yMin);
+				yMax = max(y, yMax);
+			}
+
+			origin = { xMin - MARGIN, yMin - MARGIN };
+			rows = yMax - yMin + 1 + 2 * MARGIN;
+			rowWords = simd::wordsFor(static_cast<size_t>(xMax - xMin + 1 + 2 * MARGIN));
+			bits.assign(rows * rowWords, 0);
+			for (const auto& [x, y] : elves) {
+				size_t bit = x - origin.x;
+				bits[(y - origin.y) * rowWords + bit / 64] |= uint64_t{ 1 } << (bit % 64);
+			}
+		}
+
+		// In reading order
+		vector<Point<int>> positions() const {
+			vector<Point<int>> elves;
+			for (int y = 0; y < rows; y++) {
+				for (size_t w = 0; w < rowWords; w++) {
+					for (uint64_t word = bits[y * rowWords + w]; word != 0; word &= word - 1) {
+						elves.push_back({ origin.x + static_cast<int>(w * 64 + countr_zero(word)), origin.y + y });
+					}
+				}
+			}
+			return elves;
+		}
+
+		// Whether an elf is within 2 cells of the edge, so the next round could move it off the grid
+		bool crowded() const {
+			if (rows < 4) return size() > 0;
+			for (int y : { 0, 1, rows - 2, rows - 1 }) {
+				for (size_t w = 0; w < rowWords; w++) {
+					if (bits[y * rowWords + w] != 0) return true;
+				}
+			}
+			uint64_t first = 0, last = 0;
+			for (int y = 0; y < rows; y++) {
+				first |= bits[y * rowWords];
+				last |= bits[y * rowWords + rowWords - 1];
+			}
+			return (first & 3) != 0 || (last >> 62) != 0;
+		}
+
+		size_t size() const {
+			return simd::popcount(bits.data(), bits.size());
+		}
+
+		size_t words() const {
+			return bits.size();
+		}
+
+		// Shift that lines a cell up with the one above/below it
+		size_t rowBits() const {
+			return rowWords * 64;
+		}
+
+		uint64_t* data() {
+			return bits.data();
+		}
+
+		const uint64_t* data() const {
+			return bits.data();
+		}
+	};
+
+	// Masks worked out each round, kept between rounds, and between solves on the same thread, to keep their memory
+	struct Proposals {
+		vector<uint64_t> current; // where the elves started the round
+		vector<uint64_t> row3; // an elf in the cell or either side of it
+		vector<uint64_t> column3; // an elf in the cell or above/below it
+		vector<uint64_t> blocked[4]; // for each direction, an elf somewhere on that side
+		vector<uint64_t> remaining; // elves yet to pick a direction
+		vector<uint64_t> moving[4]; // elves proposing each direction
+		vector<uint64_t> target[4]; // cells they're proposing, by direction
+		vector<uint64_t> shifted;
+		vector<uint64_t> clash; // cells more than one elf proposed
+
+		void resize(size_t words) {
+			for (vector<uint64_t>* mask : { &current, &row3, &column3, &remaining, &shifted, &clash }) mask->resize(words);
+			for (int d = 0; d < 4; d++) {
+				blocked[d].resize(words);
+				moving[d].resize(words);
+				target[d].resize(words);
+			}
+		}
+	};
 
 	// In order considered by elves
 	enum Direction {
@@ -29,50 +143,73 @@ namespace day23 {
 		RIGHT = 3,
 	};
 
-	Point<int> asVector(const Direction& d) {
+	// Neighbouring cells, into out: UP gives each cell whether the cell above it is set, and so on
+	void neighbour(const ElfGrid& grid, const vector<uint64_t>& mask, Direction d, vector<uint64_t>& out) {
+		const size_t n = grid.words();
+		switch (d) {
+		case UP: return simd::shiftUp(mask.data(), out.data(), n, grid.rowBits());
+		case DOWN: return simd::shiftDown(mask.data(), out.data(), n, grid.rowBits());
+		case LEFT: return simd::shiftUp(mask.data(), out.data(), n, 1);
+		case RIGHT: return simd::shiftDown(mask.data(), out.data(), n, 1);
+		default: throw invalid_argument("Unrecognised direction: " + to_string(d));
+		}
+	}
+
+	Direction opposite(Direction d) {
 		switch (d) {
-		case UP: return { 0, -1 };
-		case DOWN: return { 0, 1 };
-		case LEFT: return { -1, 0 };
-		case RIGHT: return { 1, 0 };
-		default: throw invalid_argument("Unrecognised direction: " + d);
+		case UP: return DOWN;
+		case DOWN: return UP;
+		case LEFT: return RIGHT;
+		case RIGHT: return LEFT;
+		default: throw invalid_argument("Unrecognised direction: " + to_string(d));
 		}
 	}
 
-	void printGrid(const unordered_set<Point<int>>& elves) {
+	void printGrid(const ElfGrid& elves) {
+		if (!diagnostics::enabled(Verbosity::DETAIL)) return;
+		vector<Point<int>> positions = elves.positions();
 		int xMin = numeric_limits<int>::max(), yMin = numeric_limits<int>::max();
 		int xMax = numeric_limits<int>::min(), yMax = numeric_limits<int>::min();
 
-		for (const auto& [x, y] : elves) {
+		for (const auto& [x, y] : positions) {
 			xMin = min(x, xMin);
 			xMax = max(x, xMax);
 			yMin = min(y, yMin);
 			yMax = max(y, yMax);
 		}
 
-		cout << "xMin=" << xMin << " xMax=" << xMax << " yMin=" << yMin << " yMax=" << yMax << endl;
+		DAY_LOG(DETAIL) << "xMin=" << xMin << " xMax=" << xMax << " yMin=" << yMin << " yMax=" << yMax << endl;
 
-		cout << "Occupied=" << elves.size() << endl;
+		DAY_LOG(DETAIL) << "Occupied=" << positions.size() << endl;
 
+		size_t next = 0; // positions are in reading order
 		for (int y = yMin; y <= yMax; y++) {
 			for (int x = xMin; x <= xMax; x++) {
-				if (elves.contains({ x, y })) {
-					cout << '#';
+				if (next < positions.size() && positions[next] == Point<int>{ x, y }) {
+					DAY_LOG(DETAIL) << '#';
+					next++;
 				}
 				else {
-					cout << '.';
+					DAY_LOG(DETAIL) << '.';
 				}
 			}
-			cout << endl;
+			DAY_LOG(DETAIL) << endl;
 		}
 	}
 
-	ElfGrid readGrid(ifstream& input) {
-		ElfGrid elves;
+	// starting elf positions, in reading order
+	struct Input {
+		vector<Point<int>> elves;
+	};
+
+	shared_ptr<const Input> parse(string_view text) {
+		auto input = make_shared<Input>();
+		vector<Point<int>>& elves = input->elves;
 
-		string line;
+		Splitter inputLines(text);
+		string_view line;
 		int y = 0;
-		while (getline(input, line) && line.length() > 0) {
+		while (inputLines.next(line) && line.length() > 0) {
 			y++;
 			int x = 0;
 			for (char c : line) {
@@ -80,129 +217,113 @@ namespace day23 {
 				switch (c) {
 				case '.': continue;
 				case '#': {
-					elves.insert({ x, y });
+					elves.push_back({ x, y });
 					break;
 				}
-				default: throw invalid_argument("Unknown tile: " + c);
+				default: throw invalid_argument("Unknown tile: " + string(1, c));
 				}
 			}
 		}
 
-		return elves;
+		return input;
 	}
 
 	/*
 	Returns whether at least 1 elf moved. Updates searchOrder at end of pass.
+	Only elves proposing opposite ways can clash (two apart in a line), since an elf diagonally next to a cell
+	stops any other elf next to that cell from proposing it.
 	*/
-	bool update(ElfGrid& elves, deque<Direction>& searchOrder) {
-		bool changed = false;
-		vector<pair<Point<int>, Point<int>>> proposedMoves;
-		unordered_map<Point<int>, int> proposedCount;
-
-		bitset<4> occupiedSides;
-		for (const auto& elf : elves) {
-			// work out neighbours
-			bool allEmpty = true;
-			occupiedSides.reset();
-
-			// TODO: If we reverted back to an ordered set, could simplify iteration/search to exploit the fact we know neighbours will be adjacent.
-			// i.e. that entries before/after the current point are the neighbours we want, rather than full log(N) search of set.
-			for (int x = -1; x <= 1; x++) {
-				for (int y = -1; y <= 1; y++) {
-					if (x == 0 && y == 0) continue;
-
-					const Point<int> offset = { x, y };
-					if (elves.contains(elf + offset)) {
-						allEmpty = false;
-
-						for (int d = 0; d < 4; d++) {
-							const Direction dir = static_cast<Direction>(d);
-							if (asVector(dir).dot(offset) == 1) occupiedSides.set(dir);
-						}
-					}
-				}
-			}
-
-			// decide next move, if any
-			if (allEmpty) continue;
-			for (const Direction& dir : searchOrder) {
-				if (!occupiedSides[dir]) {
-					const Point<int> proposed = elf + asVector(dir);
-					proposedMoves.emplace_back(elf, proposed);
-					proposedCount[proposed]++;
-					break;
-				}
-			}
+	bool update(ElfGrid& elves, deque<Direction>& searchOrder, Proposals& proposals) {
+		if (elves.crowded()) elves.assign(elves.positions());
+		const size_t n = elves.words();
+		proposals.resize(n);
+		Proposals& p = proposals;
+		p.current.assign(elves.data(), elves.data() + n);
+
+		// work out neighbours, a line of 3 cells on each side
+		copy_n(p.current.data(), n, p.row3.data());
+		copy_n(p.current.data(), n, p.column3.data());
+		for (const Direction d : { LEFT, RIGHT }) {
+			neighbour(elves, p.current, d, p.shifted);
+			simd::orMasks(p.row3.data(), p.shifted.data(), p.row3.data(), n);
+		}
+		for (const Direction d : { UP, DOWN }) {
+			neighbour(elves, p.current, d, p.shifted);
+			simd::orMasks(p.column3.data(), p.shifted.data(), p.column3.data(), n);
+		}
+		neighbour(elves, p.row3, UP, p.blocked[UP]);
+		neighbour(elves, p.row3, DOWN, p.blocked[DOWN]);
+		neighbour(elves, p.column3, LEFT, p.blocked[LEFT]);
+		neighbour(elves, p.column3, RIGHT, p.blocked[RIGHT]);
+
+		// only elves with a neighbour move, and the 4 sides cover all 8 of them
+		simd::orMasks(p.blocked[UP].data(), p.blocked[DOWN].data(), p.remaining.data(), n);
+		simd::orMasks(p.remaining.data(), p.blocked[LEFT].data(), p.remaining.data(), n);
+		simd::orMasks(p.remaining.data(), p.blocked[RIGHT].data(), p.remaining.data(), n);
+		simd::andMasks(p.remaining.data(), p.current.data(), p.remaining.data(), n);
+
+		// decide next move, if any
+		for (const Direction d : searchOrder) {
+			simd::andNotMasks(p.remaining.data(), p.blocked[d].data(), p.moving[d].data(), n);
+			simd::andMasks(p.remaining.data(), p.blocked[d].data(), p.remaining.data(), n);
 		}
 
-		// do the moves
-		for (const auto& [from, to] : proposedMoves) {
-			if (proposedCount.at(to) == 1) {
-				elves.erase(from);
-				elves.insert(to);
-				changed = true;
-			}
+		// where they'd end up, each cell looking back the way they'd come from
+		for (const Direction d : { UP, DOWN, LEFT, RIGHT }) neighbour(elves, p.moving[d], opposite(d), p.target[d]);
+		simd::andMasks(p.target[UP].data(), p.target[DOWN].data(), p.clash.data(), n);
+		simd::andMasks(p.target[LEFT].data(), p.target[RIGHT].data(), p.shifted.data(), n);
+		simd::orMasks(p.clash.data(), p.shifted.data(), p.clash.data(), n);
+
+		// do the moves: each elf not clashing leaves its cell for its target
+		uint64_t* grid = elves.data();
+		size_t moved = 0;
+		for (const Direction d : { UP, DOWN, LEFT, RIGHT }) {
+			simd::andNotMasks(p.target[d].data(), p.clash.data(), p.target[d].data(), n);
+			moved += simd::popcount(p.target[d].data(), n);
+			neighbour(elves, p.target[d], d, p.shifted); // back to where they came from
+			simd::andNotMasks(grid, p.shifted.data(), grid, n);
 		}
+		for (const Direction d : { UP, DOWN, LEFT, RIGHT }) simd::orMasks(grid, p.target[d].data(), grid, n);
 
 		// rotate first choice
 		const Direction first = searchOrder.front(); searchOrder.pop_front();
 		searchOrder.push_back(first);
 
-		return changed;
+		return moved > 0;
 	}
 
 	/*
 	Up is y--, as top row is y=1
 	*/
-	void part1() {
-		ifstream input{ "Day23.txt" };
-		if (!input) throw invalid_argument("Failed to open Day23.txt");
-
-		// Not particularly memory efficient, but unlikely to matter
-		ElfGrid elves = readGrid(input);
+	string solve1(const Input& input) {
+		Scratch<ElfGrid> scratchElves;
+		ElfGrid& elves = *scratchElves;
+		elves.assign(input.elves);
 
 		deque<Direction> searchOrder = { UP, DOWN, LEFT, RIGHT };
+		Scratch<Proposals> proposals;
 		for (int i = 0; i < 10; i++) {
-			update(elves, searchOrder);
+			update(elves, searchOrder, *proposals);
 		}
 
 		// find bounds of grid
 		int xMin = numeric_limits<int>::max(), yMin = numeric_limits<int>::max();
 		int xMax = numeric_limits<int>::min(), yMax = numeric_limits<int>::min();
 
-		
-
-		for (const auto& [x, y] : elves) {
+		for (const auto& [x, y] : elves.positions()) {
 			xMin = min(x, xMin);
 			xMax = max(x, xMax);
 			yMin = min(y, yMin);
 			yMax = max(y, yMax);
 		}
 
-		cout << "xMin=" << xMin << " xMax=" << xMax << " yMin=" << yMin << " yMax=" << yMax << endl;
+		DAY_LOG(SUMMARY) << "xMin=" << xMin << " xMax=" << xMax << " yMin=" << yMin << " yMax=" << yMax << endl;
 
 		// +1, since single-cell grid has xMin=xMax
 		int gridArea = (xMax + 1 - xMin) * (yMax + 1 - yMin);
 		int freeTiles = gridArea - static_cast<int>(elves.size());
 
-		cout << freeTiles << endl; // 4109
-	}
-
-	void part2() {
-		ifstream input{ "Day23.txt" };
-		if (!input) throw invalid_argument("Failed to open Day23.txt");
-
-		ElfGrid elves = readGrid(input);
-
-		deque<Direction> searchOrder = { UP, DOWN, LEFT, RIGHT };
-		int round = 0;
-		bool changing = true;
-		while (changing) {
-			round++;
-			changing = update(elves, searchOrder);
-		}
-
-		cout << round << endl; // 1055
+		return to_string(freeTiles); // 4109
 	}
 
 	/*
@@ -216,17 +337,40 @@ namespace day23 {
 	5. Still ~30% modifying set of directions, switch to bitset for much lower memory footprint: 12s
 	6. Also replacing map with unordered_map for tracking of conflicts: 10s
 	7. pool_allocator actually worse (24s), but fast_pool_allocator (due to non-contiguous updates): 8s
-
-	At this point, rest is just searching for cells. Could probably make faster by going back to sorted collection
-	and making the different iterations related, to e.g. only search adjacent columns to see if neighbours occupied.
+	8. Flat open-addressing set/map of points instead, reusing the proposal map between rounds: ~500ms
+	9. Rows of bits rather than a set of points, so every elf looks at its neighbours and moves at once
 	*/
-	void main() {
-		time_t start, end;
-		time(&start);
-		part1();
-		part2();
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
+	// Of what part 2 snapshots (see Checkpoint.h): the elves, then the search order
+	const int SNAPSHOT_VERSION = 1;
+
+	string solve2(const Input& input) {
+		Scratch<ElfGrid> scratchElves;
+		ElfGrid& elves = *scratchElves;
+		elves.assign(input.elves);
+
+		deque<Direction> searchOrder = { UP, DOWN, LEFT, RIGHT };
+
+		cache::Writer start;
+		start.putVector(input.elves);
+		checkpoint::Simulation snapshots(23, 2, SNAPSHOT_VERSION, start);
+		int round = static_cast<int>(snapshots.resume([&](cache::Reader& in) {
+			elves.assign(in.getVector<Point<int>>());
+			for (Direction& dir : searchOrder) dir = in.get<Direction>();
+		}));
+
+		Scratch<Proposals> proposals;
+		bool changing = true;
+		while (changing) {
+			round++;
+			changing = update(elves, searchOrder, *proposals);
+
+			snapshots.maybeSave(round, [&](cache::Writer& out) {
+				out.putVector(elves.positions());
+				for (Direction dir : searchOrder) out.put(dir);
+			});
+		}
+		snapshots.finish();
+
+		return to_string(round); // 1055
 	}
 }
\ No newline at end of file
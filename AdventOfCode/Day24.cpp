@@ -1,276 +1,205 @@
-#include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
-#include <unordered_set>
-#include <deque>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <cstdint>
 
-#include "Point.h"
+#include "Input.h"
+#include "Scratch.h"
+#include "Simd.h"
 
 using namespace std;
 
 namespace day24 {
-	typedef Point<int> Pt;
-
 	/*
-	Up/Down flipped since grid read from top down, so y=0 is top
+	The valley inside the walls as rows of bits (see Simd.h), top to bottom, so every cell moves at once:
+	the blizzards going left/right are shifted a bit each minute, and those going up/down are just read from rows further round.
+	Each row has at least one spare bit past the end, so shifting them all as one long mask only ever carries a bit
+	from the end of one row into a spare bit, never into the next row.
 	*/
-	const Pt& dirFromChar(const char c) {
-		switch (c) {
-		case '^': return Pt::DOWN;
-		case '>': return Pt::RIGHT;
-		case 'v': return Pt::UP;
-		case '<': return Pt::LEFT;
-		default: throw invalid_argument("Unrecognised direction: " + c);
-		}
-	}
-
-	class Blizzard {
-	public:
-		Pt pos;
-		Pt direction;
-
-		Blizzard(const Pt& pos, const Pt& direction) : pos(pos), direction(direction) {}
-	};
-
-	class Player {
-	public:
-		bool present{ false }; // used to invalidate cells when no longer present
-		int timesReachedEnd{ 0 };
-		int timesReachedStart{ 0 };
-
-		void update(const Player& other) {
-			assert(other.present);
-			if (!present) { // absent -> present, take actual values
-				present = other.present;
-				timesReachedEnd = other.timesReachedEnd;
-				timesReachedStart = other.timesReachedStart;
-			}
-			else { // can take max, goes in sequence (0,0), (0,1), (1,1), (1,2)
-				timesReachedEnd = max(timesReachedEnd, other.timesReachedEnd);
-				timesReachedStart = max(timesReachedStart, other.timesReachedStart);
-			}
-		}
-	};
-
-	class Cell {
-	private:
-		bool wall;
-		int blizzardCount;
-
-	public:
-		Cell(const bool wall, const int blizzardCount) : wall(wall), blizzardCount(blizzardCount) {}
-
-		bool isWall() const {
-			return wall;
+	struct Input {
+		int width = 0;
+		int height = 0;
+		size_t rowWords = 0;
+		int entrance = 0; // column of the gap in the top wall, 0 being the first column inside the walls
+		int exit = 0; // and in the bottom wall
+
+		vector<uint64_t> inside; // every cell of every row
+		// where each way of blizzard starts
+		vector<uint64_t> right;
+		vector<uint64_t> left;
+		vector<uint64_t> up;
+		vector<uint64_t> down;
+
+		bool test(const vector<uint64_t>& rows, int y, int x) const {
+			return (rows[y * rowWords + x / 64] >> (x % 64)) & 1;
 		}
 
-		int getBlizzardCount() const {
-			return blizzardCount;
+		void set(vector<uint64_t>& rows, int y, int x) const {
+			rows[y * rowWords + x / 64] |= uint64_t{ 1 } << (x % 64);
 		}
 
-		void incCount() {
-			blizzardCount++;
-		}
-
-		void decCount() {
-			blizzardCount--;
+		void clear(vector<uint64_t>& rows, int y, int x) const {
+			rows[y * rowWords + x / 64] &= ~(uint64_t{ 1 } << (x % 64));
 		}
 	};
 
-	class Grid {
-	private:
-		vector<vector<Cell>> cells;
-		vector<Blizzard> blizzards;
-
-		// Alternate between them to get next state
-		vector<vector<Player>> tilesA;
-		vector<vector<Player>> tilesB;
-
-		vector<vector<Player>>* occupiedPtr{ &tilesA };
-		vector<vector<Player>>* nextOccupiedPtr{ &tilesB };
-
-		int width;
-		int height;
-
-	private:
-		Cell& get(const Pt& point) {
-			return cells[point.y][point.x];
-		}
+	// Everything that changes minute to minute, kept per thread between solves to reuse the memory
+	struct State {
+		vector<uint64_t> right;
+		vector<uint64_t> left;
+		vector<uint64_t> open; // cells free of blizzards this minute
+		vector<uint64_t> reached; // with an empty row above and below, so rows either side are just a row's shift away
+		vector<uint64_t> grown;
+		vector<uint64_t> neighbours;
+	};
 
-		bool isFree(int x, int y) {
-			// need to catch y < 0 or y >= height, since no wall above entrance/below exit
-			if (y < 0 || y >= height) return false;
-			const Cell& cell = get({ x, y });
-			return !cell.isWall() && cell.getBlizzardCount() == 0;
+	// Those going right wrap from the spare bit past the end to the first, and those going left from the first to the last
+	void moveBlizzards(const Input& input, State& state) {
+		const size_t words = state.right.size();
+		simd::shiftUp(state.right.data(), state.right.data(), words, 1);
+		for (int y = 0; y < input.height; y++) {
+			if (input.test(state.right, y, input.width)) {
+				input.clear(state.right, y, input.width);
+				input.set(state.right, y, 0);
+			}
+			if (input.test(state.left, y, 0)) input.set(state.left, y, input.width);
 		}
 
-		void updateBlizzards() {
-			// exploits fact that walls are at edges x,y = 0 or x,y = width-1, height-1, and blizzards never cross through openings
-			for (auto& blizzard : blizzards) {
-				get(blizzard.pos).decCount();
-				auto& pos = blizzard.pos;
-
-				// wrap around walls
-				pos = pos + blizzard.direction;
-				if (get(pos).isWall()) {
-					if (pos.x == 0) pos.x = width - 2;
-					else if (pos.x == width - 1) pos.x = 1;
-					else if (pos.y == 0) pos.y = height - 2;
-					else if (pos.y == height - 1) pos.y = 1;
-					else {
-						throw invalid_argument("Unexpected wall!");
-					}
-				}
+		simd::shiftDown(state.left.data(), state.left.data(), words, 1);
+		// the next row's first bit lands in the last spare one
+		const int lastBit = static_cast<int>(input.rowWords * 64 - 1);
+		for (int y = 0; y < input.height; y++) input.clear(state.left, y, lastBit);
+	}
 
-				get(pos).incCount();
-			}
-		}
+	// Or's rows into out, row y of out getting row (y + by) % height of rows
+	void orRotated(const vector<uint64_t>& rows, int by, const Input& input, uint64_t* out) {
+		const size_t split = (input.height - by) * input.rowWords;
+		simd::orMasks(out, rows.data() + by * input.rowWords, out, split);
+		simd::orMasks(out + split, rows.data(), out + split, by * input.rowWords);
+	}
 
-		void update(const Player& from, const int newY, Player& to) {
-			to.update(from);
-			// going towards exit
-			if (to.timesReachedEnd <= to.timesReachedStart) {
-				if (newY == height - 1) to.timesReachedEnd++;
-			} // going towards entrance
-			else {
-				if (newY == 0) to.timesReachedStart++;
+	/*
+	Minutes to cross the valley `trips` times, starting from the entrance, then back and forth.
+	Being first to the far side of each crossing is always best, since the gaps in the walls are never hit by blizzards,
+	so it's fine to wait there.
+	*/
+	int crossValley(const Input& input, int trips) {
+		const size_t words = input.inside.size();
+		const size_t rowWords = input.rowWords;
+
+		Scratch<State> scratch;
+		State& state = *scratch;
+		// copy assignment keeps the memory from last time, if it's big enough
+		state.right = input.right;
+		state.left = input.left;
+		state.open.resize(words);
+		state.reached.assign(words + 2 * rowWords, 0);
+		state.grown.resize(state.reached.size());
+		state.neighbours.resize(state.reached.size());
+		uint64_t* reached = state.reached.data() + rowWords; // the valley itself, past the empty row above
+
+		bool towardsExit = true; // otherwise towards the entrance, having got to the exit
+		int minute = 0;
+		while (true) {
+			minute++;
+			moveBlizzards(input, state);
+			fill(state.open.begin(), state.open.end(), 0);
+			simd::orMasks(state.right.data(), state.left.data(), state.open.data(), words);
+			orRotated(input.up, minute % input.height, input, state.open.data());
+			orRotated(input.down, (input.height - minute % input.height) % input.height, input, state.open.data());
+			simd::andNotMasks(input.inside.data(), state.open.data(), state.open.data(), words);
+
+			// got to the far side from the row next to it
+			int lastRow = towardsExit ? input.height - 1 : 0;
+			int gap = towardsExit ? input.exit : input.entrance;
+			if ((reached[lastRow * rowWords + gap / 64] >> (gap % 64)) & 1) {
+				if (--trips == 0) return minute;
+				towardsExit = !towardsExit;
+				fill(state.reached.begin(), state.reached.end(), 0);
+				continue;
 			}
-		}
 
-		void updatePlayer(const int x, const int y, vector<vector<Player>>& occupied, vector<vector<Player>>& nextOccupied, int& maxTimesReachedExit) {
-			Player& from = occupied[y][x];
-			if (!from.present) return;
-
-			if (isFree(x, y)) update(from, y, nextOccupied[y][x]);
-			if (isFree(x - 1, y)) update(from, y, nextOccupied[y][x - 1]);
-			if (isFree(x + 1, y)) update(from, y, nextOccupied[y][x + 1]);
-			if (isFree(x, y - 1)) update(from, y - 1, nextOccupied[y - 1][x]);
-			if (isFree(x, y + 1)) {
-				Player& other = nextOccupied[y + 1][x];
-				update(from, y + 1, other);
-				// in case this is the first way found to reach exit n times
-				maxTimesReachedExit = max(maxTimesReachedExit, other.timesReachedEnd);
+			// stay put, or move one cell any way
+			const size_t all = state.reached.size();
+			uint64_t* grown = state.grown.data();
+			uint64_t* neighbours = state.neighbours.data();
+			copy(state.reached.begin(), state.reached.end(), grown);
+			for (size_t step : { size_t{ 1 }, rowWords * 64 }) {
+				simd::shiftUp(state.reached.data(), neighbours, all, step);
+				simd::orMasks(grown, neighbours, grown, all);
+				simd::shiftDown(state.reached.data(), neighbours, all, step);
+				simd::orMasks(grown, neighbours, grown, all);
 			}
+			simd::andMasks(grown + rowWords, state.open.data(), reached, words);
 
-			from.present = false;
+			// or step in from waiting in the gap
+			int firstRow = towardsExit ? 0 : input.height - 1;
+			int start = towardsExit ? input.entrance : input.exit;
+			if (input.test(state.open, firstRow, start)) reached[firstRow * rowWords + start / 64] |= uint64_t{ 1 } << (start % 64);
 		}
+	}
 
-	public:
-		Grid(const vector<vector<Cell>>& cells, const vector<Blizzard>& blizzards) : cells(cells), blizzards(blizzards) {
-			height = static_cast<int>(cells.size());
-			width = static_cast<int>(cells[0].size());
-
-			vector<vector<Player>>& occupied = *occupiedPtr;
-			vector<vector<Player>>& nextOccupied = *nextOccupiedPtr;
-
-			// pre-populate maps initially
-			for (int y = 0; y < height; y++) {
-				vector<Player> occupiedRow;
-				vector<Player> nextOccupiedRow;
-				for (int x = 0; x < width; x++) {
-					Player p{};
-					p.present = y == 0 && !get({ x, y }).isWall(); // start in top row
-					occupiedRow.push_back(p);
-					nextOccupiedRow.push_back({});
-				}
-				occupied.push_back(occupiedRow);
-				nextOccupied.push_back(nextOccupiedRow);
-			}
+	shared_ptr<const Input> parse(string_view text) {
+		vector<string_view> lines;
+		Splitter inputLines(text);
+		string_view line;
+		while (inputLines.next(line) && line.length() > 0) {
+			lines.push_back(line);
 		}
-
-		/*
-		Update positions of blizzards, then of occupied cells.
-		Returns max times could have reached end (going back to start in between)
-		*/
-		int step() {
-			updateBlizzards();
-
-			vector<vector<Player>>& occupied = *occupiedPtr;
-			vector<vector<Player>>& nextOccupied = *nextOccupiedPtr;
-
-			int maxTimesReachedExit = 0;
-
-			// with updated blizzard positions, work out new available spaces
-			for (int y = 0; y < height; y++) {
-				for (int x = 0; x < width; x++) {
-					updatePlayer(x, y, occupied, nextOccupied, maxTimesReachedExit);
-				}
+		if (lines.size() < 3 || lines[0].size() < 3) throw invalid_argument("Valley is too small");
+
+		auto input = make_shared<Input>();
+		const int width = static_cast<int>(lines[0].size()) - 2;
+		const int height = static_cast<int>(lines.size()) - 2;
+		input->width = width;
+		input->height = height;
+		input->rowWords = simd::wordsFor(width + 1); // room for the spare bit
+		const size_t words = height * input->rowWords;
+		for (vector<uint64_t>* rows : { &input->inside, &input->right, &input->left, &input->up, &input->down }) rows->assign(words, 0);
+
+		// the only open cell in a wall
+		auto gap = [&](string_view wall) {
+			size_t x = wall.find('.');
+			if (wall.size() != lines[0].size() || x == string_view::npos || x == 0 || x > static_cast<size_t>(width)) {
+				throw invalid_argument("No gap in the wall: " + string(wall));
 			}
-
-			// 'next' occupied table becomes the current one, original one now all false
-			swap(occupiedPtr, nextOccupiedPtr);
-
-			return maxTimesReachedExit;
-		}
-	};
-
-
-	Grid readGrid(ifstream& input) {
-		vector<vector<Cell>> cells;
-		vector<Blizzard> blizzards;
-
-		string line;
-		while (getline(input, line) && line.length() > 0) {
-			vector<Cell> row;
-			for (char c : line) {
+			return static_cast<int>(x) - 1;
+		};
+		input->entrance = gap(lines[0]);
+		input->exit = gap(lines.back());
+
+		for (int y = 0; y < height; y++) {
+			string_view row = lines[y + 1];
+			if (row.size() != lines[0].size() || row[0] != '#' || row.back() != '#') throw invalid_argument("Rows of the valley differ: " + string(row));
+			for (int x = 0; x < width; x++) {
+				input->set(input->inside, y, x);
+				char c = row[x + 1];
 				switch (c) {
-				case '#': {
-					row.emplace_back(true, 0);
-					continue;
-				}
-				case '.': {
-					row.emplace_back(false, 0);
-					continue;
+				case '.': break;
+				case '>': input->set(input->right, y, x); break;
+				case '<': input->set(input->left, y, x); break;
+				case '^': input->set(input->up, y, x); break;
+				case 'v': input->set(input->down, y, x); break;
+				default: throw invalid_argument("Unrecognised tile: " + string(1, c));
 				}
-				default:
-					const Pt dir = dirFromChar(c);
-					Pt pos{ static_cast<int>(row.size()), static_cast<int>(cells.size()) };
-					blizzards.emplace_back(pos, dir);
-					row.emplace_back(false, 1);
+				// they'd leave the valley through the gap
+				if ((c == '^' || c == 'v') && (x == input->entrance || x == input->exit)) {
+					throw invalid_argument("Blizzard going up/down in line with a gap in the wall");
 				}
 			}
-			cells.push_back(row);
 		}
 
-		return {cells, blizzards};
+		return input;
 	}
 
-	void part1() {
-		ifstream input{ "Day24.txt" };
-		if (!input) throw invalid_argument("Failed to open Day24.txt");
-
-		Grid grid = readGrid(input);
-
-		int steps = 1;
-		while (!grid.step()) steps++;
-
-		cout << steps << endl; // 221
+	string solve1(const Input& input) {
+		return to_string(crossValley(input, 1)); // 221
 	}
 
-	void part2() {
-		ifstream input{ "Day24.txt" };
-		if (!input) throw invalid_argument("Failed to open Day24.txt");
-
-		Grid grid = readGrid(input);
-
-		int steps = 1;
-		while (grid.step() < 2) steps++;
-
-		cout << steps << endl; // 739
-	}
-
-	void main() {
-		time_t start, end;
-		time(&start);
-		part1();
-		part2();
-		time(&end);
-
-		cout << "Elapsed: " << (double)(end - start) << endl;
+	string solve2(const Input& input) {
+		return to_string(crossValley(input, 3)); // 739
 	}
-}
\ No newline at end of file
+}
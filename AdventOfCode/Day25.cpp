@@ -1,54 +1,64 @@
-#include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <utility>
+
+#include "Input.h"
+#include "StreamInput.h"
 
 using namespace std;
 
 namespace day25 {
-	void part1() {
-		ifstream input{ "Day25.txt" };
-		if (!input) throw invalid_argument("Failed to open Day25.txt");
+	// SNAFU numbers, one per line
+	struct Input {
+		vector<string> numbers;
+	};
 
-		int64_t total{ 0 };
+	shared_ptr<const Input> parse(string_view text) {
+		Splitter inputLines(text);
+		auto input = make_shared<Input>();
+
+		string_view line;
+		while (inputLines.next(line) && line.length() > 0) {
+			input->numbers.emplace_back(line);
+		}
 
-		string line;
-		while (getline(input, line) && line.length() > 0) {
-			int64_t value{ 0 };
-			for (char c : line) {
-				value *= 5;
-				switch (c) {
-				case '0': break;
-				case '1': {
-					value++;
-					break;
-				}
-				case '2': {
-					value += 2;
-					break;
-				}
-				case '-': {
-					value--;
-					break;
-				}
-				case '=':
-					value -= 2;
-					break;
-				default: throw invalid_argument("Unexpected digit " + c);
-				}
+		return input;
+	}
+
+	int64_t fromSnafu(string_view number) {
+		int64_t value{ 0 };
+		for (char c : number) {
+			value *= 5;
+			switch (c) {
+			case '0': break;
+			case '1': {
+				value++;
+				break;
+			}
+			case '2': {
+				value += 2;
+				break;
+			}
+			case '-': {
+				value--;
+				break;
+			}
+			case '=':
+				value -= 2;
+				break;
+			default: throw invalid_argument("Unexpected digit " + c);
 			}
-			total += value;
 		}
+		return value;
+	}
 
-		// Now print that total in base 5.
+	string toSnafu(int64_t total) {
 		// special case where value is 0
-		if (total == 0) {
-			cout << 0 << endl;
-			return;
-		}
+		if (total == 0) return "0";
 		 
 		// We work out digits right -> left, so have to build up a vector and pop in reverse.
 		// If we really cared about efficiency, could use (modified) powers of 5 to get size of array up front.
@@ -82,24 +92,34 @@ namespace day25 {
 			total /= 5;
 		}
 
-		while (!encodedValue.empty()) {
-			cout << encodedValue.back(); encodedValue.pop_back();
+		return string(encodedValue.rbegin(), encodedValue.rend());
+	}
+
+	string solve1(const Input& input) {
+		int64_t total{ 0 };
+
+		for (const string& number : input.numbers) {
+			total += fromSnafu(number);
 		}
-		cout << endl; // 2-0-01==0-1=2212=100
+
+		// Now print that total in base 5.
+		return toSnafu(total); // 2-0-01==0-1=2212=100
 	}
 
-	void part2() {
-		ifstream input{ "Day25.txt" };
-		if (!input) throw invalid_argument("Failed to open Day25.txt");
+	// Final day only has the one puzzle
+	string solve2(const Input& input) {
+		return "";
 	}
 
-	void main() {
-		time_t start, end;
-		time(&start);
-		part1();
-		part2();
-		time(&end);
+	// Just a running total, stopping at a blank line like parse
+	pair<string, string> solveStream(StreamInput& in) {
+		int64_t total{ 0 };
+
+		string_view line;
+		while (in.nextLine(line) && line.length() > 0) {
+			total += fromSnafu(line);
+		}
 
-		cout << "Elapsed: " << (double)(end - start) << endl;
+		return { toSnafu(total), "" };
 	}
 }
\ No newline at end of file
@@ -1,7 +1,16 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <memory>
+#include <bit>
+#include <cstdint>
+#include <cctype>
+#include <stdexcept>
+
+#include "Input.h"
+#include "StreamInput.h"
 
 using namespace std;
 
@@ -17,94 +26,90 @@ int itemPriority(char item) {
 
 namespace day3 {
 
-    void processLine(string& line, int& total) {
-        size_t items = line.length();
-        size_t compartmentSize = items / 2;
-        set<char> compartment;
-
-        for (size_t i = 0; i < compartmentSize; i++) {
-            compartment.insert(line[i]);
+    // Bit per priority (1-52) of the items there, so set operations are single instructions
+    uint64_t itemSet(string_view items) {
+        uint64_t set = 0;
+        for (char item : items) {
+            if (!isalpha(static_cast<unsigned char>(item))) throw invalid_argument("Not an item: " + string(1, item));
+            set |= uint64_t{ 1 } << itemPriority(item);
         }
+        return set;
+    }
+
+    // Priority of the one item in all of them, or 0 if there isn't one
+    int sharedPriority(uint64_t shared) {
+        return shared == 0 ? 0 : countr_zero(shared);
+    }
+
+    void processLine(string_view line, int& total) {
+        size_t compartmentSize = line.length() / 2;
+        total += sharedPriority(itemSet(line.substr(0, compartmentSize)) & itemSet(line.substr(compartmentSize)));
+    }
+
+    // The one item all 3 rucksacks of a group share
+    int groupPriority(string_view rucksack1, string_view rucksack2, string_view rucksack3) {
+        return sharedPriority(itemSet(rucksack1) & itemSet(rucksack2) & itemSet(rucksack3));
+    }
 
-        for (size_t i = compartmentSize; i < items; i++) {
-            char item = line[i];
-            if (compartment.contains(item)) {
-                total += itemPriority(item);
-                return;
-            }
+    struct Input {
+        vector<string> rucksacks;
+    };
+
+    shared_ptr<const Input> parse(string_view text)
+    {
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
+
+        string_view line;
+        while (inputLines.next(line)) {
+            input->rucksacks.emplace_back(line);
         }
+
+        return input;
     }
 
-    void part1()
+    string solve1(const Input& input)
     {
-        ifstream input("Day3.txt");
         int total = 0;
 
-        string line;
-        while (getline(input, line)) {
-            processLine(line, total);
+        for (const string& rucksack : input.rucksacks) {
+            processLine(rucksack, total);
         }
 
-        cout << total << endl; // 7581
+        return to_string(total); // 7581
     }
 
 
-    void part2()
+    string solve2(const Input& input)
     {
-        ifstream input("Day3.txt");
         int total = 0;
 
-        string line;
-        set<char> sharedItems;
-        set<char> items2;
-
-        while (getline(input, line)) {
-            sharedItems.clear();
-            for (const char& c : line) {
-                sharedItems.insert(c);
-            }
-
-            // intersect with second set
-            getline(input, line);
-            items2.clear();
-            for (const char& c : line) {
-                items2.insert(c);
-            }
-            
-            // intersect, based on each set being sorted
-            set<char>::iterator it1 = sharedItems.begin();
-            set<char>::iterator it2 = items2.begin();
-            while (it1 != sharedItems.end() && it2 != items2.end()) {
-                if (*it1 < *it2) sharedItems.erase(it1++); // extra in sharedItems, remove
-                else if (*it2 < *it1) it2++; // extra in items2, skip
-                else {
-                    it1++;
-                    it2++;
-                }
-            }
-            sharedItems.erase(it1, sharedItems.end()); // anything remaining is extra
-
-            // 3rd set, look for the unique overlapping element
-            getline(input, line);
-            for (const char& c : line) {
-                if (sharedItems.contains(c)) {
-                    total += itemPriority(c);
-                    break;
-                }
-            }
+        const vector<string>& rucksacks = input.rucksacks;
+        for (size_t i = 0; i + 2 < rucksacks.size(); i += 3) {
+            total += groupPriority(rucksacks[i], rucksacks[i + 1], rucksacks[i + 2]);
         }
 
-        cout << total << endl; // 2525
+        return to_string(total); // 2525
     }
 
+    pair<string, string> solveStream(StreamInput& in)
+    {
+        int total1 = 0;
+        int total2 = 0;
+
+        // just the current group is kept, as lines are only valid until the next is read
+        array<string, 3> group;
+        size_t lineCount = 0;
 
-    int main() {
-        part2();
+        string_view line;
+        while (in.nextLine(line)) {
+            processLine(line, total1);
 
-        // wait to close
-        cin.get();
+            group[lineCount++ % 3] = line;
+            if (lineCount % 3 == 0) total2 += groupPriority(group[0], group[1], group[2]);
+        }
 
-        return 0;
+        return { to_string(total1), to_string(total2) };
     }
 
 }
\ No newline at end of file
@@ -1,57 +1,105 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <memory>
+
+#include "Input.h"
+#include "StreamInput.h"
 
 using namespace std;
 
 
-istream& readVals(ifstream& input, int& l1, int& l2, int& r1, int& r2) {
-    char sep;
-    // e.g. 1-3,2-4
-    return input
-        >> l1 >> sep >> r1
-        >> sep
-        >> l2 >> sep >> r2;
+// e.g. 1-3
+void readRange(string_view range, int& l, int& r) {
+    size_t dash = range.find('-');
+    l = parseNumber<int>(range.substr(0, dash));
+    r = parseNumber<int>(range.substr(dash + 1));
 }
 
-// Pred&& is a forward/universal referenece, already a deduced type, so takes an lvalue reference/rvalue reference (& or &&) as approriate.
-template<typename Pred> int countPredicate(ifstream& input, Pred&& p) {
-    int l1, l2, r1, r2;
-    int total = 0;
-    while (readVals(input, l1, l2, r1, r2)) {
-        total += p(l1, l2, r1, r2);
-    }
-    return total;
+// e.g. 1-3,2-4
+void readVals(string_view line, int& l1, int& l2, int& r1, int& r2) {
+    size_t comma = line.find(',');
+    readRange(line.substr(0, comma), l1, r1);
+    readRange(line.substr(comma + 1), l2, r2);
 }
 
-namespace day4 {
+bool readVals(Splitter& lines, int& l1, int& l2, int& r1, int& r2) {
+    string_view line;
+    if (!lines.next(line)) return false;
+    readVals(line, l1, l2, r1, r2);
+    return true;
+}
 
+bool fullyContains(int l1, int l2, int r1, int r2) {
+    return l1 <= l2 && r1 >= r2 || l2 <= l1 && r2 >= r1;
+}
 
-    void part1()
-    {
-        ifstream input("Day4.txt");
+bool overlaps(int l1, int l2, int r1, int r2) {
+    return l2 <= r1 && l1 <= r2;
+}
 
-        int total = countPredicate(input, [](int l1, int l2, int r1, int r2) { return l1 <= l2 && r1 >= r2 || l2 <= l1 && r2 >= r1; });
+namespace day4 {
 
-        cout << total << endl; // 424
+    // each pair of elves' section ranges l1-r1,l2-r2
+    struct Assignment {
+        int l1, r1, l2, r2;
+    };
+
+    struct Input {
+        vector<Assignment> pairs;
+    };
+
+    // Pred&& is a forward/universal referenece, already a deduced type, so takes an lvalue reference/rvalue reference (& or &&) as approriate.
+    template<typename Pred> int countPredicate(const Input& input, Pred&& p) {
+        int total = 0;
+        for (const auto& [l1, r1, l2, r2] : input.pairs) {
+            total += p(l1, l2, r1, r2);
+        }
+        return total;
     }
 
-    void part2()
+    shared_ptr<const Input> parse(string_view text)
     {
-        ifstream input("Day4.txt");
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
+
+        Assignment pair;
+        while (readVals(inputLines, pair.l1, pair.l2, pair.r1, pair.r2)) {
+            input->pairs.push_back(pair);
+        }
 
+        return input;
+    }
 
-        int total = countPredicate(input, [](int l1, int l2, int r1, int r2) { return l2 <= r1 && l1 <= r2; });
+    string solve1(const Input& input)
+    {
+        int total = countPredicate(input, fullyContains);
 
-        cout << total << endl; // 804
+        return to_string(total); // 424
     }
 
+    string solve2(const Input& input)
+    {
+        int total = countPredicate(input, overlaps);
 
-    int main() {
-        part2();
+        return to_string(total); // 804
+    }
 
-        return 0;
+    pair<string, string> solveStream(StreamInput& in)
+    {
+        int total1 = 0;
+        int total2 = 0;
+
+        string_view line;
+        int l1, l2, r1, r2;
+        while (in.nextLine(line)) {
+            readVals(line, l1, l2, r1, r2);
+            total1 += fullyContains(l1, l2, r1, r2);
+            total2 += overlaps(l1, l2, r1, r2);
+        }
+
+        return { to_string(total1), to_string(total2) };
     }
 
 }
\ No newline at end of file
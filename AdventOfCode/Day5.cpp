@@ -1,9 +1,12 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
+#include <string>
+#include <string_view>
 #include <vector>
 #include <deque>
 #include <algorithm>
+#include <memory>
+
+#include "Input.h"
+#include "Scanner.h"
 
 using namespace std;
 
@@ -22,28 +25,35 @@ namespace day5 {
         }
     }
 
-    // Uses a global working stack to effectively reverse the order twice
-    // Could be more efficient moving between vectors/arrays directly (can limit how much new allocation done), but not too bad (still O(1)).
-    deque<char> workingSpace;
+    // Moves the top n crates as one block, keeping their order
+    // (no shared working stack, so parts can run on several threads at once)
     void move2(deque<char>& from, deque<char>& to, int n) {
-        while (n-- > 0) {
-            workingSpace.push_back(from.back()); from.pop_back();
-        }
-        while (workingSpace.size() > 0) {
-            to.push_back(workingSpace.back()); workingSpace.pop_back();
-        }
+        to.insert(to.end(), from.end() - n, from.end());
+        from.erase(from.end() - n, from.end());
     }
 
-    template <typename Move>
-    void run(Move&& move)
+    // 'move N from A to B'
+    struct Instruction {
+        int n;
+        int fromCol;
+        int toCol;
+    };
+
+    struct Input {
+        vector<deque<char>> stacks; // first stack is a dummy to allow 1-indexing
+        vector<Instruction> instructions;
+    };
+
+    shared_ptr<const Input> parse(string_view text)
     {
-        ifstream input("Day5.txt");
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
 
         // first read in the starting shape
-        vector<deque<char>> stacks;
+        vector<deque<char>>& stacks = input->stacks;
 
-        string line;
-        while (getline(input, line)) {
+        string_view line;
+        while (inputLines.next(line)) {
             if (line.length() == 0) break; // second part
             for (int i = 0; i < line.length(); i += 4) {
                 if (line[i] == '[') {
@@ -58,30 +68,45 @@ namespace day5 {
 
         // each line now looks like:
         //  'move N from A to B'
-        int n, fromCol, toCol;
-        while (input.ignore(strlen("move ")) >> n) {
-            input.ignore(strlen(" from "));
-            input >> fromCol;
-            input.ignore(strlen(" to "));
-            input >> toCol;
+        while (inputLines.next(line)) {
+            Scanner moveLine(line);
+            Instruction instruction;
+            moveLine.expect("move ");
+            instruction.n = moveLine.number<int>();
+            moveLine.expect(" from ");
+            instruction.fromCol = moveLine.number<int>();
+            moveLine.expect(" to ");
+            instruction.toCol = moveLine.number<int>();
+            input->instructions.push_back(instruction);
+        }
 
+        return input;
+    }
+
+    template <typename Move>
+    string run(const Input& input, Move&& move)
+    {
+        vector<deque<char>> stacks = input.stacks;
+
+        for (const auto& [n, fromCol, toCol] : input.instructions) {
             deque<char>& from = stacks[fromCol];
             deque<char>& to = stacks[toCol];
        
-             move(from, to, n);
+            move(from, to, n);
         }
         
         // first stack is a dummy to allow 1-indexing
-        for_each(++stacks.begin(), stacks.end(), [](deque<char> stack) { cout << stack.back(); });
+        string tops;
+        for_each(++stacks.begin(), stacks.end(), [&tops](const deque<char>& stack) { tops += stack.back(); });
 
-        cout << endl; // part1 = TLFGBZHCN, part2 = QRQFHFWCL
+        return tops; // part1 = TLFGBZHCN, part2 = QRQFHFWCL
     }
 
-
-    int main() {
-        run(move2);
-
-        return 0;
+    string solve1(const Input& input) {
+        return run(input, move1);
     }
 
+    string solve2(const Input& input) {
+        return run(input, move2);
+    }
 }
\ No newline at end of file
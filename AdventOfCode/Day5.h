@@ -1,4 +1,13 @@
 #pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+
 namespace day5 {
-	int main();
-}
\ No newline at end of file
+	struct Input;
+
+	std::shared_ptr<const Input> parse(std::string_view text);
+	std::string solve1(const Input& input);
+	std::string solve2(const Input& input);
+}
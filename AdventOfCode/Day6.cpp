@@ -1,50 +1,108 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <deque>
+#include <string>
+#include <string_view>
 #include <map>
+#include <array>
 #include <stdexcept>
+#include <memory>
+#include <utility>
+
+#include "Input.h"
+#include "StreamInput.h"
+#include "Dispatch.h"
 
 using namespace std;
 
 namespace day6 {
 
-    void findMarker(size_t size) {
-        map<char, size_t> lastPosition;
-        ifstream input("Day6.txt");
+    // the datastream, without the trailing newline
+    struct Input {
+        string buffer;
+    };
 
-        char c;
+    shared_ptr<const Input> parse(string_view text) {
+        auto input = make_shared<Input>();
+        input->buffer = text.substr(0, text.find('\n'));
+        return input;
+    }
+
+    // Fed the datastream a character at a time, until the last `size` of them are all different
+    class MarkerFinder {
+    private:
+        const size_t size;
+        map<char, size_t> lastPosition;
 
+        // current run of distinct characters
         size_t start = 0;
         size_t end = 0;
 
-        while (end - start < size) {
-            if (!(input >> c)) {
-                throw invalid_argument("reached end of input");
-            }
+    public:
+        explicit MarkerFinder(size_t size) : size(size) {}
+
+        bool found() const {
+            return end - start >= size;
+        }
+
+        // Number of characters up to the end of the marker, once found
+        size_t position() const {
+            return end;
+        }
+
+        // Returns whether that completes the marker
+        bool add(char c) {
             auto position = lastPosition.find(c);
             if (position != lastPosition.end() && position->second >= start) {
                 start = position->second + 1;
             }
             lastPosition[c] = end;
-            end = input.tellg();
+            end++;
+            return found();
         }
+    };
+
+    // Window of the last SIZE characters, with a count of each character in it, specialised on SIZE (see Dispatch.h).
+    // Unlike MarkerFinder, needs the whole datastream up front.
+    template <int SIZE>
+    size_t findMarker(string_view text, int size) {
+        const size_t window = fixedOr<SIZE>(size);
+        array<int, 256> counts{};
+        int repeated = 0; // distinct characters in the window more than once
 
-        cout << end << endl;
+        for (size_t end = 0; end < text.size(); end++) {
+            if (++counts[static_cast<unsigned char>(text[end])] == 2) repeated++;
+            if (end >= window && --counts[static_cast<unsigned char>(text[end - window])] == 1) repeated--;
+            if (end + 1 >= window && repeated == 0) return end + 1;
+        }
+        throw invalid_argument("reached end of input");
     }
 
-    void part1() {
-        findMarker(4); // 1538 
+    size_t findMarker(const Input& input, int size) {
+        return dispatch<4, 14>(size, [&](auto n) { return findMarker<decltype(n)::value>(input.buffer, size); });
     }
 
-    void part2() {
-        findMarker(14); // 2315
+    string solve1(const Input& input) {
+        return to_string(findMarker(input, 4)); // 1538 
     }
 
-    int main() {
-        part2();
+    string solve2(const Input& input) {
+        return to_string(findMarker(input, 14)); // 2315
+    }
+
+    // Stops reading once both markers are found
+    pair<string, string> solveStream(StreamInput& in) {
+        MarkerFinder packet(4);
+        MarkerFinder message(14);
+
+        string_view chunk;
+        while (!message.found() && in.nextChunk(chunk)) {
+            for (char c : chunk) {
+                if (c == '\n') throw invalid_argument("reached end of input");
+                if (!packet.found()) packet.add(c);
+                if (message.add(c)) break;
+            }
+        }
+        if (!message.found()) throw invalid_argument("reached end of input");
 
-        return 0;
+        return { to_string(packet.position()), to_string(message.position()) };
     }
 
 }
\ No newline at end of file
@@ -1,17 +1,23 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
+#include <string>
+#include <string_view>
 #include <set>
 #include <limits>
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+
+#include "Input.h"
+#include "Arena.h"
 
 using namespace std;
 
 class File {
 private:
     const int size;
-    const string filename;
+    const string_view filename; // owned by the arena of the tree
 public:
-    File(int size, string filename) : size{ size }, filename{ filename } {}
+    File(int size, string_view filename) : size{ size }, filename{ filename } {}
 
     struct FileComparator {
         bool operator()(const File& f1, const File& f2) const {
@@ -24,11 +30,12 @@ public:
     }
 };
 
+// Every directory, and the names in it, live in one Arena that frees the whole tree at once
 class Directory {
 private:
     Directory* const parent;
-    const string dirname;
-    mutable int cachedSize = -1;
+    const string_view dirname;
+    int size = 0; // of everything under it, once the tree is complete (see calcSizes)
 
     struct DirectoryComparator {
         bool operator()(Directory* d1, Directory* d2) const {
@@ -37,21 +44,12 @@ private:
     };
 
     // Can potentially contain both a directory and file of the same name
-    set<Directory*, DirectoryComparator> subdirs;
-    set<File, File::FileComparator> files;
+    pmr::set<Directory*, DirectoryComparator> subdirs;
+    pmr::set<File, File::FileComparator> files;
 
-    void calcSize() const {
-        cachedSize = 0;
-        for (const Directory* d : subdirs) {
-            cachedSize += d->getSize();
-        }
+    Arena& arena;
 
-        for (const File f : files) {
-            cachedSize += f.getSize();
-        }
-    }
-
-    Directory* findDir(string path) {
+    Directory* findDir(string_view path) {
         auto it = find_if(subdirs.begin(), subdirs.end(), [path](const Directory* d) {
             return d->dirname == path;
         });
@@ -65,44 +63,31 @@ private:
     }
 
 public:
-    Directory(Directory* parent, string dirname) : parent{ parent }, dirname { dirname } {}
-
-    ~Directory() {
-        for (Directory* d : subdirs) {
-            delete d;
-        }
-    }
-
-    // Copy constructors take const arg, move constructors take non-const arg (else may as well just copy!)
-
-    // Copy constructors implicitly deleted by definition of move operations: https://en.cppreference.com/w/cpp/language/copy_constructor
-    // Prevent copying or assignment i.e. file systems are singletons, with a sole copy represented by the root 
-  //  Directory(const Directory& other) = delete;
-  //  Directory& operator=(const Directory& other) = delete;
-    
-    // Fine to move around (not too expensive, only the root is stack allocated), just don't create a copy.
-    // Would probably be better to just make all of these deleted and return a pointer to the root rather than the actual thing!
-    Directory(Directory&& other) = default;
-    Directory& operator=(Directory&& other) = default;
+    Directory(Directory* parent, string_view dirname, Arena& arena)
+        : parent{ parent }, dirname{ dirname }, subdirs{ &arena }, files{ &arena }, arena{ arena } {}
 
+    // Never destroyed, just freed along with the rest of the arena.
+    // Copying would leave the copied subdirectories pointing at the wrong parent, so don't.
+    Directory(const Directory& other) = delete;
+    Directory& operator=(const Directory& other) = delete;
 
-    Directory* addDir(const string name) {
+    Directory* addDir(string_view name) {
         if (Directory* d = findDir(name)) return d;
 
-        Directory* dir = new Directory(this, name);
+        Directory* dir = arena.make<Directory>(this, arena.copy(name), arena);
 
         subdirs.insert(dir);
 
         return dir;
     }
 
-    void addFile(File f) {
-        files.insert(f);
+    void addFile(int size, string_view filename) {
+        files.emplace(size, arena.copy(filename));
     }
 
     // Assumes we cd through one directory at a time.
     // (else would need to split on '/', and handle root directory specially)
-    Directory* cd(const string &path) {
+    Directory* cd(string_view path) {
         if (path == "..") {
             return parent;
         }
@@ -111,10 +96,22 @@ public:
         }
     }
 
-    int getSize() const {
-        if (cachedSize < 0) calcSize();
+    // Works out the size of this directory and everything under it. Call once the tree is complete,
+    // so the parsed tree is never written to again and both parts can read it at once.
+    int calcSizes() {
+        size = 0;
+        for (Directory* d : subdirs) {
+            size += d->calcSizes();
+        }
 
-        return cachedSize;
+        for (const File& f : files) {
+            size += f.getSize();
+        }
+        return size;
+    }
+
+    int getSize() const {
+        return size;
     }
 
     template<typename func_t>
@@ -129,46 +126,63 @@ public:
 
 namespace day7 {
 
-    Directory readRoot() {
-        ifstream input("Day7.txt");
+    Directory* readRoot(string_view text, Arena& arena) {
+        Tokens input(text);
 
-        Directory root((Directory*)nullptr, "/");
+        Directory* root = arena.make<Directory>(nullptr, "/", arena);
 
-        Directory* current = &root;
+        Directory* current = root;
 
 
-        string s;
-        input >> s; // "$", always start while loop on the next command
-        while (input >> s) {
+        // names are copied into the arena, since the tokens only point into the input text
+        string_view s;
+        input.next(s); // "$", always start while loop on the next command
+        while (input.next(s)) {
             if (s == "cd") {
-                input >> s;
+                input.next(s);
                 current = current->cd(s);
-                input >> s; // "$" for next command
+                input.next(s); // "$" for next command
             }
             else if (s == "ls") {
-                string dirOrSize, filename;
-                while (input >> dirOrSize) {
+                string_view dirOrSize, filename;
+                while (input.next(dirOrSize)) {
                     if (dirOrSize == "$") break; // end of output, next command
-                    input >> filename;
+                    input.next(filename);
                     if (dirOrSize == "dir") {
                         current->addDir(filename);
                     }
                     else {
-                        current->addFile(File(stoi(dirOrSize), filename));
+                        current->addFile(parseNumber<int>(dirOrSize), filename);
                     }
                 }
 
             }
             else {
-                throw invalid_argument("unknown command " + s);
+                throw invalid_argument("unknown command " + string(s));
             }
         }
 
         return root;
     }
 
-    void part1() {
-        Directory root = readRoot();
+    struct Input {
+        Arena arena; // owns the whole tree
+        // sizes included, so the tree is never changed after parsing
+        Directory* root = nullptr;
+
+        // Nodes and names take a few times the space of the text they're parsed from
+        explicit Input(size_t textSize) : arena(max<size_t>(Arena::DEFAULT_BLOCK_SIZE, textSize * 8)) {}
+    };
+
+    shared_ptr<const Input> parse(string_view text) {
+        auto input = make_shared<Input>(text.size());
+        input->root = readRoot(text, input->arena);
+        input->root->calcSizes();
+        return input;
+    }
+
+    string solve1(const Input& input) {
+        const Directory& root = *input.root;
 
         int totalSize = 0;
         root.forEachDir([&totalSize](const Directory* d) {
@@ -176,11 +190,11 @@ namespace day7 {
             if (dirSize <= 100000) totalSize += dirSize;
         });
 
-        cout << totalSize << endl; // 1444896
+        return to_string(totalSize); // 1444896
     }
 
-    void part2() {
-        Directory root = readRoot();
+    string solve2(const Input& input) {
+        const Directory& root = *input.root;
 
         int currentSize = root.getSize();
 
@@ -195,13 +209,7 @@ namespace day7 {
         if (dirSize >= toRemove && dirSize < smallestSuitable) smallestSuitable = dirSize;
         });
 
-        cout << smallestSuitable << endl; // 404395
-    }
-
-    int main() {
-        part2();
-
-        return 0;
+        return to_string(smallestSuitable); // 404395
     }
 
 }
\ No newline at end of file
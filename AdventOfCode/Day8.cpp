@@ -1,8 +1,18 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
+#include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <memory>
+#include <span>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "Input.h"
+#include "Grid2D.h"
+#include "Simd.h"
 
 using namespace std;
 
@@ -23,14 +33,14 @@ Direction opposite(const Direction& d) {
     }
 }
 
-class Point {
+class Cursor {
 public:
     size_t x;
     size_t y;
 
     // delegating constructor
-    Point() : Point(0, 0) {}
-    Point(size_t x, size_t y) : x(x), y(y) {}
+    Cursor() : Cursor(0, 0) {}
+    Cursor(size_t x, size_t y) : x(x), y(y) {}
 
     bool inBounds(size_t width, size_t height) {
         return x >= 0 && x < width&& y >= 0 && y < height;
@@ -61,32 +71,32 @@ public:
 
     // For scanning whole grid (ignoring edges) in direction Right,
     // start with (0, 1), and scan the row below after, until you reach (n-1, 0)
-    static Point firstScanFrom(const Direction& d, size_t gridWidth, size_t gridHeight) {
+    static Cursor firstScanFrom(const Direction& d, size_t gridWidth, size_t gridHeight) {
         switch (d)
         {
         case Up: // start bottom left
-            return Point(1, 0);
+            return Cursor(1, 0);
         case Down: // start top left
-            return Point(1, gridHeight - 1);
+            return Cursor(1, gridHeight - 1);
         case Left:
-            return Point(gridWidth - 1, 1);
+            return Cursor(gridWidth - 1, 1);
         case Right:
-            return Point(0, 1);
+            return Cursor(0, 1);
         default: throw out_of_range("Invalid enum value " + to_string(d));
         }
     }
 
-    static Point lastScanFrom(const Direction& d, size_t gridWidth, size_t gridHeight) {
+    static Cursor lastScanFrom(const Direction& d, size_t gridWidth, size_t gridHeight) {
         switch (d)
         {
         case Up: // last row is bottom right
-            return Point(gridWidth - 1, 0);
+            return Cursor(gridWidth - 1, 0);
         case Down: // last row is top right
-            return Point(gridWidth - 1, gridHeight - 1);
+            return Cursor(gridWidth - 1, gridHeight - 1);
         case Left:
-            return Point(gridWidth - 1, gridHeight - 1);
+            return Cursor(gridWidth - 1, gridHeight - 1);
         case Right:
-            return Point(0, gridHeight - 1);
+            return Cursor(0, gridHeight - 1);
         default: throw out_of_range("Invalid enum value " + to_string(d));
         }
     }
@@ -105,95 +115,159 @@ public:
         }
     }
 
-    bool operator==(const Point& other) const {
+    bool operator==(const Cursor& other) const {
         return x == other.x && y == other.y;
     }
 };
 
 
 namespace day8 {
-    // height not known in advance
-    vector<vector<int>> readGrid() {
-        ifstream input("Day8.txt");
+    struct Input {
+        Grid2D<uint8_t> grid; // tree heights, 0 to TALLEST
+    };
 
-        vector<vector<int>> result;
+    const int TALLEST = 9;
 
+    // height not known in advance
+    shared_ptr<const Input> parse(string_view text) {
+        Splitter inputLines(text);
 
-        string line;
-        while (getline(input, line)) {
-            vector<int> row;
-            for (char c : line) {
-                row.push_back(c - '0');
+        vector<string_view> lines;
+        string_view line;
+        while (inputLines.next(line)) {
+            lines.push_back(line);
+        }
+
+        auto input = make_shared<Input>();
+        int height = static_cast<int>(lines.size());
+        int width = height == 0 ? 0 : static_cast<int>(lines[0].size());
+        input->grid = Grid2D<uint8_t>(width, height);
+        for (int y = 0; y < height; y++) {
+            if (static_cast<int>(lines[y].size()) != width) throw invalid_argument("Rows of the grid differ in length");
+            span<uint8_t> row = input->grid.row(y);
+            for (int x = 0; x < width; x++) {
+                char c = lines[y][x];
+                if (c < '0' || c > '0' + TALLEST) throw invalid_argument("Not a tree height: " + string(1, c));
+                row[x] = static_cast<uint8_t>(c - '0');
             }
-            result.push_back(move(row));
         }
 
-        return result;
+        return input;
     }
 
-    void part1() {
-        vector<vector<int>> grid = readGrid();
-        size_t gridHeight = grid.size();
-        size_t gridWidth = grid[0].size();
-        // [m][n] only supported if n is a compile-time constant
-        // {} intializes everything to 0 (or could specify prefix of array values to populate)
-        bool* visible = new bool[gridHeight * gridWidth] {};
+    // Rows of bits, one per row of the grid (see Simd.h)
+    class RowMasks {
+    private:
+        size_t words;
+        vector<uint64_t> bits;
 
+    public:
+        RowMasks(int rows, int width) : words(simd::wordsFor(width)), bits(rows * words) {}
 
-        // TODO: Work out visible cells, probably using a separate structure?
-        // corners always visible, and not useful to examine,
-        // whereas each edge is considered when iterating from that side to the opposite edge
-        int visbleCount = 4;
+        uint64_t* row(int y) {
+            return bits.data() + y * words;
+        }
 
-        Direction dirs[] = { Up, Down, Left, Right };
-        
-        for (Direction d : dirs) {
-            Point start = Point::firstScanFrom(d, gridWidth, gridHeight);
-            Point end = Point::lastScanFrom(d, gridWidth, gridHeight);
+        size_t rowWords() const {
+            return words;
+        }
 
-            while (start != end) {
-                Point p = start;
-                int highest = -1;
+        size_t count() const {
+            return simd::popcount(bits.data(), bits.size());
+        }
 
-                // Slightly unnecessary checking the furthest edge,
-                // could have a separate 'inBoundsWithBorder(direction, width, height)' if we really wanted to avoid it
-                while (p.inBounds(gridWidth, gridHeight)) {
-                    int height = grid[p.y][p.x];
-                    if (height > highest) {
-                        if (!visible[p.y * gridWidth + p.x]) {
-                            visible[p.y * gridWidth + p.x] = true;
-                            visbleCount++;
-                        }
-                        highest = height;
-                    }
-                    p.move(d);
+        void clear() {
+            fill(bits.begin(), bits.end(), 0);
+        }
+
+        bool test(int y, int x) {
+            return (row(y)[x / 64] >> (x % 64)) & 1;
+        }
+
+        void set(int y, int x) {
+            row(y)[x / 64] |= uint64_t{ 1 } << (x % 64);
+        }
+
+        // -1 if the row is empty
+        int first(int y) {
+            for (size_t w = 0; w < words; w++) {
+                if (row(y)[w] != 0) return static_cast<int>(w * 64 + countr_zero(row(y)[w]));
+            }
+            return -1;
+        }
+
+        int last(int y) {
+            for (size_t w = words; w-- > 0;) {
+                if (row(y)[w] != 0) return static_cast<int>(w * 64 + 63 - countl_zero(row(y)[w]));
+            }
+            return -1;
+        }
+    };
+
+    // A tree is visible from the left when it's the first in its row at least as tall as it, and likewise from each other side.
+    // So with the trees of each height as rows of bits, whole rows are looked at in one go.
+    string solve1(const Input& input) {
+        const Grid2D<uint8_t>& grid = input.grid;
+        const int width = grid.width();
+        const int height = grid.height();
+
+        vector<RowMasks> exactly(TALLEST + 1, RowMasks(height, width));
+        vector<RowMasks> atLeast(TALLEST + 1, RowMasks(height, width));
+        const size_t words = exactly[0].rowWords();
+        for (int y = 0; y < height; y++) {
+            for (int h = TALLEST; h >= 0; h--) {
+                simd::equalMask(grid.row(y).data(), width, static_cast<uint8_t>(h), exactly[h].row(y));
+                if (h == TALLEST) copy_n(exactly[h].row(y), words, atLeast[h].row(y));
+                else simd::orMasks(exactly[h].row(y), atLeast[h + 1].row(y), atLeast[h].row(y), words);
+            }
+        }
+
+        RowMasks visible(height, width);
+        for (int y = 0; y < height; y++) {
+            for (int h = 0; h <= TALLEST; h++) {
+                for (int x : { atLeast[h].first(y), atLeast[h].last(y) }) {
+                    if (x >= 0 && exactly[h].test(y, x)) visible.set(y, x);
                 }
+            }
+        }
 
-                start.nextScanFrom(d);
+        // a row of trees at least each height in the rows passed so far
+        RowMasks blocked(TALLEST + 1, width);
+        vector<uint64_t> unblocked(words);
+        for (bool fromTop : { true, false }) {
+            blocked.clear();
+            for (int i = 0; i < height; i++) {
+                int y = fromTop ? i : height - 1 - i;
+                for (int h = 0; h <= TALLEST; h++) {
+                    simd::andNotMasks(exactly[h].row(y), blocked.row(h), unblocked.data(), words);
+                    simd::orMasks(visible.row(y), unblocked.data(), visible.row(y), words);
+                    simd::orMasks(blocked.row(h), atLeast[h].row(y), blocked.row(h), words);
+                }
             }
         }
 
-        cout << visbleCount << endl; // 1708
+        return to_string(visible.count()); // 1708
     }
 
-    void part2() {
-        vector<vector<int>> grid = readGrid();
-        size_t gridHeight = grid.size();
-        size_t gridWidth = grid[0].size();
+    string solve2(const Input& input) {
+        const Grid2D<uint8_t>& grid = input.grid;
+        size_t gridHeight = grid.height();
+        size_t gridWidth = grid.width();
 
-        int* visibleRange = new int[4 * gridHeight * gridWidth] {}; // all initialised to 0
+        // in each direction
+        vector<Grid2D<int>> visibleRange(4, Grid2D<int>(grid.width(), grid.height(), 0));
 
         Direction dirs[] = { Up, Down, Left, Right };
 
         
         for (Direction d : dirs) {
             Direction back = opposite(d);
-            Point start = Point::firstScanFrom(d, gridWidth, gridHeight);
+            Cursor start = Cursor::firstScanFrom(d, gridWidth, gridHeight);
             // No need to look at edge rows, will always have a multiplier of 0
-            Point end = Point::lastScanFrom(d, gridWidth, gridHeight);
+            Cursor end = Cursor::lastScanFrom(d, gridWidth, gridHeight);
 
             while (start != end) {
-                Point p = start;
+                Cursor p = start;
 
                 // index -> index of first tree of greater height else 0
                 // from that, can jump over trees in increasing height until first tree of equal or greater height found
@@ -203,20 +277,20 @@ namespace day8 {
                 // could have a separate 'inBoundsWithBorder(direction, width, height)' if we really wanted to avoid it
                 int idx = 0;
                 while (p.inBounds(gridWidth, gridHeight)) {
-                    int height = grid[p.y][p.x];
+                    int height = grid(p.x, p.y);
 
                     int higherIdxOrEdge = idx == 0 ? 0 : idx - 1;
-                    Point higherTreePos = Point(p);
+                    Cursor higherTreePos = Cursor(p);
                     higherTreePos.move(back); // will be ignored if we're already at the edge
                     // search until we find the edge, or a tree of equal or greater height
-                    while (higherIdxOrEdge > 0 && grid[higherTreePos.y][higherTreePos.x] < height) {
+                    while (higherIdxOrEdge > 0 && grid(higherTreePos.x, higherTreePos.y) < height) {
                         // need to keep searching
                         int newHigherIndex = firstHigherTree[higherIdxOrEdge];
                         higherTreePos.move(back, higherIdxOrEdge - newHigherIndex);
                         higherIdxOrEdge = newHigherIndex;
                     }
 
-                    if (higherIdxOrEdge > 0 && grid[higherTreePos.y][higherTreePos.x] == height) {
+                    if (higherIdxOrEdge > 0 && grid(higherTreePos.x, higherTreePos.y) == height) {
                         // equal height and not on edge, first higher tree is the higher tree (or edge) of the one we found
                         firstHigherTree.push_back(firstHigherTree[higherIdxOrEdge]);
                     }
@@ -225,7 +299,7 @@ namespace day8 {
                         firstHigherTree.push_back(higherIdxOrEdge);
                     }
 
-                    visibleRange[static_cast<int>(d) * gridHeight * gridWidth + p.y * gridWidth + p.x] = idx - higherIdxOrEdge;
+                    visibleRange[d](p.x, p.y) = idx - higherIdxOrEdge;
 
                     p.move(d);
                     idx++;
@@ -237,21 +311,16 @@ namespace day8 {
 
         // find greatest product
         int max = 0;
-        for (int i = 0; i < gridWidth * gridHeight; i++) {
-            int prod = 1;
-            for (int d = 0; d < 4; d++) {
-                prod *= visibleRange[d * gridHeight * gridWidth + i];
+        for (int y = 0; y < grid.height(); y++) {
+            span<const int> rows[4];
+            for (int d = 0; d < 4; d++) rows[d] = as_const(visibleRange[d]).row(y);
+            for (int x = 0; x < grid.width(); x++) {
+                int prod = rows[0][x] * rows[1][x] * rows[2][x] * rows[3][x];
+                if (prod > max) max = prod;
             }
-            if (prod > max) max = prod;
         }
 
-        cout << max << endl; // 504000
-    }
-
-    int main() {
-        part2();
-
-        return 0;
+        return to_string(max); // 504000
     }
 
 }
\ No newline at end of file
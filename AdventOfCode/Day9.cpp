@@ -1,9 +1,14 @@
-#include <iostream>
-#include <fstream>
-#include <string> // getline
-#include <set>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <type_traits>
 #include <cassert>
+#include <memory>
+
+#include "Input.h"
+#include "FlatPointSet.h"
+#include "Dispatch.h"
 
 using namespace std;
 
@@ -41,10 +46,12 @@ namespace day9 {
         auto operator<=>(const Point&) const = default;
     };
 
+    // Specialised on the number of knots (see Dispatch.h), so the common ropes keep them in a fixed-size array
+    template <int KNOTS>
     class Rope {
     private:
-        vector<Point> knots;
-        set<Point> tailVisited = { Point() };
+        conditional_t<KNOTS == DYNAMIC, vector<Point>, array<Point, KNOTS>> knots;
+        FlatPointSet<int> tailVisited;
 
         bool separated(const Point& head, const Point& tail) {
             return abs(head.x - tail.x) > 1 || abs(head.y - tail.y) > 1;
@@ -69,18 +76,20 @@ namespace day9 {
         }
 
     public:
-        Rope(const int size) : knots{ size } {
-            assert(size > 1);
+        Rope(const int size) {
+            assert(fixedOr<KNOTS>(size) == size && size > 1);
+            if constexpr (KNOTS == DYNAMIC) knots.resize(size);
+            tailVisited.insert({ 0, 0 });
         }
 
         void move(const char dir) {
             knots.front().move(dir);
 
-            for (int i = 1; i < knots.size(); i++) {
+            for (size_t i = 1; i < knots.size(); i++) {
                 catchUpTail(knots[i - 1], knots[i]);
             }
 
-            tailVisited.insert(knots.back());
+            tailVisited.insert({ knots.back().x, knots.back().y });
         }
 
         void move(const char dir, int steps) {
@@ -93,33 +102,49 @@ namespace day9 {
     };
 
 
-    void simulateRope(int size) {
-        ifstream input("Day9.txt");
-
-        Rope rope(size);
-
+    // e.g. R 4
+    struct Motion {
         char dir;
         int steps;
+    };
 
-        while (input >> dir >> steps) {
-            rope.move(dir, steps);
+    struct Input {
+        vector<Motion> motions;
+    };
+
+    shared_ptr<const Input> parse(string_view text) {
+        Splitter inputLines(text);
+        auto input = make_shared<Input>();
+
+        string_view line;
+        while (inputLines.next(line)) {
+            input->motions.push_back({ line[0], parseNumber<int>(line.substr(2)) });
         }
 
-        cout << rope.getVisited() << endl;
+        return input;
     }
 
-    void part1() {
-        simulateRope(2); // 5513
+    template <int KNOTS>
+    size_t simulateRope(const Input& input, int size) {
+        Rope<KNOTS> rope(size);
+
+        for (const auto& [dir, steps] : input.motions) {
+            rope.move(dir, steps);
+        }
+
+        return rope.getVisited();
     }
 
-    void part2() {
-        simulateRope(10);
+    size_t simulateRope(const Input& input, int size) {
+        return dispatch<2, 10>(size, [&](auto knots) { return simulateRope<decltype(knots)::value>(input, size); });
     }
 
-    int main() {
-        part2();
+    string solve1(const Input& input) {
+        return to_string(simulateRope(input, 2)); // 5513
+    }
 
-        return 0;
+    string solve2(const Input& input) {
+        return to_string(simulateRope(input, 10)); // 2427
     }
 
 }
\ No newline at end of file
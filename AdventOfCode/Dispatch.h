@@ -0,0 +1,49 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+/*
+Kernels templated on a size that's nearly always one of a few values (e.g. a rope of 2 or 10 knots),
+so the common cases get fixed-size arrays and constant loop bounds, with a generic version for anything else:
+
+	template <int KNOTS> size_t simulate(const Input& input, int knots) {
+		const int n = fixedOr<KNOTS>(knots);
+		...
+	}
+
+	return dispatch<2, 10>(knots, [&](auto k) { return simulate<decltype(k)::value>(input, knots); });
+
+The generic version is the same template with KNOTS = DYNAMIC, taking the runtime value instead.
+*/
+
+// Template argument for a kernel's generic version
+const int DYNAMIC = 0;
+
+// Size for a kernel specialised on N to use: N itself, or the runtime value in the DYNAMIC version
+template <int N>
+constexpr int fixedOr(int runtime) {
+	if constexpr (N == DYNAMIC) return runtime;
+	else return N;
+}
+
+namespace dispatch_detail {
+	template <typename F>
+	decltype(auto) pick(int, F&& f) {
+		return f(std::integral_constant<int, DYNAMIC>{});
+	}
+
+	template <int First, int... Rest, typename F>
+	decltype(auto) pick(int value, F&& f) {
+		if (value == First) return f(std::integral_constant<int, First>{});
+		return pick<Rest...>(value, std::forward<F>(f));
+	}
+}
+
+// f(integral_constant<int, V>) for whichever of Values equals value, otherwise f(integral_constant<int, DYNAMIC>).
+// Every instantiation of f must return the same type.
+template <int... Values, typename F>
+decltype(auto) dispatch(int value, F&& f) {
+	static_assert(((Values != DYNAMIC) && ...), "DYNAMIC is always the fallback");
+	return dispatch_detail::pick<Values...>(value, std::forward<F>(f));
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Point.h"
+
+/*
+Open-addressing hash set/map of points, for lookups in tight loops where std::unordered_set's
+node per entry and boost::hash_combine cost more than the work being done.
+
+Points live directly in one array (linear probing, at most half full), hashed by packing (x, y) into
+64 bits (scrambling y first for 64 bit coordinates) and multiplying by a Fibonacci constant. Erasing shifts later entries back rather than leaving
+tombstones, so tables that churn (erase one point, insert another) don't slow down.
+clear() keeps the memory for reuse, e.g. a per-round scratch map.
+
+The point with x and y both at their minimum value marks empty slots, so can't be stored.
+Iterating visits points in an arbitrary order, and erasing/inserting invalidates iterators.
+*/
+template <typename T, typename V>
+class FlatPointTable {
+protected:
+	// Values are only stored if V has any state, so sets cost nothing extra
+	static constexpr bool hasValues = !std::is_empty_v<V>;
+
+	static Point<T> emptySlot() {
+		return { std::numeric_limits<T>::min(), std::numeric_limits<T>::min() };
+	}
+
+	std::vector<Point<T>> keys; // emptySlot() where unused
+	std::vector<V> values; // alongside keys
+	std::size_t count = 0;
+	std::size_t mask = 0; // capacity - 1, capacity always a power of 2
+	int shift = 64; // 64 - log2(capacity), to take the top bits of the hash
+
+	static std::uint64_t pack(const Point<T>& p) {
+		if constexpr (sizeof(T) <= 4) {
+			// exact: x in the low 32 bits, and y recoverable from the high ones
+			return (static_cast<std::uint64_t>(p.y) << 32) ^ static_cast<std::uint64_t>(p.x);
+		}
+		else {
+			// wider ones don't both fit, so y is scrambled first (splitmix64's finaliser) to spread all of its bits
+			// over all 64, rather than shifting the top half of them out
+			std::uint64_t y = static_cast<std::uint64_t>(p.y);
+			y = (y ^ (y >> 30)) * 0xBF58476D1CE4E5B9ull;
+			y = (y ^ (y >> 27)) * 0x94D049BB133111EBull;
+			y ^= y >> 31;
+			return y ^ static_cast<std::uint64_t>(p.x);
+		}
+	}
+
+	std::size_t home(const Point<T>& p) const {
+		return static_cast<std::size_t>((pack(p) * 0x9E3779B97F4A7C15ull) >> shift);
+	}
+
+	// Slot holding p, or the empty slot where it would go
+	std::size_t slotFor(const Point<T>& p) const {
+		std::size_t i = home(p);
+		while (keys[i] != p && keys[i] != emptySlot()) i = (i + 1) & mask;
+		return i;
+	}
+
+	void rehash(std::size_t capacity) {
+		std::vector<Point<T>> oldKeys(capacity, emptySlot());
+		std::vector<V> oldValues(hasValues ? capacity : 0);
+		oldKeys.swap(keys);
+		oldValues.swap(values);
+		mask = capacity - 1;
+		shift = 64;
+		for (std::size_t c = capacity; c > 1; c >>= 1) shift--;
+
+		for (std::size_t i = 0; i < oldKeys.size(); i++) {
+			if (oldKeys[i] == emptySlot()) continue;
+			std::size_t slot = slotFor(oldKeys[i]);
+			keys[slot] = oldKeys[i];
+			if constexpr (hasValues) values[slot] = std::move(oldValues[i]);
+		}
+	}
+
+	// Slot for p, adding it (with a default value) if not present. Sets added if it was.
+	std::size_t insertSlot(const Point<T>& p, bool& added) {
+		if (p == emptySlot()) throw std::invalid_argument("Can't store the point used to mark empty slots");
+		if (keys.empty() || (count + 1) * 2 > keys.size()) rehash(std::max<std::size_t>(16, keys.size() * 2));
+
+		std::size_t slot = slotFor(p);
+		added = keys[slot] == emptySlot();
+		if (added) {
+			keys[slot] = p;
+			count++;
+		}
+		return slot;
+	}
+
+public:
+	class iterator {
+	private:
+		const Point<T>* slot;
+		const Point<T>* end;
+
+		void skipEmpty() {
+			while (slot != end && *slot == emptySlot()) slot++;
+		}
+
+	public:
+		iterator(const Point<T>* slot, const Point<T>* end) : slot(slot), end(end) {
+			skipEmpty();
+		}
+
+		const Point<T>& operator*() const {
+			return *slot;
+		}
+
+		iterator& operator++() {
+			slot++;
+			skipEmpty();
+			return *this;
+		}
+
+		bool operator==(const iterator& other) const {
+			return slot == other.slot;
+		}
+	};
+
+	std::size_t size() const {
+		return count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	// Room for n points without rehashing
+	void reserve(std::size_t n) {
+		std::size_t capacity = 16;
+		while (capacity < n * 2) capacity *= 2;
+		if (capacity > keys.size()) rehash(capacity);
+	}
+
+	// Keeps the memory
+	void clear() {
+		if (count == 0) return;
+		std::fill(keys.begin(), keys.end(), emptySlot());
+		if constexpr (hasValues) std::fill(values.begin(), values.end(), V());
+		count = 0;
+	}
+
+	bool contains(const Point<T>& p) const {
+		return !keys.empty() && keys[slotFor(p)] == p;
+	}
+
+	// Returns whether p was present
+	bool erase(const Point<T>& p) {
+		if (keys.empty()) return false;
+		std::size_t i = slotFor(p);
+		if (keys[i] != p) return false;
+
+		// shift back any later entries that would no longer be found past the gap
+		std::size_t j = i;
+		while (true) {
+			j = (j + 1) & mask;
+			if (keys[j] == emptySlot()) break;
+			std::size_t k = home(keys[j]);
+			// k cyclically in (i, j] means j's entry is still reachable, so leave it
+			bool reachable = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+			if (reachable) continue;
+
+			keys[i] = keys[j];
+			if constexpr (hasValues) values[i] = std::move(values[j]);
+			i = j;
+		}
+		keys[i] = emptySlot();
+		if constexpr (hasValues) values[i] = V();
+		count--;
+		return true;
+	}
+
+	iterator begin() const {
+		return { keys.data(), keys.data() + keys.size() };
+	}
+
+	iterator end() const {
+		return { keys.data() + keys.size(), keys.data() + keys.size() };
+	}
+};
+
+namespace flat_point_detail {
+	struct NoValue {};
+}
+
+template <typename T>
+class FlatPointSet : public FlatPointTable<T, flat_point_detail::NoValue> {
+public:
+	FlatPointSet() = default;
+
+	template <typename It>
+	FlatPointSet(It first, It last) {
+		this->reserve(static_cast<std::size_t>(std::distance(first, last)));
+		for (; first != last; ++first) insert(*first);
+	}
+
+	// Returns whether p was added (i.e. wasn't already present)
+	bool insert(const Point<T>& p) {
+		bool added;
+		this->insertSlot(p, added);
+		return added;
+	}
+};
+
+template <typename T, typename V>
+class FlatPointMap : public FlatPointTable<T, V> {
+public:
+	// Adds p with a default value if not present
+	V& operator[](const Point<T>& p) {
+		bool added;
+		return this->values[this->insertSlot(p, added)];
+	}
+
+	// Throws out_of_range if not present
+	const V& at(const Point<T>& p) const {
+		const V* value = find(p);
+		if (value == nullptr) throw std::out_of_range("Point not in map");
+		return *value;
+	}
+
+	// nullptr if not present
+	const V* find(const Point<T>& p) const {
+		if (this->keys.empty()) return nullptr;
+		std::size_t slot = this->slotFor(p);
+		return this->keys[slot] == p ? &this->values[slot] : nullptr;
+	}
+
+	// f(point, value) for every entry
+	template <typename F>
+	void forEach(F&& f) const {
+		for (std::size_t i = 0; i < this->keys.size(); i++) {
+			if (this->keys[i] != this->emptySlot()) f(this->keys[i], this->values[i]);
+		}
+	}
+};
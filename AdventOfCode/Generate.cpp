@@ -0,0 +1,82 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+
+#include "CommandLine.h"
+#include "Generators.h"
+
+using namespace std;
+
+// Writes a synthetic input for one day, e.g. to run with aoc -d 20 -i big.txt
+
+struct GenerateOptions {
+	int day = 0;
+	double scale = 1;
+	uint64_t seed = 1;
+	string outputPath; // empty = stdout
+	bool help = false;
+};
+
+void printUsage(const char* program) {
+	cout << "Usage: " << program << " -d DAY [options]\n"
+		<< "  -d, --day N          day to generate an input for\n"
+		<< "  -s, --scale X        size relative to the real input (default: 1)\n"
+		<< "      --seed N         random seed, the same seed gives the same input (default: 1)\n"
+		<< "  -o, --output PATH    write the input to PATH instead of stdout\n"
+		<< "  -h, --help           show this message" << endl;
+}
+
+GenerateOptions parseArgs(int argc, char* argv[]) {
+	GenerateOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		const string arg = argv[i];
+		auto value = [&]() -> string {
+			if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		if (arg == "-h" || arg == "--help") options.help = true;
+		else if (arg == "-d" || arg == "--day") options.day = parseInt(value());
+		else if (arg == "-s" || arg == "--scale") options.scale = stod(value());
+		else if (arg == "--seed") options.seed = stoull(value());
+		else if (arg == "-o" || arg == "--output") options.outputPath = value();
+		else throw invalid_argument("Unknown option " + arg);
+	}
+
+	if (options.day == 0 && !options.help) throw invalid_argument("Need a day to generate");
+
+	return options;
+}
+
+int main(int argc, char* argv[]) {
+	GenerateOptions options;
+	string text;
+	try {
+		options = parseArgs(argc, argv);
+		if (options.help) {
+			printUsage(argv[0]);
+			return 0;
+		}
+		text = generateInput(options.day, options.scale, options.seed);
+	}
+	catch (const exception& e) {
+		cerr << e.what() << endl;
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (options.outputPath.empty()) {
+		cout << text;
+	}
+	else {
+		ofstream output{ options.outputPath, ios::binary };
+		if (!output || !(output << text)) {
+			cerr << "Failed to write " << options.outputPath << endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,768 @@
+#include <string>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include "Generators.h"
+
+using namespace std;
+
+namespace {
+	class Random {
+	private:
+		mt19937_64 engine;
+
+	public:
+		explicit Random(uint64_t seed) : engine(seed) {}
+
+		// inclusive
+		int64_t between(int64_t min, int64_t max) {
+			return uniform_int_distribution<int64_t>(min, max)(engine);
+		}
+
+		bool chance(double p) {
+			return uniform_real_distribution<double>(0, 1)(engine) < p;
+		}
+
+		template <typename T>
+		const T& pick(const vector<T>& options) {
+			return options[between(0, options.size() - 1)];
+		}
+
+		template <typename T>
+		void shuffle(vector<T>& values) {
+			std::shuffle(values.begin(), values.end(), engine);
+		}
+	};
+
+	// base (the size of the real input) grown by scale
+	int scaled(double base, double scale) {
+		return max(1, static_cast<int>(llround(base * scale)));
+	}
+
+	// for 2D grids, so the area grows with scale
+	int scaledSide(double base, double scale) {
+		return scaled(base, sqrt(scale));
+	}
+
+	// Lower case names that are unique within one input, e.g. for directories or monkeys
+	string letters(uint64_t n, size_t minLength) {
+		string name;
+		do {
+			name += static_cast<char>('a' + n % 26);
+			n /= 26;
+		} while (n > 0 || name.size() < minLength);
+		return name;
+	}
+
+	string upper(string s) {
+		for (char& c : s) c = static_cast<char>(toupper(c));
+		return s;
+	}
+
+	// Calorie counts, one elf per blank-line separated group
+	string day1(double scale, Random& random) {
+		ostringstream out;
+		int elves = scaled(250, scale);
+		for (int elf = 0; elf < elves; elf++) {
+			if (elf > 0) out << '\n';
+			int items = static_cast<int>(random.between(1, 15));
+			for (int i = 0; i < items; i++) out << random.between(1000, 70000) << '\n';
+		}
+		return out.str();
+	}
+
+	// 'A Y' rounds of rock paper scissors
+	string day2(double scale, Random& random) {
+		ostringstream out;
+		int rounds = scaled(2500, scale);
+		for (int i = 0; i < rounds; i++) {
+			out << static_cast<char>('A' + random.between(0, 2)) << ' ' << static_cast<char>('X' + random.between(0, 2)) << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	Rucksacks in groups of 3, where the two halves of each share exactly one item type,
+	and the three rucksacks of a group share exactly one (the badge).
+	Every other item type is kept out of at least one rucksack of the group, and each one's
+	remaining types are split between its halves, so neither gets an accidental second match.
+	*/
+	string day3(double scale, Random& random) {
+		const string items = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+		ostringstream out;
+		int groups = scaled(100, scale);
+		for (int group = 0; group < groups; group++) {
+			char badge = items[random.between(0, items.size() - 1)];
+			vector<int> excludedFrom(items.size());
+			for (int& e : excludedFrom) e = static_cast<int>(random.between(0, 2));
+
+			for (int rucksack = 0; rucksack < 3; rucksack++) {
+				vector<char> left, right;
+				for (size_t i = 0; i < items.size(); i++) {
+					if (items[i] == badge || excludedFrom[i] == rucksack) continue;
+					(random.chance(0.5) ? left : right).push_back(items[i]);
+				}
+				// shared between halves, taken from one side so it's in neither pool
+				vector<char>& from = left.size() > right.size() ? left : right;
+				size_t sharedIdx = random.between(0, from.size() - 1);
+				char shared = from[sharedIdx];
+				from.erase(from.begin() + sharedIdx);
+
+				int half = static_cast<int>(random.between(8, 16));
+				string first{ shared, badge }, second{ shared };
+				while (static_cast<int>(first.size()) < half) first += random.pick(left);
+				while (static_cast<int>(second.size()) < half) second += random.pick(right);
+
+				vector<char> a(first.begin(), first.end()), b(second.begin(), second.end());
+				random.shuffle(a);
+				random.shuffle(b);
+				out << string(a.begin(), a.end()) << string(b.begin(), b.end()) << '\n';
+			}
+		}
+		return out.str();
+	}
+
+	// 'a-b,c-d' pairs of section assignments
+	string day4(double scale, Random& random) {
+		ostringstream out;
+		int pairs = scaled(1000, scale);
+		for (int i = 0; i < pairs; i++) {
+			int64_t a = random.between(1, 99), b = random.between(a, 99);
+			int64_t c = random.between(1, 99), d = random.between(c, 99);
+			out << a << '-' << b << ',' << c << '-' << d << '\n';
+		}
+		return out.str();
+	}
+
+	// Drawing of 9 stacks, then moves that always leave at least one crate on every stack
+	string day5(double scale, Random& random) {
+		const int STACKS = 9;
+		vector<string> stacks(STACKS);
+		int maxHeight = scaledSide(8, scale);
+		for (string& stack : stacks) {
+			int height = static_cast<int>(random.between(max(1, maxHeight / 2), maxHeight));
+			for (int i = 0; i < height; i++) stack += static_cast<char>('A' + random.between(0, 25));
+		}
+
+		ostringstream out;
+		size_t tallest = 0;
+		for (const string& stack : stacks) tallest = max(tallest, stack.size());
+		for (size_t level = tallest; level-- > 0;) {
+			string row;
+			for (const string& stack : stacks) {
+				if (!row.empty()) row += ' ';
+				row += stack.size() > level ? string{ '[', stack[level], ']' } : "   ";
+			}
+			out << row << '\n';
+		}
+		for (int i = 1; i <= STACKS; i++) out << ' ' << i << ' ' << (i < STACKS ? " " : "\n");
+		out << '\n';
+
+		int moves = scaled(500, scale);
+		for (int i = 0; i < moves; i++) {
+			vector<int> movable;
+			for (int s = 0; s < STACKS; s++) {
+				if (stacks[s].size() > 1) movable.push_back(s);
+			}
+			int from = random.pick(movable);
+			int to = static_cast<int>(random.between(0, STACKS - 2));
+			if (to >= from) to++;
+			int n = static_cast<int>(random.between(1, min<int64_t>(stacks[from].size() - 1, 30)));
+
+			stacks[to] += stacks[from].substr(stacks[from].size() - n);
+			stacks[from].resize(stacks[from].size() - n);
+			out << "move " << n << " from " << from + 1 << " to " << to + 1 << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	One long datastream, with few enough distinct letters early on that the markers only turn up later.
+	Ends in 14 different letters, so there's always a message marker somewhere.
+	*/
+	string day6(double scale, Random& random) {
+		const int MARKER = 14;
+		int length = max(MARKER, scaled(4095, scale)) - MARKER;
+		string stream;
+		for (int i = 0; i < length; i++) {
+			int alphabet = i < length * 4 / 10 ? 3 : i < length * 8 / 10 ? 13 : 26;
+			stream += static_cast<char>('a' + random.between(0, alphabet - 1));
+		}
+		vector<char> marker;
+		for (int i = 0; i < 26; i++) marker.push_back(static_cast<char>('a' + i));
+		random.shuffle(marker);
+		return stream + string(marker.begin(), marker.begin() + MARKER) + '\n';
+	}
+
+	// Terminal session exploring a random directory tree. File sizes shrink as it grows, so totals fit in an int.
+	string day7(double scale, Random& random) {
+		int dirs = scaled(180, scale);
+		vector<vector<int>> children(dirs);
+		for (int d = 1; d < dirs; d++) children[random.between(0, d - 1)].push_back(d);
+
+		int maxFileSize = max(1, static_cast<int>(300000 / max(1.0, scale)));
+		const vector<string> extensions{ "", ".txt", ".dat", ".log", ".bin" };
+		uint64_t nextFile = 0;
+
+		ostringstream out;
+		out << "$ cd /\n";
+		function<void(int)> visit = [&](int dir) {
+			out << "$ ls\n";
+			for (int child : children[dir]) out << "dir " << letters(child, 3) << '\n';
+			int files = static_cast<int>(random.between(0, 4));
+			for (int f = 0; f < files; f++) {
+				out << random.between(1, maxFileSize) << ' ' << letters(nextFile++, 3) << random.pick(extensions) << '\n';
+			}
+			for (int child : children[dir]) {
+				out << "$ cd " << letters(child, 3) << '\n';
+				visit(child);
+				out << "$ cd ..\n";
+			}
+		};
+		visit(0);
+		return out.str();
+	}
+
+	// Square grid of tree heights
+	string day8(double scale, Random& random) {
+		int size = scaledSide(99, scale);
+		ostringstream out;
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) out << static_cast<char>('0' + random.between(0, 9));
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	// 'R 4' head motions
+	string day9(double scale, Random& random) {
+		const string directions = "RLUD";
+		ostringstream out;
+		int motions = scaled(2000, scale);
+		for (int i = 0; i < motions; i++) {
+			out << directions[random.between(0, 3)] << ' ' << random.between(1, 20) << '\n';
+		}
+		return out.str();
+	}
+
+	// noop/addx program, running for at least the 240 cycles the display needs, with X kept on screen
+	string day10(double scale, Random& random) {
+		int instructions = scaled(147, scale);
+		ostringstream out;
+		int x = 1;
+		int cycles = 0;
+		for (int i = 0; i < instructions || cycles < 240; i++) {
+			if (random.chance(0.4)) {
+				out << "noop\n";
+				cycles++;
+				continue;
+			}
+			int n = static_cast<int>(random.between(-10, 10));
+			if (x + n < 0 || x + n > 39) n = -n;
+			x += n;
+			cycles += 2;
+			out << "addx " << n << '\n';
+		}
+		return out.str();
+	}
+
+	struct MonkeySpec {
+		char op; // '+', '*' or 's' for old * old
+		int value;
+		int divTest;
+		int ifTrue;
+		int ifFalse;
+		vector<int64_t> items;
+	};
+
+	// Whether part 1 (worry divided by 3, no modulo) stays within an int, as the solver requires
+	bool monkeysStaySmall(vector<MonkeySpec> monkeys) {
+		for (int round = 0; round < 20; round++) {
+			for (MonkeySpec& monkey : monkeys) {
+				for (int64_t item : monkey.items) {
+					int64_t worry = monkey.op == '+' ? item + monkey.value : monkey.op == '*' ? item * monkey.value : item * item;
+					worry /= 3;
+					if (worry > numeric_limits<int>::max()) return false;
+					monkeys[worry % monkey.divTest == 0 ? monkey.ifTrue : monkey.ifFalse].items.push_back(worry);
+				}
+				monkey.items.clear();
+			}
+		}
+		return true;
+	}
+
+	/*
+	Monkeys testing divisibility by the first 8 primes (repeated, as the LCM has to stay small enough to square),
+	retried until part 1's worry levels stay within an int like the real inputs do.
+	*/
+	string day11(double scale, Random& random) {
+		const vector<int> PRIMES{ 2, 3, 5, 7, 11, 13, 17, 19 };
+		int count = max(2, scaled(8, scale));
+
+		vector<MonkeySpec> monkeys;
+		do {
+			monkeys.clear();
+			for (int i = 0; i < count; i++) {
+				MonkeySpec monkey;
+				int kind = static_cast<int>(random.between(0, 7));
+				monkey.op = kind == 0 ? 's' : kind <= 4 ? '+' : '*';
+				monkey.value = static_cast<int>(monkey.op == '+' ? random.between(1, 8) : random.between(2, 19));
+				monkey.divTest = PRIMES[(i + random.between(0, PRIMES.size() - 1)) % PRIMES.size()];
+				monkey.ifTrue = static_cast<int>(random.between(0, count - 2));
+				if (monkey.ifTrue >= i) monkey.ifTrue++;
+				do {
+					monkey.ifFalse = static_cast<int>(random.between(0, count - 2));
+					if (monkey.ifFalse >= i) monkey.ifFalse++;
+				} while (count > 2 && monkey.ifFalse == monkey.ifTrue);
+				int items = static_cast<int>(random.between(1, 8));
+				for (int j = 0; j < items; j++) monkey.items.push_back(random.between(50, 99));
+				monkeys.push_back(monkey);
+			}
+		} while (!monkeysStaySmall(monkeys));
+
+		ostringstream out;
+		for (size_t i = 0; i < monkeys.size(); i++) {
+			const MonkeySpec& monkey = monkeys[i];
+			if (i > 0) out << '\n';
+			out << "Monkey " << i << ":\n  Starting items: ";
+			for (size_t j = 0; j < monkey.items.size(); j++) out << (j > 0 ? ", " : "") << monkey.items[j];
+			out << "\n  Operation: new = old ";
+			if (monkey.op == 's') out << "* old\n";
+			else out << monkey.op << ' ' << monkey.value << '\n';
+			out << "  Test: divisible by " << monkey.divTest << '\n'
+				<< "    If true: throw to monkey " << monkey.ifTrue << '\n'
+				<< "    If false: throw to monkey " << monkey.ifFalse << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	Heights rising from 'a' on the left to 'z' on the right, never by more than 1 per column,
+	with random dips everywhere except S and E's row, so there's always a path along it.
+	*/
+	string day12(double scale, Random& random) {
+		int rows = scaledSide(41, scale);
+		int cols = max(26, scaledSide(159, scale));
+		int pathRow = static_cast<int>(random.between(0, rows - 1));
+
+		ostringstream out;
+		for (int y = 0; y < rows; y++) {
+			for (int x = 0; x < cols; x++) {
+				int height = x * 25 / (cols - 1);
+				if (y != pathRow && random.chance(0.3)) height = static_cast<int>(random.between(0, height));
+
+				if (y == pathRow && x == 0) out << 'S';
+				else if (y == pathRow && x == cols - 1) out << 'E';
+				else out << static_cast<char>('a' + height);
+			}
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	void packet(Random& random, int depth, ostringstream& out) {
+		out << '[';
+		int length = static_cast<int>(random.between(0, 5));
+		for (int i = 0; i < length; i++) {
+			if (i > 0) out << ',';
+			if (depth < 4 && random.chance(0.3)) packet(random, depth + 1, out);
+			else out << random.between(0, 10);
+		}
+		out << ']';
+	}
+
+	// Pairs of nested list packets, separated by blank lines
+	string day13(double scale, Random& random) {
+		ostringstream out;
+		int pairs = scaled(150, scale);
+		for (int i = 0; i < pairs; i++) {
+			if (i > 0) out << '\n';
+			packet(random, 0, out);
+			out << '\n';
+			packet(random, 0, out);
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	Rock paths below the sand source at (500, 0): mostly cups (wall, floor, wall) that catch sand, plus some flat ledges.
+	Part 2 fills a triangle as deep as the lowest rock, so the depth only grows with the square root of scale.
+	*/
+	string day14(double scale, Random& random) {
+		int depth = scaledSide(170, scale);
+		int paths = scaled(112, scale);
+		ostringstream out;
+		for (int i = 0; i < paths; i++) {
+			int64_t left = 500 + random.between(-depth / 2, depth / 2);
+			int64_t right = left + random.between(2, 12);
+			int64_t floor = random.between(max(4, depth / 10), depth);
+			if (random.chance(0.3)) {
+				out << left << ',' << floor << " -> " << right << ',' << floor << '\n';
+				continue;
+			}
+			int64_t leftTop = max<int64_t>(2, floor - random.between(1, 8));
+			int64_t rightTop = max<int64_t>(2, floor - random.between(1, 8));
+			out << left << ',' << leftTop << " -> " << left << ',' << floor << " -> "
+				<< right << ',' << floor << " -> " << right << ',' << rightTop << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	Sensors covering all of the 4M x 4M search area except one point P. In u = x + y, v = x - y coordinates
+	each sensor covers a square, so they're laid out as a grid of squares left and right of P's u,
+	plus a column of them above and below P itself, each stopping just short of P.
+	Squares have an even half-width so their centres land on whole x, y.
+	*/
+	string day15(double scale, Random& random) {
+		const int64_t LIMIT = 4'000'000;
+		int64_t px = random.between(LIMIT / 4, LIMIT * 3 / 4);
+		int64_t py = random.between(LIMIT / 4, LIMIT * 3 / 4);
+		int64_t pu = px + py, pv = px - py;
+
+		double sensors = 30 * scale;
+		int64_t r = max<int64_t>(2, static_cast<int64_t>(LIMIT / sqrt(2 * sensors)) / 2 * 2);
+
+		ostringstream out;
+		auto emit = [&](int64_t cu, int64_t cv) {
+			int64_t x = (cu + cv) / 2, y = (cu - cv) / 2;
+			// skip any that don't reach the search area at all
+			int64_t outside = max<int64_t>({ 0, -x, x - LIMIT }) + max<int64_t>({ 0, -y, y - LIMIT });
+			if (outside > r) return;
+			out << "Sensor at x=" << x << ", y=" << y << ": closest beacon is at x=" << x + r << ", y=" << y << '\n';
+		};
+
+		// v range [-LIMIT, LIMIT] covered by squares centred every 2r
+		auto column = [&](int64_t cu, int64_t offset) {
+			int64_t first = (-LIMIT - pv - offset - r) / (2 * r) - 1;
+			int64_t last = (LIMIT - pv - offset + r) / (2 * r) + 1;
+			for (int64_t j = first; j <= last; j++) emit(cu, pv + offset + 2 * r * j);
+		};
+
+		for (int64_t cu = pu + 1 + r; cu - r <= 2 * LIMIT; cu += 2 * r) column(cu, 1);
+		for (int64_t cu = pu - 1 - r; cu + r >= 0; cu -= 2 * r) column(cu, 1);
+		for (int64_t cv = pv + 2 + r; cv - r <= LIMIT; cv += 2 * r) emit(pu, cv);
+		for (int64_t cv = pv - 2 - r; cv + r >= -LIMIT; cv -= 2 * r) emit(pu, cv);
+
+		return out.str();
+	}
+
+	/*
+	Tunnels of a random connected graph, with AA and ~45 other valves (growing with scale) at flow 0.
+	Only 15 valves have any flow, however big it gets, since the search is exponential in those.
+	*/
+	string day16(double scale, Random& random) {
+		int valves = max(2, scaled(60, scale));
+		size_t nameLength = valves <= 26 * 26 ? 2 : 3;
+		vector<string> names;
+		for (int i = 0; i < valves; i++) names.push_back(upper(letters(i, nameLength)));
+
+		vector<int> flows(valves, 0);
+		vector<int> others(valves - 1);
+		iota(others.begin(), others.end(), 1);
+		random.shuffle(others);
+		for (int i = 0; i < min(15, valves - 1); i++) flows[others[i]] = static_cast<int>(random.between(3, 25));
+
+		vector<set<int>> tunnels(valves);
+		auto connect = [&](int a, int b) {
+			if (a == b) return;
+			tunnels[a].insert(b);
+			tunnels[b].insert(a);
+		};
+		for (int i = 1; i < valves; i++) connect(i, static_cast<int>(random.between(0, i - 1)));
+		for (int i = 0; i < valves / 4; i++) connect(static_cast<int>(random.between(0, valves - 1)), static_cast<int>(random.between(0, valves - 1)));
+
+		vector<int> order(valves);
+		iota(order.begin(), order.end(), 0);
+		random.shuffle(order);
+
+		ostringstream out;
+		for (int v : order) {
+			out << "Valve " << names[v] << " has flow rate=" << flows[v];
+			out << (tunnels[v].size() == 1 ? "; tunnel leads to valve " : "; tunnels lead to valves ");
+			bool first = true;
+			for (int t : tunnels[v]) {
+				out << (first ? "" : ", ") << names[t];
+				first = false;
+			}
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	// Jet pattern
+	string day17(double scale, Random& random) {
+		int length = scaled(10091, scale);
+		string jets;
+		for (int i = 0; i < length; i++) jets += random.chance(0.5) ? '<' : '>';
+		return jets + '\n';
+	}
+
+	// Lumpy ball of cubes with holes in it, so part 2 has air pockets to exclude
+	string day18(double scale, Random& random) {
+		int size = max(3, scaled(20, cbrt(scale)));
+		double centre = (size - 1) / 2.0;
+		ostringstream out;
+		for (int x = 0; x < size; x++) {
+			for (int y = 0; y < size; y++) {
+				for (int z = 0; z < size; z++) {
+					double distance = sqrt((x - centre) * (x - centre) + (y - centre) * (y - centre) + (z - centre) * (z - centre));
+					if (distance <= centre * random.between(80, 100) / 100.0 && random.chance(0.7)) {
+						out << x << ',' << y << ',' << z << '\n';
+					}
+				}
+			}
+		}
+		return out.str();
+	}
+
+	// Robot blueprints, with costs in the same ranges as the real ones
+	string day19(double scale, Random& random) {
+		ostringstream out;
+		int blueprints = max(3, scaled(30, scale));
+		for (int id = 1; id <= blueprints; id++) {
+			out << "Blueprint " << id << ": Each ore robot costs " << random.between(2, 4)
+				<< " ore. Each clay robot costs " << random.between(2, 4)
+				<< " ore. Each obsidian robot costs " << random.between(2, 4) << " ore and " << random.between(5, 20)
+				<< " clay. Each geode robot costs " << random.between(2, 4) << " ore and " << random.between(7, 20) << " obsidian.\n";
+		}
+		return out.str();
+	}
+
+	// Numbers to mix, exactly one of which is 0
+	string day20(double scale, Random& random) {
+		int count = max(2, scaled(5000, scale));
+		int64_t zeroAt = random.between(0, count - 1);
+		ostringstream out;
+		for (int i = 0; i < count; i++) {
+			int64_t value = 0;
+			if (i != zeroAt) {
+				do {
+					value = random.between(-10000, 10000);
+				} while (value == 0);
+			}
+			out << value << '\n';
+		}
+		return out.str();
+	}
+
+	/*
+	Monkey expression tree. humn is a leaf at the bottom of a chain of +, - and * (by a small constant),
+	so part 2 can be solved by inverting each step exactly. Everything off that chain is a balanced random
+	subtree whose divisions are exact. root's other side is adjusted to equal the chain for part 2's answer.
+	*/
+	class MonkeyTree {
+	private:
+		Random& random;
+		vector<string> lines;
+		set<string> used{ "root", "humn" };
+
+	public:
+		explicit MonkeyTree(Random& random) : random(random) {}
+
+		string name() {
+			string n;
+			do {
+				n = letters(random.between(0, 26 * 26 * 26 * 26 - 1), 4);
+			} while (used.contains(n));
+			used.insert(n);
+			return n;
+		}
+
+		void leaf(const string& n, int64_t value) {
+			lines.push_back(n + ": " + to_string(value));
+		}
+
+		void node(const string& n, const string& left, char op, const string& right) {
+			lines.push_back(n + ": " + left + " " + op + " " + right);
+		}
+
+		// Subtree of about size monkeys, returning its name and setting its value
+		string subtree(int size, int64_t& value) {
+			string n = name();
+			if (size < 3) {
+				value = random.between(1, 20);
+				leaf(n, value);
+				return n;
+			}
+
+			int leftSize = static_cast<int>(random.between((size - 1) / 4, (size - 1) * 3 / 4));
+			leftSize = max(1, min(leftSize, size - 2));
+			int64_t leftValue, rightValue;
+			string left = subtree(leftSize, leftValue);
+			string right = subtree(size - 1 - leftSize, rightValue);
+
+			char op = "+-*/"[random.between(0, 3)];
+			if (op == '*' && abs(leftValue * rightValue) > 1'000'000) op = '+';
+			if (op == '/' && (rightValue == 0 || leftValue % rightValue != 0)) op = '-';
+			value = op == '+' ? leftValue + rightValue : op == '-' ? leftValue - rightValue : op == '*' ? leftValue * rightValue : leftValue / rightValue;
+			node(n, left, op, right);
+			return n;
+		}
+
+		string str() {
+			random.shuffle(lines);
+			ostringstream out;
+			for (const string& line : lines) out << line << '\n';
+			return out.str();
+		}
+	};
+
+	string day21(double scale, Random& random) {
+		int monkeys = max(10, scaled(2643, scale));
+		int chain = min(70, monkeys / 10);
+		// rest spread over a subtree off each step of the chain, and root's other side
+		int perSubtree = max(1, (monkeys - 2 * chain - 3) / (chain + 1));
+
+		MonkeyTree tree(random);
+		int64_t part1Human = random.between(1, 4000);
+		int64_t part2Human = random.between(1, 100000);
+		tree.leaf("humn", part1Human);
+
+		string below = "humn";
+		int64_t value1 = part1Human, value2 = part2Human;
+		for (int i = 0; i < chain; i++) {
+			string n = tree.name();
+			char op = random.chance(0.15) ? '*' : random.chance(0.5) ? '+' : '-';
+			int64_t other;
+			string otherName;
+			if (op == '*') {
+				other = random.between(2, 5);
+				otherName = tree.name();
+				tree.leaf(otherName, other);
+				// keep clear of overflow, however long the chain
+				if (abs(value2) > 1'000'000'000'000LL || abs(value1) > 1'000'000'000'000LL) op = '+';
+			}
+			else otherName = tree.subtree(perSubtree, other);
+
+			bool humanLeft = op != '-' || random.chance(0.5);
+			auto apply = [&](int64_t v) {
+				if (op == '+') return v + other;
+				if (op == '*') return v * other;
+				return humanLeft ? v - other : other - v;
+			};
+			value1 = apply(value1);
+			value2 = apply(value2);
+			if (humanLeft) tree.node(n, below, op, otherName);
+			else tree.node(n, otherName, op, below);
+			below = n;
+		}
+
+		int64_t otherValue;
+		string other = tree.subtree(perSubtree, otherValue);
+		string adjusted = tree.name();
+		string adjustment = tree.name();
+		tree.leaf(adjustment, abs(value2 - otherValue));
+		tree.node(adjusted, other, value2 >= otherValue ? '+' : '-', adjustment);
+
+		tree.node("root", below, '+', adjusted);
+		return tree.str();
+	}
+
+	/*
+	Board folded from six 50x50 faces in the same net as the real input (the solver's tile size is fixed),
+	with ~10% walls, then a path of alternating distances and turns that grows with scale.
+	*/
+	string day22(double scale, Random& random) {
+		const int TILE = 50;
+		// which tiles of the 4 rows x 3 columns net are faces
+		const vector<string> net{ ".##", ".#.", "##.", "#.." };
+
+		ostringstream out;
+		for (int row = 0; row < 4 * TILE; row++) {
+			const string& tiles = net[row / TILE];
+			size_t lastFace = tiles.find_last_of('#');
+			for (size_t tile = 0; tile <= lastFace; tile++) {
+				for (int x = 0; x < TILE; x++) {
+					// keep the start (leftmost cell of the top row) open
+					bool start = row == 0 && tile == tiles.find('#') && x == 0;
+					if (tiles[tile] != '#') out << ' ';
+					else out << (!start && random.chance(0.1) ? '#' : '.');
+				}
+			}
+			out << '\n';
+		}
+		out << '\n';
+
+		int moves = scaled(2000, scale);
+		for (int i = 0; i < moves; i++) {
+			if (i > 0) out << (random.chance(0.5) ? 'L' : 'R');
+			out << random.between(1, 50);
+		}
+		out << '\n';
+		return out.str();
+	}
+
+	// Square field half full of elves
+	string day23(double scale, Random& random) {
+		int size = scaledSide(74, scale);
+		ostringstream out;
+		for (int y = 0; y < size; y++) {
+			for (int x = 0; x < size; x++) out << (random.chance(0.5) ? '#' : '.');
+			out << '\n';
+		}
+		return out.str();
+	}
+
+	// Walled valley crowded with blizzards, none of them vertical in the entrance or exit columns
+	string day24(double scale, Random& random) {
+		int width = max(4, scaledSide(100, scale));
+		int height = max(2, scaledSide(35, scale));
+		ostringstream out;
+		out << "#." << string(width, '#') << '\n';
+		for (int y = 0; y < height; y++) {
+			out << '#';
+			for (int x = 0; x < width; x++) {
+				bool opening = x == 0 || x == width - 1;
+				if (!random.chance(0.9)) out << '.';
+				else out << (opening ? "<>" : "<>^v")[random.between(0, opening ? 1 : 3)];
+			}
+			out << "#\n";
+		}
+		out << string(width, '#') << ".#\n";
+		return out.str();
+	}
+
+	// SNAFU numbers, in balanced base 5 with digits = - 0 1 2
+	string day25(double scale, Random& random) {
+		ostringstream out;
+		int count = scaled(107, scale);
+		for (int i = 0; i < count; i++) {
+			int64_t value = random.between(1, 1'000'000'000'000LL);
+			string digits;
+			while (value > 0) {
+				int digit = value % 5;
+				if (digit > 2) digit -= 5;
+				digits += "=-012"[digit + 2];
+				value = (value - digit) / 5;
+			}
+			out << string(digits.rbegin(), digits.rend()) << '\n';
+		}
+		return out.str();
+	}
+
+	typedef string (*Generator)(double scale, Random& random);
+
+	const vector<Generator> generators{
+		day1, day2, day3, day4, day5, day6, day7, day8, day9, day10, day11, day12, day13,
+		day14, day15, day16, day17, day18, day19, day20, day21, day22, day23, day24, day25
+	};
+}
+
+string generateInput(int day, double scale, uint64_t seed) {
+	if (day < 1 || day > static_cast<int>(generators.size())) throw invalid_argument("No generator for day " + to_string(day));
+	if (!(scale > 0)) throw invalid_argument("Scale must be positive");
+
+	// different days get different inputs from the same seed
+	Random random(seed * 1000 + day);
+	return generators[day - 1](scale, random);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+/*
+Synthetic puzzle inputs in the same format as each DayN.txt, to benchmark the solvers at sizes the real inputs never reach.
+
+scale = 1 is about the size of the real input, and whatever dominates the work grows roughly linearly with it
+(lines, grid area, number of sensors, ...). The same day, scale and seed always give the same input.
+Inputs are built to meet the assumptions the solvers make about real inputs, e.g. day 15 leaving exactly one
+possible beacon position, day 21 having a single path from root to humn, day 22 being a net of 50x50 faces.
+*/
+
+// Throws invalid_argument for a day without a generator, or a scale that isn't positive
+std::string generateInput(int day, double scale, uint64_t seed);
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+#include "Point.h"
+
+/*
+Dense 2D grid, stored row by row in one contiguous vector and indexed by (x, y), with y = 0 the first row.
+Can be surrounded by `padding` cells of a sentinel value on every side, which are valid to read and write
+(x = -1, y = height, ...), so looking at neighbours near the edge needs no bounds checks,
+e.g. padding 1 with a wall value around a maze.
+*/
+template <typename T>
+class Grid2D {
+public:
+	// One column of the grid, a view of every stride-th cell
+	template <typename U>
+	class Column {
+	private:
+		U* first;
+		std::ptrdiff_t stride;
+		int count;
+
+	public:
+		class iterator {
+		private:
+			U* cell;
+			std::ptrdiff_t stride;
+
+		public:
+			iterator(U* cell, std::ptrdiff_t stride) : cell(cell), stride(stride) {}
+
+			U& operator*() const {
+				return *cell;
+			}
+
+			iterator& operator++() {
+				cell += stride;
+				return *this;
+			}
+
+			bool operator==(const iterator&) const = default;
+		};
+
+		Column(U* first, std::ptrdiff_t stride, int count) : first(first), stride(stride), count(count) {}
+
+		U& operator[](int y) const {
+			return first[y * stride];
+		}
+
+		int size() const {
+			return count;
+		}
+
+		iterator begin() const {
+			return { first, stride };
+		}
+
+		iterator end() const {
+			return { first + count * stride, stride };
+		}
+	};
+
+private:
+	int w;
+	int h;
+	int pad;
+	std::ptrdiff_t stride; // w + 2 * pad
+	std::vector<T> cells;
+
+	std::size_t index(int x, int y) const {
+		return static_cast<std::size_t>((y + pad) * stride + x + pad);
+	}
+
+	// Number of cells including the padding, checked before anything is allocated
+	static std::size_t cellCount(int width, int height, int padding) {
+		if (width < 0 || height < 0 || padding < 0) throw std::invalid_argument("Grid dimensions can't be negative");
+		const std::size_t paddedWidth = static_cast<std::size_t>(width) + 2 * static_cast<std::size_t>(padding);
+		const std::size_t paddedHeight = static_cast<std::size_t>(height) + 2 * static_cast<std::size_t>(padding);
+		// coordinates are ints, so each side has to fit in one as well as the total in memory
+		if (paddedWidth > INT_MAX || paddedHeight > INT_MAX || (paddedHeight > 0 && paddedWidth > SIZE_MAX / paddedHeight)) {
+			throw std::invalid_argument("Grid dimensions too large");
+		}
+		return paddedWidth * paddedHeight;
+	}
+
+public:
+	Grid2D() : w(0), h(0), pad(0), stride(0) {}
+
+	Grid2D(int width, int height, const T& fill = T(), int padding = 0, const T& border = T())
+		: w(width), h(height), pad(padding), stride(static_cast<std::ptrdiff_t>(width) + 2 * padding),
+		cells(cellCount(width, height, padding), border) {
+		for (int y = 0; y < h; y++) {
+			std::span<T> r = row(y);
+			std::fill(r.begin(), r.end(), fill);
+		}
+	}
+
+	// Same as constructing a new grid, but reuses the memory of this one where it can
+	void assign(int width, int height, const T& fill = T(), int padding = 0, const T& border = T()) {
+		const std::size_t count = cellCount(width, height, padding);
+		w = width;
+		h = height;
+		pad = padding;
+		stride = static_cast<std::ptrdiff_t>(width) + 2 * padding;
+		cells.assign(count, border);
+		this->fill(fill);
+	}
+
+	int width() const {
+		return w;
+	}
+
+	int height() const {
+		return h;
+	}
+
+	int padding() const {
+		return pad;
+	}
+
+	// Inside the grid proper, not the padding
+	bool contains(int x, int y) const {
+		return x >= 0 && x < w && y >= 0 && y < h;
+	}
+
+	bool contains(const Point<int>& p) const {
+		return contains(p.x, p.y);
+	}
+
+	// Unchecked, valid anywhere within the padding
+	T& operator()(int x, int y) {
+		return cells[index(x, y)];
+	}
+
+	const T& operator()(int x, int y) const {
+		return cells[index(x, y)];
+	}
+
+	T& operator[](const Point<int>& p) {
+		return cells[index(p.x, p.y)];
+	}
+
+	const T& operator[](const Point<int>& p) const {
+		return cells[index(p.x, p.y)];
+	}
+
+	// Throws out_of_range if outside the grid and its padding
+	const T& at(int x, int y) const {
+		if (x < -pad || x >= w + pad || y < -pad || y >= h + pad) {
+			throw std::out_of_range("(" + std::to_string(x) + ", " + std::to_string(y) + ") outside grid");
+		}
+		return cells[index(x, y)];
+	}
+
+	T& at(int x, int y) {
+		return const_cast<T&>(static_cast<const Grid2D&>(*this).at(x, y));
+	}
+
+	// Cells of row y, excluding the padding
+	std::span<T> row(int y) {
+		return { cells.data() + index(0, y), static_cast<std::size_t>(w) };
+	}
+
+	std::span<const T> row(int y) const {
+		return { cells.data() + index(0, y), static_cast<std::size_t>(w) };
+	}
+
+	// Cells of column x, excluding the padding
+	Column<T> column(int x) {
+		return { cells.data() + index(x, 0), stride, h };
+	}
+
+	Column<const T> column(int x) const {
+		return { cells.data() + index(x, 0), stride, h };
+	}
+
+	// Sets every cell except the padding
+	void fill(const T& value) {
+		for (int y = 0; y < h; y++) {
+			std::span<T> r = row(y);
+			std::fill(r.begin(), r.end(), value);
+		}
+	}
+};
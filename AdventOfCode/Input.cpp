@@ -0,0 +1,100 @@
+#include <utility>
+
+#include "Input.h"
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+InputFile::InputFile(const string& path) {
+	ifstream input(path, ios::binary);
+	if (!input) throw invalid_argument("Failed to open " + path);
+	ostringstream contents;
+	contents << input.rdbuf();
+	buffer = contents.str();
+	data = buffer.data();
+	size = buffer.size();
+}
+
+void InputFile::release() {
+	buffer.clear();
+	data = nullptr;
+	size = 0;
+}
+
+InputFile::InputFile(InputFile&& other) noexcept : buffer(std::move(other.buffer)) {
+	data = buffer.data();
+	size = buffer.size();
+	other.release();
+}
+
+InputFile& InputFile::operator=(InputFile&& other) noexcept {
+	buffer = std::move(other.buffer);
+	data = buffer.data();
+	size = buffer.size();
+	other.release();
+	return *this;
+}
+
+#else
+
+InputFile::InputFile(const string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) throw invalid_argument("Failed to open " + path);
+
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		throw invalid_argument("Failed to stat " + path);
+	}
+	size = static_cast<size_t>(info.st_size);
+
+	// mmap of 0 bytes fails, leave an empty file as an empty view
+	if (size > 0) {
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close(fd);
+			throw invalid_argument("Failed to map " + path);
+		}
+		// inputs are always scanned front to back
+		madvise(mapped, size, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(mapped);
+	}
+
+	// mapping stays valid after the descriptor is closed
+	close(fd);
+}
+
+void InputFile::release() {
+	if (data != nullptr) munmap(const_cast<char*>(data), size);
+	data = nullptr;
+	size = 0;
+}
+
+InputFile::InputFile(InputFile&& other) noexcept
+	: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+InputFile& InputFile::operator=(InputFile&& other) noexcept {
+	if (this != &other) {
+		release();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+	}
+	return *this;
+}
+
+#endif
+
+InputFile::~InputFile() {
+	release();
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <stdexcept>
+
+/*
+Whole input file mapped into memory, with lines/fields handed out as string_views into the mapping,
+rather than copying everything through ifstream + getline into separate strings.
+Views are only valid while the InputFile is alive.
+*/
+class InputFile {
+private:
+	const char* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	std::string buffer; // no mmap, just read the file in one go
+#endif
+
+	void release();
+
+public:
+	// Throws invalid_argument if the file can't be opened
+	explicit InputFile(const std::string& path);
+	~InputFile();
+
+	// Owns the mapping, so can be moved but not copied
+	InputFile(const InputFile&) = delete;
+	InputFile& operator=(const InputFile&) = delete;
+	InputFile(InputFile&& other) noexcept;
+	InputFile& operator=(InputFile&& other) noexcept;
+
+	std::string_view text() const {
+		return { data, size };
+	}
+};
+
+/*
+Splits text on a delimiter, same results as repeatedly calling getline(stream, s, delim):
+"a\n\nb\n" gives "a", "", "b" (a trailing delimiter doesn't produce an extra empty piece).
+*/
+class Splitter {
+private:
+	std::string_view rest;
+	char delim;
+
+public:
+	explicit Splitter(std::string_view text, char delim = '\n') : rest(text), delim(delim) {}
+
+	bool next(std::string_view& piece) {
+		if (rest.empty()) return false;
+		size_t end = rest.find(delim);
+		if (end == std::string_view::npos) {
+			piece = rest;
+			rest = {};
+		}
+		else {
+			piece = rest.substr(0, end);
+			rest.remove_prefix(end + 1);
+		}
+		return true;
+	}
+
+	bool atEnd() const {
+		return rest.empty();
+	}
+};
+
+/*
+Whitespace separated tokens, same results as repeatedly doing stream >> s.
+*/
+class Tokens {
+private:
+	std::string_view rest;
+
+	static bool isSpace(char c) {
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+public:
+	explicit Tokens(std::string_view text) : rest(text) {}
+
+	bool next(std::string_view& token) {
+		size_t start = 0;
+		while (start < rest.size() && isSpace(rest[start])) start++;
+		if (start == rest.size()) {
+			rest = {};
+			return false;
+		}
+
+		size_t end = start;
+		while (end < rest.size() && !isSpace(rest[end])) end++;
+		token = rest.substr(start, end - start);
+		rest.remove_prefix(end);
+		return true;
+	}
+};
+
+inline Splitter lines(const InputFile& input) {
+	return Splitter(input.text());
+}
+
+inline Tokens tokens(const InputFile& input) {
+	return Tokens(input.text());
+}
+
+// Whole of s must be a number (optionally negative), throws invalid_argument otherwise
+template<typename T>
+T parseNumber(std::string_view s) {
+	T value{};
+	const char* end = s.data() + s.size();
+	auto [ptr, ec] = std::from_chars(s.data(), end, value);
+	if (ec != std::errc() || ptr != end) throw std::invalid_argument("Not a number: '" + std::string(s) + "'");
+	return value;
+}
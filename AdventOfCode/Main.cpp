@@ -1,11 +1,599 @@
-#include "Day25.h"
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <limits>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 
-int main() {
-	day25::main();
+#include "Registry.h"
+#include "CommandLine.h"
+#include "Trace.h"
+#include "SearchStats.h"
+#include "Memory.h"
+#include "Output.h"
+#include "Parallel.h"
+#include "StreamInput.h"
+#include "Input.h"
+#include "Server.h"
+#include "Checkpoint.h"
 
-	// wait to close
-	std::cin.get();
+using namespace std;
 
-	return 0;
-}
\ No newline at end of file
+struct RunOptions {
+	vector<int> days; // empty = all
+	vector<int> parts{ 1, 2 };
+	string inputPath; // empty = DayN.txt in inputDir
+	string inputDir = defaultInputDir();
+	int repeat = 1;
+	string tracePath; // empty = no tracing
+	int jobs = -1; // > 1 = solve days/parts concurrently, 0 = one thread per core, -1 = not given (1, or 0 for a batch or server)
+	string timingsPath; // empty = don't read or record timings
+	string cacheDir; // empty = always parse
+	bool stream = false; // read the input from stdin, a chunk at a time
+	string batchPath; // empty = not a batch
+	string servePath; // socket to serve on, empty = not a server
+	string connectPath; // socket of a server to solve on, empty = solve here
+	string checkpointDir; // empty = no snapshots
+	int checkpointInterval = 100;
+	bool shutdown = false; // stop the server at connectPath, once any days given are solved
+	int verbosity = -1; // how much of what days print to show, -1 = not given (SUMMARY, or QUIET when serving or in a batch)
+	bool help = false;
+};
+
+void printUsage(const char* program) {
+	cout << "Usage: " << program << " [options]\n"
+		<< "  -d, --day LIST     days to run, e.g. 16 or 1,3,5-7 (default: all)\n"
+		<< "  -p, --part N       only run part 1 or 2 (default: both)\n"
+		<< "  -i, --input PATH   input file to use, only valid with a single day\n"
+		<< "      --dir DIR      directory containing DayN.txt inputs (default: " << defaultInputDir() << ")\n"
+		<< "  -r, --repeat N     run each part N times, reporting best and mean time (default: 1)\n"
+		<< "      --trace PATH   write a Chrome trace of parsing/solving to PATH (needs a build with AOC_TRACE)\n"
+		<< "  -j, --jobs N       parse/solve days and parts on N threads at once, 0 = one per core (default: 1)\n"
+		<< "      --timings PATH record how long each parse/part took in PATH, and with -j run the longest first\n"
+		<< "      --cache DIR    load parsed inputs cached in DIR rather than parsing them, caching any that aren't\n"
+		<< "                     (only days 16, 21 and 22 so far)\n"
+		<< "      --stream       read a single day's input from stdin in fixed-size chunks, without keeping it all\n"
+		<< "                     (days 1, 2, 3, 4, 6, 10 and 25)\n"
+		<< "      --batch PATH   solve a single day for every input in a directory, or matching a pattern like dir/*.txt,\n"
+		<< "                     concurrently (on one thread per core unless -j is given), one line per input\n"
+		<< "      --checkpoint DIR  snapshot long simulations in DIR as they run, resuming from any snapshot there\n"
+		<< "                     (days 11, 17 and 23 part 2, and 17 part 1)\n"
+		<< "      --checkpoint-every N  steps between snapshots: rounds for days 11 and 23, rocks for 17 (default: 100)\n"
+		<< "      --serve SOCKET keep running, answering requests on a Unix domain socket, with every parsed input\n"
+		<< "                     kept in memory for the next request (--dir and --cache apply to the server, and -j to\n"
+		<< "                     how many connections it handles at once, one per core unless given)\n"
+		<< "      --connect SOCKET  solve on the server listening on SOCKET rather than here\n"
+		<< "      --shutdown     with --connect, stop the server afterwards (only solving the days given with -d)\n"
+		<< "  -v, --verbose N    what days print along the way: 0 = nothing, 1 = a few lines each, 2 = everything,\n"
+		<< "                     up to the build's AOC_MAX_VERBOSITY of " << diagnostics::maxVerbosity << " (default: 1, or 0 with --serve or --batch)\n"
+		<< "  -h, --help         show this message\n"
+		<< "Answers to each day's own input are checked against the known ones, exiting with " << EXIT_WRONG_ANSWER << " if any are wrong." << endl;
+}
+
+RunOptions parseArgs(int argc, char* argv[]) {
+	RunOptions options;
+
+	for (int i = 1; i < argc; i++) {
+		const string arg = argv[i];
+		auto value = [&]() -> string {
+			if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+			return argv[++i];
+		};
+
+		if (arg == "-h" || arg == "--help") options.help = true;
+		else if (arg == "-d" || arg == "--day") options.days = parseDayList(value());
+		else if (arg == "-p" || arg == "--part") options.parts = { parsePart(value()) };
+		else if (arg == "-i" || arg == "--input") options.inputPath = value();
+		else if (arg == "--dir") options.inputDir = value();
+		else if (arg == "--trace") {
+			options.tracePath = value();
+			if (!trace::compiledIn) throw invalid_argument("Built without tracing, reconfigure with -DAOC_TRACE=ON");
+		}
+		else if (arg == "-j" || arg == "--jobs") {
+			options.jobs = parseInt(value());
+			if (options.jobs < 0) throw invalid_argument("Job count can't be negative");
+		}
+		else if (arg == "--timings") options.timingsPath = value();
+		else if (arg == "--cache") options.cacheDir = value();
+		else if (arg == "--stream") options.stream = true;
+		else if (arg == "--batch") options.batchPath = value();
+		else if (arg == "--checkpoint") options.checkpointDir = value();
+		else if (arg == "--checkpoint-every") {
+			options.checkpointInterval = parseInt(value());
+			if (options.checkpointInterval < 1) throw invalid_argument("Checkpoint interval must be at least 1");
+		}
+		else if (arg == "--serve") options.servePath = value();
+		else if (arg == "--connect") options.connectPath = value();
+		else if (arg == "--shutdown") options.shutdown = true;
+		else if (arg == "-v" || arg == "--verbose") {
+			options.verbosity = parseInt(value());
+			if (options.verbosity < 0 || options.verbosity > 2) throw invalid_argument("Verbosity must be 0, 1 or 2");
+		}
+		else if (arg == "-r" || arg == "--repeat") {
+			options.repeat = parseInt(value());
+			if (options.repeat < 1) throw invalid_argument("Repeat count must be at least 1");
+		}
+		else throw invalid_argument("Unknown option " + arg);
+	}
+
+	if (options.stream) {
+		if (options.days.size() != 1) throw invalid_argument("--stream needs a single day, e.g. -d 1");
+		if (!options.inputPath.empty() || options.repeat != 1 || options.jobs > 1) {
+			throw invalid_argument("--stream can't be combined with --input, --repeat or --jobs");
+		}
+	}
+
+	if (!options.batchPath.empty()) {
+		if (options.days.size() != 1) throw invalid_argument("--batch needs a single day, e.g. -d 23");
+		if (!options.inputPath.empty() || options.stream || options.repeat != 1) {
+			throw invalid_argument("--batch can't be combined with --input, --stream or --repeat");
+		}
+	}
+	if (options.jobs < 0) options.jobs = options.batchPath.empty() && options.servePath.empty() ? 1 : 0;
+
+	if (!options.servePath.empty() && (options.stream || !options.batchPath.empty() || !options.connectPath.empty())) {
+		throw invalid_argument("--serve can't be combined with --stream, --batch or --connect");
+	}
+	if (!options.connectPath.empty()) {
+		if (options.stream || !options.batchPath.empty() || options.jobs > 1 || !options.tracePath.empty() || !options.timingsPath.empty()) {
+			throw invalid_argument("--connect can't be combined with --stream, --batch, --jobs, --trace or --timings");
+		}
+	}
+	else if (options.shutdown) throw invalid_argument("--shutdown needs --connect");
+
+	// just stopping a server doesn't need anything solved first
+	if (options.days.empty() && !options.shutdown) {
+		for (const Day& day : allDays()) options.days.push_back(day.number);
+	}
+	if (!options.inputPath.empty() && options.days.size() != 1) {
+		throw invalid_argument("--input can only be used when running a single day");
+	}
+
+	return options;
+}
+
+double elapsedMs(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+	return chrono::duration<double, milli>(end - start).count();
+}
+
+struct PartRun {
+	int part = 0;
+	string answer;
+	double bestMs = 0;
+	double meanMs = 0;
+	memory::Usage usage; // from the last run
+	SearchStats stats; // from the last run
+	string output; // anything the day printed along the way, when captured
+	string error; // instead of the above, if it failed while running concurrently
+};
+
+struct DayRun {
+	const Day* day;
+	string inputPath;
+	Day::Parsed parsed;
+	bool fromCache = false;
+	double parseMs = 0;
+	memory::Usage parseUsage;
+	string parseOutput;
+	string error;
+	vector<PartRun> parts;
+};
+
+// alone = nothing else is running at the same time, so the peak RSS is worth measuring
+void parseDay(DayRun& run, const string& cacheDir, bool alone) {
+	memory::Measure measure(alone);
+	auto start = chrono::steady_clock::now();
+	{
+		TRACE_SCOPE("Day " + to_string(run.day->number) + " parse");
+		run.parsed = run.day->parseFile(run.inputPath, cacheDir, &run.fromCache);
+	}
+	auto end = chrono::steady_clock::now();
+	run.parseMs = elapsedMs(start, end);
+	run.parseUsage = measure.result();
+	diagnostics::flush(); // before the timing line, so what it printed comes first
+}
+
+PartRun solvePart(const DayRun& run, int part, int repeat, bool alone) {
+	const Day& day = *run.day;
+	const Day::Part& solve = day.part(part);
+
+	PartRun result;
+	result.part = part;
+	double best = numeric_limits<double>::max();
+	double total = 0;
+	for (int i = 0; i < repeat; i++) {
+		TRACE_SCOPE("Day " + to_string(day.number) + " part " + to_string(part));
+		memory::Measure measure(alone);
+		auto start = chrono::steady_clock::now();
+		result.stats = countSearch([&]() { result.answer = solve(run.parsed); });
+		auto end = chrono::steady_clock::now();
+		result.usage = measure.result();
+		diagnostics::flush();
+
+		double ms = elapsedMs(start, end);
+		best = min(best, ms);
+		total += ms;
+	}
+	result.bestMs = best;
+	result.meanMs = total / repeat;
+	return result;
+}
+
+void printParse(const DayRun& run) {
+	cout << "Day " << run.day->number << (run.fromCache ? " load from cache: " : " parse: ") << run.parseMs << " ms (" << run.parseUsage << ")" << endl;
+}
+
+void printPart(const Day& day, const PartRun& result, int repeat) {
+	ostringstream timing;
+	timing << result.bestMs << " ms";
+	if (repeat > 1) timing << " best, " << result.meanMs << " ms mean of " << repeat << " runs";
+	timing << ", " << result.usage; // from the last run
+
+	// multi-line answers (e.g. letters drawn on a display) go underneath
+	cout << "Day " << day.number << " part " << result.part;
+	if (result.answer.find('\n') == string::npos) cout << ": " << result.answer << " (" << timing.str() << ")" << endl;
+	else cout << " (" << timing.str() << "):\n" << result.answer << endl;
+
+	// only for days that do a search
+	if (searchStatsCompiledIn && result.stats.expanded + result.stats.pruned > 0) {
+		cout << "Day " << day.number << " part " << result.part << " search: " << result.stats << endl;
+	}
+}
+
+// Keeps each input to one line of output, joining the rows of multi-line answers (e.g. letters drawn on a display)
+string oneLine(string answer) {
+	replace(answer.begin(), answer.end(), '\n', '|');
+	return answer;
+}
+
+// Against the day's expected answer, if the input is the one it's for, saying so on stderr if it's wrong
+bool checkAnswer(const Day& day, const string& inputPath, int part, const string& answer) {
+	const string& expected = day.expected(part);
+	if (expected.empty() || answer == expected || !day.isDefaultInput(inputPath)) return true;
+	cerr << "Day " << day.number << " part " << part << " is wrong, expected " << oneLine(expected) << endl;
+	return false;
+}
+
+// Each day's input is parsed once, then shared by each part and every repeat.
+// Results are printed as they come, so anything a day prints along the way shows up live.
+// Returns how many answers were wrong.
+int runSequential(vector<DayRun>& runs, const RunOptions& options) {
+	int wrong = 0;
+	for (DayRun& run : runs) {
+		parseDay(run, options.cacheDir, true);
+		printParse(run);
+
+		for (int part : options.parts) {
+			run.parts.push_back(solvePart(run, part, options.repeat, true));
+			printPart(*run.day, run.parts.back(), options.repeat);
+			if (!checkAnswer(*run.day, run.inputPath, part, run.parts.back().answer)) wrong++;
+		}
+		run.parsed = nullptr;
+	}
+	return wrong;
+}
+
+// Input only ever passes through once, so both parts are solved together and timed as one
+void runStream(const Day& day, const RunOptions& options) {
+	if (!day.stream) throw invalid_argument("Day " + to_string(day.number) + " can't be solved from a stream");
+
+	StreamInput in(stdin);
+	memory::Measure measure;
+	auto start = chrono::steady_clock::now();
+	pair<string, string> answers;
+	{
+		TRACE_SCOPE("Day " + to_string(day.number) + " stream");
+		answers = day.stream(in);
+	}
+	auto end = chrono::steady_clock::now();
+	diagnostics::flush();
+
+	double ms = elapsedMs(start, end);
+	cout << "Day " << day.number << " stream: " << ms << " ms, " << in.bytesRead() << " bytes read ("
+		<< measure.result() << ")" << endl;
+	for (int part : options.parts) {
+		const string& answer = part == 1 ? answers.first : answers.second;
+		cout << "Day " << day.number << " part " << part;
+		if (answer.find('\n') == string::npos) cout << ": " << answer << endl;
+		else cout << ":\n" << answer << endl;
+	}
+}
+
+struct BatchResult {
+	vector<string> answers; // for each of the parts asked for
+	string error;
+};
+
+// Each input is parsed and solved start to finish as one task on the shared pool,
+// so days with per-thread scratch space (see Scratch.h) reuse it from one input to the next.
+// Returns the exit status: EXIT_WRONG_ANSWER if any answers were wrong, otherwise 1 if any inputs failed.
+int runBatch(const Day& day, const RunOptions& options) {
+	vector<string> files = expandInputs(options.batchPath);
+	vector<BatchResult> results(files.size());
+	atomic<uint64_t> bytes{ 0 };
+
+	parallel::setThreadCount(options.jobs);
+	auto start = chrono::steady_clock::now();
+	parallel::forEach<size_t>(0, files.size(), [&](size_t i) {
+		BatchResult& result = results[i];
+		try {
+			OutputCapture capture; // anything printed along the way would just be interleaved noise
+			InputFile input(files[i]);
+			bytes += input.text().size();
+			Day::Parsed parsed = day.parse(input.text());
+			for (int part : options.parts) result.answers.push_back(day.part(part)(parsed));
+		}
+		catch (const exception& e) {
+			result.error = e.what();
+		}
+	}, size_t{ 1 });
+	auto end = chrono::steady_clock::now();
+
+	int failed = 0;
+	int wrong = 0;
+	for (size_t i = 0; i < files.size(); i++) {
+		const BatchResult& result = results[i];
+		cout << files[i] << ":";
+		if (!result.error.empty()) {
+			cout << " error: " << result.error << endl;
+			failed++;
+			continue;
+		}
+		for (size_t k = 0; k < result.answers.size(); k++) {
+			cout << (k > 0 ? "," : "") << " part " << options.parts[k] << " = " << oneLine(result.answers[k]);
+		}
+		cout << endl;
+		for (size_t k = 0; k < result.answers.size(); k++) {
+			if (!checkAnswer(day, files[i], options.parts[k], result.answers[k])) wrong++;
+		}
+	}
+
+	double ms = elapsedMs(start, end);
+	double seconds = ms / 1000;
+	cout << "Day " << day.number << " batch: " << files.size() << " inputs in " << ms << " ms on "
+		<< parallel::pool().size() << " threads, " << files.size() / seconds << " inputs/sec, "
+		<< bytes / seconds / (1024 * 1024) << " MB/sec";
+	if (failed > 0) cout << ", " << failed << " failed";
+	if (wrong > 0) cout << ", " << wrong << " wrong";
+	cout << endl;
+	return wrong > 0 ? EXIT_WRONG_ANSWER : failed > 0 ? 1 : 0;
+}
+
+// Each part is solved by the server, which keeps the parsed input for next time, so only the round trip is timed here.
+// Returns how many answers were wrong.
+int runClient(const RunOptions& options) {
+	server::Client client(options.connectPath);
+	int wrong = 0;
+
+	for (int number : options.days) {
+		const Day& day = getDay(number);
+		// the server may well be running somewhere else
+		string inputPath = filesystem::absolute(resolveInput(day, options.inputDir, options.inputPath)).string();
+
+		for (int part : options.parts) {
+			server::Client::Answer answer;
+			double best = numeric_limits<double>::max();
+			double total = 0;
+			for (int i = 0; i < options.repeat; i++) {
+				auto start = chrono::steady_clock::now();
+				answer = client.solve(number, part, inputPath);
+				double ms = elapsedMs(start, chrono::steady_clock::now());
+				best = min(best, ms);
+				total += ms;
+			}
+
+			ostringstream timing;
+			timing << best << " ms";
+			if (options.repeat > 1) timing << " best, " << total / options.repeat << " ms mean of " << options.repeat << " runs";
+			timing << " round trip, " << answer.serverMs << " ms on the server"; // from the last run
+
+			cout << "Day " << number << " part " << part;
+			if (answer.answer.find('\n') == string::npos) cout << ": " << answer.answer << " (" << timing.str() << ")" << endl;
+			else cout << " (" << timing.str() << "):\n" << answer.answer << endl;
+			if (!checkAnswer(day, inputPath, part, answer.answer)) wrong++;
+		}
+	}
+
+	if (options.shutdown) client.shutdown();
+	return wrong;
+}
+
+// (day, part) -> ms, part 0 = parsing
+typedef map<pair<int, int>, double> Timings;
+
+Timings readTimings(const string& path) {
+	Timings timings;
+	ifstream file{ path };
+	// no file yet is fine, there's just nothing to go on
+	string line;
+	while (getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		istringstream fields{ line };
+		int day, part;
+		double ms;
+		if (!(fields >> day >> part >> ms)) throw invalid_argument("Bad line in " + path + ": " + line);
+		timings[{ day, part }] = ms;
+	}
+	return timings;
+}
+
+void writeTimings(const string& path, const Timings& timings) {
+	ofstream file{ path };
+	if (!file) throw invalid_argument("Failed to open " + path);
+	file << "# day part ms (part 0 = parse)\n";
+	for (const auto& [key, ms] : timings) file << key.first << " " << key.second << " " << ms << "\n";
+}
+
+void recordTimings(const DayRun& run, Timings& timings) {
+	if (!run.error.empty()) return;
+	timings[{ run.day->number, 0 }] = run.parseMs;
+	for (const PartRun& result : run.parts) {
+		if (result.error.empty()) timings[{ run.day->number, result.part }] = result.bestMs;
+	}
+}
+
+double estimateMs(const Timings& timings, int day, int part) {
+	auto it = timings.find({ day, part });
+	// never timed, so could be anything. Better to start it early than have it finish last.
+	return it == timings.end() ? numeric_limits<double>::infinity() : it->second;
+}
+
+// Every parse, then every part once its day is parsed, as tasks on the shared work-stealing pool.
+// Days expected to take longest overall are started first, and within a day the longer part.
+// What each day prints is captured per task, then everything is printed in the same order
+// as a sequential run once all of it has finished. Returns how many answers were wrong.
+int runParallel(vector<DayRun>& runs, const RunOptions& options, const Timings& timings) {
+	vector<double> dayEstimates;
+	for (const DayRun& run : runs) {
+		double estimate = estimateMs(timings, run.day->number, 0);
+		for (int part : options.parts) estimate += estimateMs(timings, run.day->number, part);
+		dayEstimates.push_back(estimate);
+	}
+	vector<size_t> dayOrder(runs.size());
+	for (size_t i = 0; i < runs.size(); i++) dayOrder[i] = i;
+	stable_sort(dayOrder.begin(), dayOrder.end(), [&](size_t a, size_t b) { return dayEstimates[a] > dayEstimates[b]; });
+
+	{
+		parallel::TaskGroup tasks;
+		for (size_t i : dayOrder) {
+			tasks.run([&, i]() {
+				DayRun& run = runs[i];
+				try {
+					OutputCapture capture;
+					parseDay(run, options.cacheDir, false);
+					run.parseOutput = capture.str();
+				}
+				catch (const exception& e) {
+					run.error = e.what();
+					return;
+				}
+
+				vector<size_t> partOrder(options.parts.size());
+				for (size_t k = 0; k < partOrder.size(); k++) partOrder[k] = k;
+				stable_sort(partOrder.begin(), partOrder.end(), [&](size_t a, size_t b) {
+					return estimateMs(timings, run.day->number, options.parts[a]) > estimateMs(timings, run.day->number, options.parts[b]);
+				});
+
+				run.parts.resize(options.parts.size());
+				for (size_t k : partOrder) {
+					tasks.run([&, k]() {
+						PartRun& result = run.parts[k];
+						try {
+							OutputCapture capture;
+							result = solvePart(run, options.parts[k], options.repeat, false);
+							result.output = capture.str();
+						}
+						catch (const exception& e) {
+							result.part = options.parts[k];
+							result.error = e.what();
+						}
+					});
+				}
+			});
+		}
+		tasks.wait();
+	}
+
+	int wrong = 0;
+	for (DayRun& run : runs) {
+		if (!run.error.empty()) throw runtime_error(run.error);
+		cout << run.parseOutput;
+		printParse(run);
+
+		for (const PartRun& result : run.parts) {
+			if (!result.error.empty()) throw runtime_error(result.error);
+			cout << result.output;
+			printPart(*run.day, result, options.repeat);
+			if (!checkAnswer(*run.day, run.inputPath, result.part, result.answer)) wrong++;
+		}
+		run.parsed = nullptr;
+	}
+	return wrong;
+}
+
+int main(int argc, char* argv[]) {
+	RunOptions options;
+	try {
+		options = parseArgs(argc, argv);
+	}
+	catch (const exception& e) {
+		cerr << e.what() << endl;
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	if (options.help) {
+		printUsage(argv[0]);
+		return 0;
+	}
+
+	if (!options.tracePath.empty()) trace::enable();
+	// a server's or batch's output is never shown, so it's not worth producing unless asked for
+	if (options.verbosity >= 0) diagnostics::verbosity = static_cast<Verbosity>(options.verbosity);
+	else if (!options.servePath.empty() || !options.batchPath.empty()) diagnostics::verbosity = Verbosity::QUIET;
+
+	int status = 0;
+	try {
+		if (!options.checkpointDir.empty()) checkpoint::configure(options.checkpointDir, options.checkpointInterval);
+
+		if (!options.servePath.empty()) {
+			server::serve(options.servePath, options.inputDir, options.cacheDir, static_cast<unsigned>(options.jobs));
+			return 0;
+		}
+		if (!options.connectPath.empty()) {
+			return runClient(options) > 0 ? EXIT_WRONG_ANSWER : 0;
+		}
+
+		Timings timings;
+		if (!options.timingsPath.empty()) timings = readTimings(options.timingsPath);
+
+		if (options.stream) {
+			runStream(getDay(options.days[0]), options);
+			options.days.clear(); // nothing else to run
+		}
+		if (!options.batchPath.empty()) {
+			status = runBatch(getDay(options.days[0]), options);
+			options.days.clear();
+		}
+
+		vector<DayRun> runs;
+		for (int number : options.days) {
+			const Day& day = getDay(number);
+			runs.push_back({ &day, resolveInput(day, options.inputDir, options.inputPath) });
+		}
+
+		int wrong;
+		if (options.jobs == 1) wrong = runSequential(runs, options);
+		else {
+			parallel::setThreadCount(options.jobs);
+			wrong = runParallel(runs, options, timings);
+		}
+		if (wrong > 0) status = EXIT_WRONG_ANSWER;
+
+		if (!options.timingsPath.empty()) {
+			for (const DayRun& run : runs) recordTimings(run, timings);
+			writeTimings(options.timingsPath, timings);
+		}
+	}
+	catch (const exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+
+	if (!options.tracePath.empty()) {
+		ofstream traceFile{ options.tracePath };
+		if (!traceFile) {
+			cerr << "Failed to open " << options.tracePath << endl;
+			return 1;
+		}
+		trace::write(traceFile);
+	}
+
+	return status;
+}
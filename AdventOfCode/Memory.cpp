@@ -0,0 +1,75 @@
+#include <new>
+#include <cstdlib>
+
+#include "Memory.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+// Every allocation is recorded in the counts kept by the library (MemoryUsage.cpp)
+namespace {
+	void* allocate(size_t size) {
+		memory::recordAllocation(size);
+		// malloc(0) may return null, but new has to return a unique pointer
+		return malloc(size == 0 ? 1 : size);
+	}
+
+	void* allocateAligned(size_t size, align_val_t alignment) {
+		memory::recordAllocation(size);
+		size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+		return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+		// aligned_alloc needs the size to be a multiple of the alignment
+		size_t rounded = (size + align - 1) / align * align;
+		return aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+	}
+
+	void freeAligned(void* p) {
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+
+	void* allocateOrThrow(size_t size) {
+		void* p = allocate(size);
+		if (p == nullptr) throw bad_alloc();
+		return p;
+	}
+
+	void* allocateAlignedOrThrow(size_t size, align_val_t alignment) {
+		void* p = allocateAligned(size, alignment);
+		if (p == nullptr) throw bad_alloc();
+		return p;
+	}
+}
+
+// Replacements for every form of the global allocation functions, so nothing bypasses the counts
+
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return allocate(size); }
+void* operator new(size_t size, align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[](size_t size, align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept { return allocateAligned(size, alignment); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { freeAligned(p); }
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept { freeAligned(p); }
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept { freeAligned(p); }
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+/*
+Heap and RSS accounting, to catch memory regressions per day/part.
+
+Allocations are counted by replacing the global operator new/delete, which Memory.cpp does,
+so it's compiled into the executables rather than the library of days (which keeps the counts, in MemoryUsage.cpp).
+Executables built without it just see zero allocations.
+Allocations are counted per thread, and a task on the parallel pool has its allocations moved to the thread
+that waits for it (see Parallel.h), so a part's counts include the work it hands off.
+Peak RSS can only be for the whole process.
+*/
+namespace memory {
+	struct Usage {
+		uint64_t allocations = 0;
+		uint64_t bytes = 0; // total requested, not what's live at the end
+		int64_t peakRssKb = -1; // high-water mark of resident memory, -1 if unknown
+	};
+
+	// Called by the replacement operator new for every allocation
+	void recordAllocation(std::size_t size);
+
+	// Totals for this thread since it started, including anything credited to it
+	uint64_t allocations();
+	uint64_t allocatedBytes();
+
+	// Moves counts from one thread to another: the thread that did the work debits them, the one it was for credits them
+	void credit(uint64_t allocations, uint64_t bytes);
+	void debit(uint64_t allocations, uint64_t bytes);
+
+	// Peak resident set size of the process so far, -1 if the platform doesn't report it
+	int64_t peakRssKb();
+
+	// Best effort. Linux can reset the peak to the current RSS, elsewhere the peak only ever grows.
+	void resetPeakRss();
+
+	// Usage from construction up to when result() is called
+	class Measure {
+	private:
+		uint64_t startAllocations;
+		uint64_t startBytes;
+		bool trackPeak;
+
+	public:
+		// Peak RSS is process-wide, so only track it when nothing else is running at the same time.
+		// Otherwise it's left as unknown (-1) in the result.
+		explicit Measure(bool trackPeak = true) : trackPeak(trackPeak) {
+			if (trackPeak) resetPeakRss();
+			startAllocations = allocations();
+			startBytes = allocatedBytes();
+		}
+
+		Usage result() const {
+			return { allocations() - startAllocations, allocatedBytes() - startBytes, trackPeak ? peakRssKb() : -1 };
+		}
+	};
+
+	// e.g. "1520 allocs, 1.2 MB, peak RSS 14.3 MB"
+	std::ostream& operator<<(std::ostream& out, const Usage& usage);
+}
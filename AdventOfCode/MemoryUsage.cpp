@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iomanip>
+
+#include "Memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// per thread, so parts solved concurrently don't count each other's allocations
+	thread_local uint64_t allocationCount = 0;
+	thread_local uint64_t allocationBytes = 0;
+}
+
+namespace memory {
+	void recordAllocation(size_t size) {
+		allocationCount++;
+		allocationBytes += size;
+	}
+
+	void credit(uint64_t allocations, uint64_t bytes) {
+		allocationCount += allocations;
+		allocationBytes += bytes;
+	}
+
+	void debit(uint64_t allocations, uint64_t bytes) {
+		allocationCount -= allocations;
+		allocationBytes -= bytes;
+	}
+
+	uint64_t allocations() {
+		return allocationCount;
+	}
+
+	uint64_t allocatedBytes() {
+		return allocationBytes;
+	}
+
+#ifdef _WIN32
+
+	int64_t peakRssKb() {
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return -1;
+		return static_cast<int64_t>(counters.PeakWorkingSetSize / 1024);
+	}
+
+	void resetPeakRss() {}
+
+#else
+
+	int64_t peakRssKb() {
+		// VmHWM follows resets via clear_refs, ru_maxrss doesn't
+		if (FILE* status = fopen("/proc/self/status", "r")) {
+			char line[256];
+			long kb = -1;
+			while (fgets(line, sizeof(line), status)) {
+				if (strncmp(line, "VmHWM:", 6) == 0) {
+					kb = strtol(line + 6, nullptr, 10);
+					break;
+				}
+			}
+			fclose(status);
+			if (kb >= 0) return kb;
+		}
+
+		rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+
+	void resetPeakRss() {
+		// "5" resets the peak RSS to the current RSS (Linux 4.0+), silently does nothing elsewhere
+		if (FILE* clearRefs = fopen("/proc/self/clear_refs", "w")) {
+			fputs("5", clearRefs);
+			fclose(clearRefs);
+		}
+	}
+
+#endif
+
+	ostream& operator<<(ostream& out, const Usage& usage) {
+		auto megabytes = [](double bytes) { return bytes / (1024 * 1024); };
+
+		ios::fmtflags flags = out.flags();
+		streamsize precision = out.precision();
+		out << fixed << setprecision(1)
+			<< usage.allocations << " allocs, " << megabytes(static_cast<double>(usage.bytes)) << " MB";
+		if (usage.peakRssKb >= 0) out << ", peak RSS " << megabytes(usage.peakRssKb * 1024.0) << " MB";
+		out.flags(flags);
+		out.precision(precision);
+		return out;
+	}
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <vector>
+
+#include "Output.h"
+
+using namespace std;
+
+namespace {
+	thread_local ostream* current = nullptr; // null = cout
+
+	// Collects what's written, only passing it on when full or flushed, so endl is just a newline
+	class Buffer : public streambuf {
+	private:
+		static const size_t SIZE = 64 * 1024;
+		vector<char> storage;
+
+	protected:
+		int_type overflow(int_type c) override {
+			drain();
+			if (!traits_type::eq_int_type(c, traits_type::eof())) {
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+
+		int sync() override {
+			return 0;
+		}
+
+	public:
+		Buffer() : storage(SIZE) {
+			setp(storage.data(), storage.data() + storage.size());
+		}
+
+		void drain() {
+			if (pptr() == pbase()) return;
+			dayOutput().write(pbase(), pptr() - pbase());
+			setp(storage.data(), storage.data() + storage.size());
+		}
+	};
+
+	struct Sink {
+		Buffer buffer;
+		ostream stream{ &buffer };
+
+		~Sink() {
+			buffer.drain();
+		}
+	};
+
+	Sink& threadSink() {
+		thread_local Sink sink;
+		return sink;
+	}
+}
+
+ostream& dayOutput() {
+	return current == nullptr ? cout : *current;
+}
+
+// Anything buffered before or during a capture belongs where it was written at the time
+OutputCapture::OutputCapture() : previous(current) {
+	diagnostics::flush();
+	current = &buffer;
+}
+
+OutputCapture::~OutputCapture() {
+	diagnostics::flush();
+	current = previous;
+}
+
+string OutputCapture::str() {
+	diagnostics::flush();
+	return buffer.str();
+}
+
+namespace diagnostics {
+	ostream& sink() {
+		return threadSink().stream;
+	}
+
+	void flush() {
+		threadSink().buffer.drain();
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/*
+Where days write anything other than their answers (progress, debug drawings, ...).
+Normally that's just cout, but a runner solving several days at once captures it per thread,
+so each day/part's output can be printed together, in order, once it's done.
+Days don't write to it directly, but through DAY_LOG below.
+*/
+std::ostream& dayOutput();
+
+// Redirects dayOutput() on this thread into a buffer until destroyed
+class OutputCapture {
+private:
+	std::ostringstream buffer;
+	std::ostream* previous;
+
+public:
+	OutputCapture();
+	~OutputCapture();
+
+	OutputCapture(const OutputCapture&) = delete;
+	OutputCapture& operator=(const OutputCapture&) = delete;
+
+	// Everything written so far, including anything still buffered by DAY_LOG on this thread
+	std::string str();
+};
+
+// Which of what days print is wanted, each level including the ones before it
+enum class Verbosity {
+	QUIET, // nothing
+	SUMMARY, // a few lines per part, e.g. the size of a reduced graph or the cycle found
+	DETAIL, // lines from inside loops (one per sensor, blueprint, ...) and debug drawings
+};
+
+#ifndef AOC_MAX_VERBOSITY
+#define AOC_MAX_VERBOSITY 2
+#endif
+
+/*
+What days print, at some level of verbosity:
+
+	DAY_LOG(DETAIL) << "Sensor = (" << x << ", " << y << ")" << endl;
+
+Only written if the level is within both AOC_MAX_VERBOSITY (CMake -DAOC_MAX_VERBOSITY=N, so lines
+past it are compiled out) and the level set at runtime (aoc -v N), otherwise the rest of the line,
+arguments and all, isn't evaluated.
+Lines go into a large per-thread buffer, passed on to dayOutput() only when it fills up or the runner
+flushes it after a part, not on every endl.
+*/
+namespace diagnostics {
+	constexpr int maxVerbosity = AOC_MAX_VERBOSITY;
+
+	// Not thread safe, set before solving anything
+	inline Verbosity verbosity = Verbosity::SUMMARY;
+
+	inline bool enabled(Verbosity level) {
+		return static_cast<int>(level) <= maxVerbosity && level <= verbosity;
+	}
+
+	// This thread's buffer. Use DAY_LOG rather than writing to it directly.
+	std::ostream& sink();
+
+	// Passes everything buffered on this thread on to dayOutput()
+	void flush();
+}
+
+#define DAY_LOG(level) if (!::diagnostics::enabled(Verbosity::level)) {} else ::diagnostics::sink()
@@ -0,0 +1,79 @@
+#include <memory>
+#include <chrono>
+
+#include "Parallel.h"
+#include "Memory.h"
+
+using namespace std;
+
+namespace parallel {
+	namespace {
+		unsigned requestedThreads = 0;
+	}
+
+	void setThreadCount(unsigned threadCount) {
+		requestedThreads = threadCount;
+	}
+
+	ThreadPool& pool() {
+		static ThreadPool shared(requestedThreads);
+		return shared;
+	}
+
+	TaskGroup::TaskGroup(ThreadPool& threads) : threads(threads) {}
+
+	TaskGroup::~TaskGroup() {
+		try {
+			wait();
+		}
+		catch (...) {}
+	}
+
+	void TaskGroup::run(function<void()> task) {
+		pending++;
+		threads.submit([this, task = move(task)]() {
+			if (!cancelled) {
+				uint64_t startAllocations = memory::allocations();
+				uint64_t startBytes = memory::allocatedBytes();
+				try {
+					task();
+				}
+				catch (...) {
+					lock_guard<mutex> lock(stateMutex);
+					if (!error) error = current_exception();
+					cancelled = true;
+				}
+				// nested groups it waited for have already been credited to this thread, so they come along too
+				uint64_t taskAllocations = memory::allocations() - startAllocations;
+				uint64_t taskBytes = memory::allocatedBytes() - startBytes;
+				memory::debit(taskAllocations, taskBytes);
+				allocations += taskAllocations;
+				allocatedBytes += taskBytes;
+			}
+
+			// under the lock, so the group can't be destroyed by a waiter seeing 0 before we're done with it
+			lock_guard<mutex> lock(stateMutex);
+			if (--pending == 0) finished.notify_all();
+		}, this);
+	}
+
+	void TaskGroup::wait() {
+		while (pending > 0) {
+			// help with our own tasks, otherwise they're all running elsewhere so just wait
+			if (threads.runOne(this)) continue;
+
+			unique_lock<mutex> lock(stateMutex);
+			// woken when the last one finishes, but also check every so often for tasks that running ones have added
+			finished.wait_for(lock, chrono::milliseconds(1), [this]() { return pending == 0; });
+		}
+		memory::credit(allocations.exchange(0), allocatedBytes.exchange(0));
+
+		lock_guard<mutex> lock(stateMutex);
+		if (error) {
+			exception_ptr thrown = error;
+			error = nullptr;
+			cancelled = false;
+			rethrow_exception(thrown);
+		}
+	}
+}
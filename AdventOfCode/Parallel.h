@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <cstdint>
+
+#include "ThreadPool.h"
+
+/*
+Data-parallel helpers for solvers with independent pieces of work, all sharing one process-wide pool:
+
+	parallel::forEach(0, n, [&](int i) { ... });
+	int total = parallel::reduce(0, n, 0, [&](int from, int to) { ...; return subtotal; }, plus<int>());
+
+A thread waiting for its tasks helps run them (only them, not unrelated work), so these can be nested
+inside tasks that are themselves on the pool, e.g. a day solved by the runner with -j.
+Anything a task writes to dayOutput(), or counts in searchStats(), is on whichever thread ran it,
+so tasks should collect results and leave printing to the caller.
+Allocations (see Memory.h) are the exception: wait() adds those of the group's tasks to the waiting thread's counts.
+*/
+namespace parallel {
+	// 0 = one per core. Only takes effect if called before the pool is first used.
+	void setThreadCount(unsigned threadCount);
+
+	ThreadPool& pool();
+
+	// Tasks that can be waited on together. The first exception thrown by any task cancels the group,
+	// so tasks not yet started are skipped, and wait() rethrows it.
+	class TaskGroup {
+	private:
+		ThreadPool& threads;
+		std::atomic<size_t> pending{ 0 };
+		std::atomic<bool> cancelled{ false };
+		// by tasks since the last wait(), moved off the threads that ran them
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> allocatedBytes{ 0 };
+		std::mutex stateMutex;
+		std::condition_variable finished;
+		std::exception_ptr error;
+
+	public:
+		explicit TaskGroup(ThreadPool& threads = pool());
+		// Waits for anything still running, but swallows any exception
+		~TaskGroup();
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		// Can be called from within the group's own tasks too
+		void run(std::function<void()> task);
+
+		// Tasks not yet started won't be. Running ones can check isCancelled() to stop early.
+		void cancel() {
+			cancelled = true;
+		}
+
+		bool isCancelled() const {
+			return cancelled;
+		}
+
+		void wait();
+	};
+
+	// [begin, end) cut into chunks of at least grain, by default enough for a few per thread
+	template <typename Index>
+	Index chunkSize(Index begin, Index end, Index grain) {
+		Index chunks = static_cast<Index>(4 * (pool().size() + 1));
+		return std::max<Index>({ grain, (end - begin + chunks - 1) / chunks, 1 });
+	}
+
+	// body(from, to) for consecutive chunks [from, to) covering [begin, end)
+	template <typename Index, typename Body>
+	void forChunks(Index begin, Index end, Body&& body, Index grain = 0) {
+		if (begin >= end) return;
+		Index size = chunkSize(begin, end, grain);
+
+		TaskGroup group;
+		for (Index from = begin; from < end; from = from + std::min(size, end - from)) {
+			Index to = from + std::min(size, end - from);
+			group.run([&body, from, to]() { body(from, to); });
+		}
+		group.wait();
+	}
+
+	// body(i) for each i in [begin, end)
+	template <typename Index, typename Body>
+	void forEach(Index begin, Index end, Body&& body, Index grain = 0) {
+		forChunks(begin, end, [&body](Index from, Index to) {
+			for (Index i = from; i < to; i++) body(i);
+		}, grain);
+	}
+
+	// Combines chunk(from, to) for each chunk, left to right in index order
+	// (so combine only needs to be associative, not commutative).
+	template <typename T, typename Index, typename Chunk, typename Combine>
+	T reduce(Index begin, Index end, T identity, Chunk&& chunk, Combine&& combine, Index grain = 0) {
+		if (begin >= end) return identity;
+		Index size = chunkSize(begin, end, grain);
+
+		std::vector<T> partials((end - begin + size - 1) / size, identity);
+		forChunks(begin, end, [&](Index from, Index to) {
+			partials[(from - begin) / size] = chunk(from, to);
+		}, size);
+
+		T result = identity;
+		for (T& partial : partials) result = combine(std::move(result), std::move(partial));
+		return result;
+	}
+}
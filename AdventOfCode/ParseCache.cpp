@@ -0,0 +1,125 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include "ParseCache.h"
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace cache {
+	namespace {
+		const char MAGIC[4] = { 'A', 'O', 'C', 'P' };
+
+		// 64 bits at a time, each mixed in with a multiply and xor-shift (the tail bytes padded with zeros)
+		uint64_t hashText(string_view text) {
+			const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ull;
+			uint64_t hash = 0xCBF29CE484222325ull;
+			size_t i = 0;
+			for (; i + 8 <= text.size(); i += 8) {
+				uint64_t word;
+				memcpy(&word, text.data() + i, 8);
+				hash = (hash ^ word) * MULTIPLIER;
+				hash ^= hash >> 29;
+			}
+			if (i < text.size()) {
+				uint64_t word = 0;
+				memcpy(&word, text.data() + i, text.size() - i);
+				hash = (hash ^ word) * MULTIPLIER;
+				hash ^= hash >> 29;
+			}
+			return hash;
+		}
+
+		Writer header(const Key& key) {
+			Writer writer;
+			for (char c : MAGIC) writer.put(c);
+			writer.put(FORMAT_VERSION);
+			writer.put(key.day);
+			writer.put(key.modelVersion);
+			writer.put(key.inputHash);
+			writer.put(key.inputSize);
+			return writer;
+		}
+
+		filesystem::path pathFor(const string& dir, const Key& key) {
+			ostringstream name;
+			name << "Day" << key.day << "-" << hex << setw(16) << setfill('0') << key.inputHash << ".bin";
+			return filesystem::path(dir) / name.str();
+		}
+
+		// Unique to this process and call, so concurrent stores of the same file (other runs, or other
+		// threads of this one) each write their own and the last rename wins
+		filesystem::path temporaryFor(const string& path) {
+			static atomic<uint64_t> counter{ 0 };
+			return path + "." + to_string(getpid()) + "-" + to_string(counter++) + ".tmp";
+		}
+	}
+
+	Key keyFor(int day, int modelVersion, string_view text) {
+		return { static_cast<uint32_t>(day), static_cast<uint32_t>(modelVersion), hashText(text), text.size() };
+	}
+
+	optional<Entry> find(const string& dir, const Key& key) {
+		return findFile(pathFor(dir, key).string(), key);
+	}
+
+	void store(const string& dir, const Key& key, const Writer& payload) {
+		filesystem::create_directories(dir);
+		storeFile(pathFor(dir, key).string(), key, payload);
+	}
+
+	optional<Entry> findFile(const string& path, const Key& key) {
+		error_code error;
+		if (!filesystem::is_regular_file(path, error)) return nullopt;
+
+		InputFile file(path);
+		Writer expected = header(key);
+		size_t headerSize = expected.data().size();
+		if (file.text().substr(0, headerSize) != expected.data()) return nullopt; // stale, or some other version's
+		return Entry(std::move(file), headerSize);
+	}
+
+	void storeFile(const string& path, const Key& key, const Writer& payload) {
+		// other runs could be reading the old file, so write alongside and rename over it
+		filesystem::path temporary = temporaryFor(path);
+		try {
+			{
+				ofstream file(temporary, ios::binary);
+				if (!file) throw invalid_argument("Failed to open " + temporary.string());
+				Writer headerBytes = header(key);
+				file.write(headerBytes.data().data(), headerBytes.data().size());
+				file.write(payload.data().data(), payload.data().size());
+				if (!file) throw invalid_argument("Failed to write " + temporary.string());
+			}
+			filesystem::rename(temporary, path);
+		}
+		catch (...) {
+			// e.g. a full disk, so don't leave a partial file behind as well
+			error_code error;
+			filesystem::remove(temporary, error);
+			throw;
+		}
+	}
+
+	void removeTemporaries(const string& path) {
+		filesystem::path target(path);
+		filesystem::path dir = target.has_parent_path() ? target.parent_path() : filesystem::path(".");
+		string prefix = target.filename().string() + ".";
+		error_code error;
+		for (const filesystem::directory_entry& entry : filesystem::directory_iterator(dir, error)) {
+			string name = entry.path().filename().string();
+			if (name.size() > prefix.size() + 4 && name.starts_with(prefix) && name.ends_with(".tmp")) {
+				filesystem::remove(entry.path(), error);
+			}
+		}
+	}
+}
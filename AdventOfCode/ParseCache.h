@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "Input.h"
+
+/*
+Parsed models saved as binary files, so repeated runs on an unchanged input can skip parsing.
+
+A cache file is a small header (format version, day, the day's model version, and a hash and length of
+the input text) followed by whatever the day chose to write. It's only used when every field of the header
+matches, so changing an input, or bumping a day's model version when its layout changes, just means
+it gets parsed and cached again.
+Values are written in the machine's own byte order and layout: files are a local cache, not for sharing.
+*/
+namespace cache {
+	// Of the header, bump if it ever changes
+	const uint32_t FORMAT_VERSION = 1;
+
+	class Writer {
+	private:
+		std::string bytes;
+
+	public:
+		template <typename T>
+		void put(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be written directly");
+			bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		void putString(std::string_view s) {
+			put<uint64_t>(s.size());
+			bytes.append(s);
+		}
+
+		template <typename T>
+		void putSpan(std::span<const T> values) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be written directly");
+			put<uint64_t>(values.size());
+			bytes.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+		}
+
+		template <typename T>
+		void putVector(const std::vector<T>& values) {
+			putSpan(std::span<const T>(values));
+		}
+
+		std::string_view data() const {
+			return bytes;
+		}
+	};
+
+	// Reads back what a Writer wrote, in the same order. Throws invalid_argument if it runs off the end.
+	class Reader {
+	private:
+		std::string_view rest;
+
+		const char* take(size_t size) {
+			if (size > rest.size()) throw std::invalid_argument("Cache file is truncated");
+			const char* start = rest.data();
+			rest.remove_prefix(size);
+			return start;
+		}
+
+	public:
+		explicit Reader(std::string_view bytes) : rest(bytes) {}
+
+		template <typename T>
+		T get() {
+			static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be read directly");
+			T value;
+			std::memcpy(&value, take(sizeof(T)), sizeof(T));
+			return value;
+		}
+
+		// Points into the mapped file, so copy it if it's needed for longer than the Reader
+		std::string_view getString() {
+			size_t size = get<uint64_t>();
+			return { take(size), size };
+		}
+
+		// Into values, which must already be the size that was written
+		template <typename T>
+		void getSpan(std::span<T> values) {
+			if (get<uint64_t>() != values.size()) throw std::invalid_argument("Cache file has the wrong number of values");
+			std::memcpy(values.data(), take(values.size_bytes()), values.size_bytes());
+		}
+
+		template <typename T>
+		std::vector<T> getVector() {
+			// checked before allocating, so a corrupt count can't ask for more memory than the file has
+			uint64_t count = get<uint64_t>();
+			if (count > rest.size() / sizeof(T)) throw std::invalid_argument("Cache file is truncated");
+			std::vector<T> values(static_cast<size_t>(count));
+			std::memcpy(values.data(), take(values.size() * sizeof(T)), values.size() * sizeof(T));
+			return values;
+		}
+
+		// Bytes left to read, to check sizes against before allocating for them
+		size_t remaining() const {
+			return rest.size();
+		}
+
+		bool atEnd() const {
+			return rest.empty();
+		}
+	};
+
+	// Identifies which input (and which version of a day's model of it) a cache file is for
+	struct Key {
+		uint32_t day;
+		uint32_t modelVersion;
+		uint64_t inputHash;
+		uint64_t inputSize;
+	};
+
+	Key keyFor(int day, int modelVersion, std::string_view text);
+
+	// A cache file for a key, mapped into memory
+	class Entry {
+	private:
+		InputFile file;
+		size_t headerSize;
+
+	public:
+		Entry(InputFile&& file, size_t headerSize) : file(std::move(file)), headerSize(headerSize) {}
+
+		// What the day wrote, only valid while the Entry is alive
+		Reader payload() const {
+			return Reader(file.text().substr(headerSize));
+		}
+	};
+
+	// Nothing if there's no file in dir for this key, or its header doesn't match
+	std::optional<Entry> find(const std::string& dir, const Key& key);
+
+	// Replaces any existing file for the key in one go, so a half-written file is never read.
+	// Creates dir if needed. Throws if it can't be written (leaving any existing file as it was).
+	void store(const std::string& dir, const Key& key, const Writer& payload);
+
+	// Same as find and store, for files named some other way (e.g. simulation snapshots, see Checkpoint.h)
+	std::optional<Entry> findFile(const std::string& path, const Key& key);
+	void storeFile(const std::string& path, const Key& key, const Writer& payload);
+
+	// Removes any temporary files storeFile left for path, from runs killed while writing it
+	void removeTemporaries(const std::string& path);
+}
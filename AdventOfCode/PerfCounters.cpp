@@ -0,0 +1,124 @@
+#include <cstring>
+#include <cerrno>
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace perf {
+	const array<const char*, EVENT_COUNT> eventNames{ "cycles", "instructions", "cache_misses", "branch_misses" };
+
+	Counts& Counts::operator+=(const Counts& other) {
+		for (int e = 0; e < EVENT_COUNT; e++) {
+			values[e] += other.values[e];
+			// only meaningful if every run had it
+			valid[e] = valid[e] && other.valid[e];
+		}
+		return *this;
+	}
+
+	Counts Counts::operator/(uint64_t runs) const {
+		Counts result = *this;
+		for (uint64_t& value : result.values) value /= runs;
+		return result;
+	}
+
+	double Counts::ipc() const {
+		if (!valid[CYCLES] || !valid[INSTRUCTIONS] || values[CYCLES] == 0) return -1;
+		return static_cast<double>(values[INSTRUCTIONS]) / values[CYCLES];
+	}
+
+	bool Counters::anyAvailable() const {
+		for (int fd : fds) {
+			if (fd >= 0) return true;
+		}
+		return false;
+	}
+
+#ifdef __linux__
+
+	const array<uint64_t, EVENT_COUNT> eventConfigs{
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+	};
+
+	int openEvent(uint64_t config) {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// and threads started after this, e.g. the pool's, which reads and the ioctls below include
+		attr.inherit = 1;
+		// this thread, any CPU, no group
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+
+	Counters::Counters() {
+		for (int e = 0; e < EVENT_COUNT; e++) {
+			fds[e] = openEvent(eventConfigs[e]);
+			if (fds[e] < 0 && problem.empty()) {
+				problem = string("perf_event_open(") + eventNames[e] + "): " + strerror(errno);
+			}
+		}
+	}
+
+	Counters::~Counters() {
+		for (int fd : fds) {
+			if (fd >= 0) close(fd);
+		}
+	}
+
+	void Counters::start() {
+		for (int fd : fds) {
+			if (fd < 0) continue;
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	Counts Counters::stop() {
+		for (int fd : fds) {
+			if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		}
+
+		Counts counts;
+		for (int e = 0; e < EVENT_COUNT; e++) {
+			if (fds[e] < 0) continue;
+
+			uint64_t data[3]; // value, time enabled, time running
+			if (read(fds[e], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+
+			double scale = static_cast<double>(data[1]) / data[2];
+			counts.values[e] = static_cast<uint64_t>(data[0] * scale);
+			counts.valid[e] = true;
+		}
+		return counts;
+	}
+
+#else
+
+	Counters::Counters() : problem("hardware counters are only supported on Linux") {
+		fds.fill(-1);
+	}
+
+	Counters::~Counters() {}
+
+	void Counters::start() {}
+
+	Counts Counters::stop() {
+		return {};
+	}
+
+#endif
+}
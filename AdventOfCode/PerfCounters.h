@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <array>
+
+/*
+Hardware performance counters for the benchmark, via Linux perf_event_open.
+
+Each event is opened on its own, user space only, so the benchmark still gets whatever the
+machine allows (perf_event_paranoid <= 2, no kernel counting needed). Events that can't be opened,
+e.g. in a VM without a virtual PMU or on other platforms, are just reported as unavailable.
+Counts cover the thread that opens them and any threads it starts afterwards, so open them before
+the thread pool (Parallel.h) is first used, and work days hand to the pool is counted too.
+*/
+namespace perf {
+	enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+	// JSON-friendly names, indexed by Event
+	extern const std::array<const char*, EVENT_COUNT> eventNames;
+
+	struct Counts {
+		std::array<uint64_t, EVENT_COUNT> values{};
+		std::array<bool, EVENT_COUNT> valid{};
+
+		Counts& operator+=(const Counts& other);
+		Counts operator/(uint64_t runs) const;
+
+		// instructions per cycle, or a negative value if either is missing
+		double ipc() const;
+	};
+
+	class Counters {
+	private:
+		std::array<int, EVENT_COUNT> fds;
+		std::string problem; // why any events are missing
+
+	public:
+		Counters();
+		~Counters();
+
+		Counters(const Counters&) = delete;
+		Counters& operator=(const Counters&) = delete;
+
+		bool anyAvailable() const;
+		const std::string& unavailableReason() const { return problem; }
+
+		// Zero and start every open counter
+		void start();
+		// Stop and read them, scaled up if the kernel had to multiplex them
+		Counts stop();
+	};
+}
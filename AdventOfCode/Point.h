@@ -11,22 +11,22 @@ public:
 	T x;
 	T y;
 
-	Point() : Point<T>(0, 0) {}
-	Point(const T& x, const T& y) : x(x), y(y) {}
+	constexpr Point() : Point<T>(0, 0) {}
+	constexpr Point(const T& x, const T& y) : x(x), y(y) {}
 
 	// copy/move constructors are implicit
 	//Point(const Point<T>& p) = default;
 	//Point(Point<T>&& p) = default;
 
-	bool operator==(const Point<T>&) const = default;
+	constexpr bool operator==(const Point<T>&) const = default;
 
-	auto operator<=>(const Point<T>&) const = default;
+	constexpr auto operator<=>(const Point<T>&) const = default;
 
-	Point<T> operator+(const Point<T>& p) const {
+	constexpr Point<T> operator+(const Point<T>& p) const {
 		return Point<T>(x + p.x, y + p.y);
 	}
 
-	T dot(const Point<T>& p) const {
+	constexpr T dot(const Point<T>& p) const {
 		return x * p.x + y * p.y;
 	}
 
@@ -39,10 +39,10 @@ public:
 /*
 Point may use int, or int64, but should always have valid casts for -1/0/1 (so not size_t, which is unsigned)
 */
-template<class T> const Point<T> Point<T>::LEFT{ -1, 0 };
-template<class T> const Point<T> Point<T>::RIGHT{ 1, 0 };
-template<class T> const Point<T> Point<T>::UP{ 0, 1 };
-template<class T> const Point<T> Point<T>::DOWN{ 0, -1 };
+template<class T> constexpr Point<T> Point<T>::LEFT{ -1, 0 };
+template<class T> constexpr Point<T> Point<T>::RIGHT{ 1, 0 };
+template<class T> constexpr Point<T> Point<T>::UP{ 0, 1 };
+template<class T> constexpr Point<T> Point<T>::DOWN{ 0, -1 };
 
 template<class T> inline std::ostream& operator<<(std::ostream& stream, Point<T> const& p) {
 	return stream << "(" << p.x << ", " << p.y << ")";
@@ -1,52 +1,65 @@
 #pragma once
 
 #include <compare>
-#include <vector>
+#include <array>
+#include <ostream>
 #include <stdexcept>
 
+#include "Point.h"
+
+/*
+All constexpr and fixed size, so folding/rotating faces never allocates, and can be done at compile time.
+*/
+
 class Point3 {
+private:
+	// std::abs isn't constexpr until C++23
+	static constexpr int absolute(int v) {
+		return v < 0 ? -v : v;
+	}
+
 public:
 	int x;
 	int y;
 	int z;
 
-	Point3() : Point3(0, 0, 0) {}
-	Point3(const int x, const int y, const int z) : x(x), y(y), z(z) {}
-	Point3(const Point<int>& point2) : Point3(point2.x, point2.y, 0) {}
+	constexpr Point3() : Point3(0, 0, 0) {}
+	constexpr Point3(const int x, const int y, const int z) : x(x), y(y), z(z) {}
+	constexpr Point3(const Point<int>& point2) : Point3(point2.x, point2.y, 0) {}
 
-	bool operator==(const Point3&) const = default;
+	constexpr bool operator==(const Point3&) const = default;
 
-	auto operator<=>(const Point3&) const = default;
+	constexpr auto operator<=>(const Point3&) const = default;
 
-	Point3 operator+(const Point3& p) const {
+	constexpr Point3 operator+(const Point3& p) const {
 		return Point3(x + p.x, y + p.y, z + p.z);
 	}
 
-	Point3 operator-(const Point3& p) const {
+	constexpr Point3 operator-(const Point3& p) const {
 		return Point3(x - p.x, y - p.y, z - p.z);
 	}
 
-	Point3 normalise() const {
+	constexpr Point3 normalise() const {
 		// Simplified, we only care about things that are axis-aligned
 		int nonZero = (x != 0) + (y != 0) + (z != 0);
-		int scale = std::abs(x) + std::abs(y) + std::abs(z);
 		if (nonZero != 1) throw std::invalid_argument("Only expect to normalise axis-aligned vectors");
+		int scale = absolute(x) + absolute(y) + absolute(z);
 		return { x / scale, y / scale, z / scale };
 	}
 
-	Point3 abs() const {
-		return { std::abs(x), std::abs(y), std::abs(z) };
+	constexpr Point3 abs() const {
+		return { absolute(x), absolute(y), absolute(z) };
 	}
 
-	int sum() const {
+	constexpr int sum() const {
 		return x + y + z;
 	}
 
-	int dot(const Point3& v) const {
+	constexpr int dot(const Point3& v) const {
 		return x * v.x + y * v.y + z * v.z;
 	}
 
-	Point3 operator*(int scalar) const {
+	constexpr Point3 operator*(int scalar) const {
 		return { x * scalar, y * scalar, z * scalar };
 	}
 
@@ -58,14 +71,14 @@ public:
 	const static Point3 BACK;
 };
 
-const Point3 Point3::LEFT{ -1, 0, 0 };
-const Point3 Point3::RIGHT{ 1, 0, 0 };
-const Point3 Point3::UP{ 0, 1, 0 };
-const Point3 Point3::DOWN{ 0, -1, 0 };
-const Point3 Point3::FORWARD{ 0, 0, 1 };
-const Point3 Point3::BACK{ 0, 0, -1 };
+inline constexpr Point3 Point3::LEFT{ -1, 0, 0 };
+inline constexpr Point3 Point3::RIGHT{ 1, 0, 0 };
+inline constexpr Point3 Point3::UP{ 0, 1, 0 };
+inline constexpr Point3 Point3::DOWN{ 0, -1, 0 };
+inline constexpr Point3 Point3::FORWARD{ 0, 0, 1 };
+inline constexpr Point3 Point3::BACK{ 0, 0, -1 };
 
-inline Point3 operator*(const int scalar, const Point3& v) {
+constexpr Point3 operator*(const int scalar, const Point3& v) {
 	return v * scalar;
 }
 
@@ -78,23 +91,23 @@ public:
 	Point3 from;
 	Point3 to;
 
-	Line(const Point3& from, const Point3& to) : from(from), to(to) {}
+	constexpr Line(const Point3& from, const Point3& to) : from(from), to(to) {}
 
-	bool operator==(const Line&) const = default;
-	auto operator<=>(const Line&) const = default;
+	constexpr bool operator==(const Line&) const = default;
+	constexpr auto operator<=>(const Line&) const = default;
 
-	Line reversed() const {
+	constexpr Line reversed() const {
 		return { to, from };
 	}
 
-	Point3 asVector() const {
+	constexpr Point3 asVector() const {
 		return to - from;
 	}
 
 
 	const static Line NONE;
 };
-const Line Line::NONE({}, {}); // the line (0,0,0) to (0,0,0)
+inline constexpr Line Line::NONE({}, {}); // the line (0,0,0) to (0,0,0)
 
 inline std::ostream& operator<<(std::ostream& stream, Line const& l) {
 	return stream << "" << l.from << " -> " << l.to << ")";
@@ -107,25 +120,28 @@ inline std::ostream& operator<<(std::ostream& stream, Line const& l) {
 */
 class Face {
 public:
-	std::vector<Point3> points;
+	static const int SIDES = 4;
+
+	std::array<Point3, SIDES> points;
 
-	Face(const std::vector<Point3>& points) : points(points) {}
+	constexpr Face() = default;
+	constexpr Face(const std::array<Point3, SIDES>& points) : points(points) {}
 
-	bool operator==(const Face&) const = default;
-	auto operator<=>(const Face&) const = default;
+	constexpr bool operator==(const Face&) const = default;
+	constexpr auto operator<=>(const Face&) const = default;
 
-	const Point3& operator[](const int idx) const {
+	constexpr const Point3& operator[](const int idx) const {
 		// modulo indexing allows treating points as cyclic
 		return at(idx);
 	}
 
-	const Point3& at(const int idx) const {
+	constexpr const Point3& at(const int idx) const {
 		// modulo indexing allows treating points as cyclic
 		return points[(numPoints() + idx) % numPoints()];
 	}
 
-	int numPoints() const {
-		return static_cast<int>(points.size());
+	constexpr int numPoints() const {
+		return SIDES;
 	}
 
 	/*
@@ -134,7 +150,7 @@ public:
 	so expect the shared line to be (s1[i], s1[i+1]) = (s2[j+1], s2[j])
 	(accounting for possibly looping round s1[n-1] -> s1[0])
 	*/
-	Line touches(const Face& other) const {
+	constexpr Line touches(const Face& other) const {
 		// First find matching point s1[i], then check if edge s1[i] to s1[i+1] is present
 		for (int i = 0; i < numPoints(); i++) {
 			const Point3& p1 = at(i);
@@ -153,7 +169,7 @@ public:
 	// Expect this and other face to share an edge.
 	// if matching points on other face are other[j] -> other[j-1],
 	// direction moving along that face is then other[j] -> other[j+1]
-	Point3 dirOnTouchingFace(const Face& other) const {
+	constexpr Point3 dirOnTouchingFace(const Face& other) const {
 		for (int i = 0; i < numPoints(); i++) {
 			const Point3& p1 = at(i);
 			const Point3& p2 = at(i + 1);
@@ -179,25 +195,39 @@ public:
 		 [ xy + z    y^2       yz - x ]  [p_y] = [ p_x (xy + z) + p_y y^2 + p_z (yz - x) ]
 		 [ xz - y    yz + x    z^2    ]  [p_z]   [ p_x (xz - y) + p_y (yz + x) + p_z z^2 ]
 	*/
-	Face turnAround(const Line& line) const {
+	constexpr Face turnAround(const Line& line) const {
 		const Point3 normalisedDir = line.asVector().normalise();
 		int x = normalisedDir.x, y = normalisedDir.y, z = normalisedDir.z;
 		const Point3& rotationOrigin = line.from;
 
-		std::vector<Point3> newPoints;
-		for (int i = 0; i < points.size(); i++) {
+		std::array<Point3, SIDES> newPoints;
+		for (int i = 0; i < SIDES; i++) {
 			const Point3 p = points[i] - rotationOrigin;
 			const Point3 rotatedPoint = {
 			p.x*x*x + p.y*(x*y - z) + p.z*(x*z + y),
 			p.x*(x*y + z) + p.y*y*y + p.z*(y*z - x),
 			p.x*(x*z - y) + p.y*(y*z + x) + p.z*z*z
 			};
-			newPoints.push_back(rotationOrigin + rotatedPoint);
+			newPoints[i] = rotationOrigin + rotatedPoint;
 		}
 		return { newPoints };
 	}
 };
 
+// The throws above only stop these compiling if they're reached
+namespace point3_checks {
+	constexpr Line X_AXIS(Point3(0, 0, 0), Point3(1, 0, 0));
+	constexpr Face BOTTOM({ Point3(0, 0, 0), Point3(1, 0, 0), Point3(1, 1, 0), Point3(0, 1, 0) });
+	constexpr Face FOLDED({ Point3(0, 0, 0), Point3(1, 0, 0), Point3(1, 0, 1), Point3(0, 0, 1) });
+	constexpr Face BEHIND({ Point3(0, 0, 1), Point3(1, 0, 1), Point3(1, 0, 0), Point3(0, 0, 0) });
+	static_assert(BOTTOM.turnAround(X_AXIS) == FOLDED);
+	static_assert(FOLDED.turnAround(X_AXIS).turnAround(X_AXIS).turnAround(X_AXIS) == BOTTOM);
+	static_assert(BOTTOM.touches(BEHIND) == X_AXIS);
+	static_assert(BOTTOM.touches(FOLDED) == Line::NONE); // same winding, so not a neighbour on the cube
+	static_assert(BOTTOM.dirOnTouchingFace(BEHIND) == Point3::FORWARD);
+	static_assert(Point3(0, -3, 0).normalise() == Point3::DOWN);
+}
+
 inline std::ostream& operator<<(std::ostream& stream, Face const& f) {
 	stream << "{";
 	for (int i = 0; i < f.numPoints(); i++) {
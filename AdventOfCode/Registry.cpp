@@ -0,0 +1,219 @@
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+#include <optional>
+#include <tuple>
+
+#include "Registry.h"
+#include "Input.h"
+#include "ParseCache.h"
+#include "Day1.h"
+#include "Day2.h"
+#include "Day3.h"
+#include "Day4.h"
+#include "Day5.h"
+#include "Day6.h"
+#include "Day7.h"
+#include "Day8.h"
+#include "Day9.h"
+#include "Day10.h"
+#include "Day11.h"
+#include "Day12.h"
+#include "Day13.h"
+#include "Day14.h"
+#include "Day15.h"
+#include "Day16.h"
+#include "Day17.h"
+#include "Day18.h"
+#include "Day19.h"
+#include "Day20.h"
+#include "Day21.h"
+#include "Day22.h"
+#include "Day23.h"
+#include "Day24.h"
+#include "Day25.h"
+
+using namespace std;
+
+#ifndef AOC_INPUT_DIR
+#define AOC_INPUT_DIR "."
+#endif
+
+const string& Day::expected(int part) const {
+	switch (part) {
+	case 1: return expected1;
+	case 2: return expected2;
+	default: throw invalid_argument("Unknown part " + to_string(part) + ", expected 1 or 2");
+	}
+}
+
+bool Day::isDefaultInput(const string& inputPath) const {
+	error_code error;
+	return filesystem::equivalent(inputPath, filesystem::path(defaultInputDir()) / defaultInput(), error);
+}
+
+const Day::Part& Day::part(int n) const {
+	switch (n) {
+	case 1: return part1;
+	case 2: return part2;
+	default: throw invalid_argument("Unknown part " + to_string(n) + ", expected 1 or 2");
+	}
+}
+
+Day::Parsed Day::parseFile(const string& inputPath, const string& cacheDir, bool* fromCache) const {
+	InputFile input(inputPath);
+	if (fromCache != nullptr) *fromCache = false;
+	if (cacheDir.empty() || !load) return parse(input.text());
+
+	cache::Key key = cache::keyFor(number, modelVersion, input.text());
+	if (optional<cache::Entry> entry = cache::find(cacheDir, key)) {
+		try {
+			cache::Reader reader = entry->payload();
+			Parsed parsed = load(reader);
+			if (!reader.atEnd()) throw invalid_argument("Cache file has extra data");
+			if (fromCache != nullptr) *fromCache = true;
+			return parsed;
+		}
+		catch (const invalid_argument&) {
+			// corrupt, so parse as normal and write over it
+		}
+	}
+
+	Parsed parsed = parse(input.text());
+	cache::Writer writer;
+	save(parsed, writer);
+	try {
+		cache::store(cacheDir, key, writer);
+	}
+	catch (const exception& e) {
+		// e.g. a read-only or full cache directory, which shouldn't stop the day being solved
+		cerr << "Couldn't cache day " << number << "'s parsed input: " << e.what() << endl;
+	}
+	return parsed;
+}
+
+// Wraps a day's parse/solve functions, checking at compile time that they all agree on the model type
+template<typename Input>
+Day makeDay(int number, shared_ptr<const Input>(*parse)(string_view), string(*solve1)(const Input&), string(*solve2)(const Input&)) {
+	return {
+		number,
+		[parse](string_view text) -> Day::Parsed { return parse(text); },
+		[solve1](const Day::Parsed& parsed) { return solve1(*static_cast<const Input*>(parsed.get())); },
+		[solve2](const Day::Parsed& parsed) { return solve2(*static_cast<const Input*>(parsed.get())); },
+	};
+}
+
+// As above, for a day that can also save its model to a cache file and load it back
+template<typename Input>
+Day makeCachedDay(int number, shared_ptr<const Input>(*parse)(string_view), string(*solve1)(const Input&), string(*solve2)(const Input&),
+	int modelVersion, void(*save)(const Input&, cache::Writer&), shared_ptr<const Input>(*load)(cache::Reader&)) {
+	Day day = makeDay(number, parse, solve1, solve2);
+	day.modelVersion = modelVersion;
+	day.save = [save](const Day::Parsed& parsed, cache::Writer& out) { save(*static_cast<const Input*>(parsed.get()), out); };
+	day.load = [load](cache::Reader& in) -> Day::Parsed { return load(in); };
+	return day;
+}
+
+// As above, for a day that can also be solved from a stream
+template<typename Input>
+Day makeStreamedDay(int number, shared_ptr<const Input>(*parse)(string_view), string(*solve1)(const Input&), string(*solve2)(const Input&),
+	pair<string, string>(*stream)(StreamInput&)) {
+	Day day = makeDay(number, parse, solve1, solve2);
+	day.stream = stream;
+	return day;
+}
+
+// Answers to each day's own input, in day order. Day 25 only has the one puzzle.
+const pair<const char*, const char*> EXPECTED[] = {
+	{ "71471", "211189" }, // day 1
+	{ "14264", "12382" }, // day 2
+	{ "7581", "2525" }, // day 3
+	{ "424", "804" }, // day 4
+	{ "TLFGBZHCN", "QRQFHFWCL" }, // day 5
+	{ "1538", "2315" }, // day 6
+	{ "1444896", "404395" }, // day 7
+	{ "1708", "504000" }, // day 8
+	{ "5513", "2427" }, // day 9
+	{ "13520", // day 10
+		// letters drawn on the display
+		"###...##..###..#..#.###..####..##..###..\n"
+		"#..#.#..#.#..#.#..#.#..#.#....#..#.#..#.\n"
+		"#..#.#....#..#.####.###..###..#..#.###..\n"
+		"###..#.##.###..#..#.#..#.#....####.#..#.\n"
+		"#....#..#.#....#..#.#..#.#....#..#.#..#.\n"
+		"#.....###.#....#..#.###..####.#..#.###.." },
+	{ "90882", "30893109657" }, // day 11
+	{ "447", "446" }, // day 12
+	{ "6235", "22866" }, // day 13
+	{ "774", "22499" }, // day 14
+	{ "5147333", "13734006908372" }, // day 15
+	{ "2124", "2775" }, // day 16
+	{ "3168", "1554117647070" }, // day 17
+	{ "3448", "2052" }, // day 18
+	{ "1266", "5800" }, // day 19
+	{ "8302", "656575624777" }, // day 20
+	{ "21208142603224", "3882224466191" }, // day 21
+	{ "109094", "53324" }, // day 22
+	{ "4109", "1055" }, // day 23
+	{ "221", "739" }, // day 24
+	{ "2-0-01==0-1=2212=100", "" }, // day 25
+};
+
+vector<Day> withExpected(vector<Day> days) {
+	for (Day& day : days) {
+		tie(day.expected1, day.expected2) = EXPECTED[day.number - 1];
+	}
+	return days;
+}
+
+const vector<Day>& allDays() {
+	// in day order, so days[n - 1] is day n
+	static const vector<Day> days = withExpected({
+		makeStreamedDay(1, day1::parse, day1::solve1, day1::solve2, day1::solveStream),
+		makeStreamedDay(2, day2::parse, day2::solve1, day2::solve2, day2::solveStream),
+		makeStreamedDay(3, day3::parse, day3::solve1, day3::solve2, day3::solveStream),
+		makeStreamedDay(4, day4::parse, day4::solve1, day4::solve2, day4::solveStream),
+		makeDay(5, day5::parse, day5::solve1, day5::solve2),
+		makeStreamedDay(6, day6::parse, day6::solve1, day6::solve2, day6::solveStream),
+		makeDay(7, day7::parse, day7::solve1, day7::solve2),
+		makeDay(8, day8::parse, day8::solve1, day8::solve2),
+		makeDay(9, day9::parse, day9::solve1, day9::solve2),
+		makeStreamedDay(10, day10::parse, day10::solve1, day10::solve2, day10::solveStream),
+		makeDay(11, day11::parse, day11::solve1, day11::solve2),
+		makeDay(12, day12::parse, day12::solve1, day12::solve2),
+		makeDay(13, day13::parse, day13::solve1, day13::solve2),
+		makeDay(14, day14::parse, day14::solve1, day14::solve2),
+		makeDay(15, day15::parse, day15::solve1, day15::solve2),
+		makeCachedDay(16, day16::parse, day16::solve1, day16::solve2, day16::MODEL_VERSION, day16::save, day16::load),
+		makeDay(17, day17::parse, day17::solve1, day17::solve2),
+		makeDay(18, day18::parse, day18::solve1, day18::solve2),
+		makeDay(19, day19::parse, day19::solve1, day19::solve2),
+		makeDay(20, day20::parse, day20::solve1, day20::solve2),
+		makeCachedDay(21, day21::parse, day21::solve1, day21::solve2, day21::MODEL_VERSION, day21::save, day21::load),
+		makeCachedDay(22, day22::parse, day22::solve1, day22::solve2, day22::MODEL_VERSION, day22::save, day22::load),
+		makeDay(23, day23::parse, day23::solve1, day23::solve2),
+		makeDay(24, day24::parse, day24::solve1, day24::solve2),
+		makeStreamedDay(25, day25::parse, day25::solve1, day25::solve2, day25::solveStream),
+	});
+	return days;
+}
+
+const Day& getDay(int number) {
+	const vector<Day>& days = allDays();
+	if (number < 1 || number > static_cast<int>(days.size())) {
+		throw invalid_argument("No solution for day " + to_string(number));
+	}
+	return days[number - 1];
+}
+
+string defaultInputDir() {
+	return AOC_INPUT_DIR;
+}
+
+string resolveInput(const Day& day, const string& inputDir, const string& inputPath) {
+	string path = inputPath.empty()
+		? (filesystem::path(inputDir) / day.defaultInput()).string()
+		: inputPath;
+	if (!filesystem::exists(path)) throw invalid_argument("Input file not found: " + path);
+	return path;
+}
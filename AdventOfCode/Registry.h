@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <utility>
+
+namespace cache {
+	class Writer;
+	class Reader;
+}
+
+class StreamInput;
+
+/*
+Every puzzle solved so far, so the runner can pick days/parts by number rather than each day having its own main().
+Each day parses its input once into its own model, which both parts (and any repeated runs) then solve from.
+Parts return their answer rather than printing it.
+*/
+struct Day {
+	// Model type is specific to each day, so is only passed around type-erased
+	typedef std::shared_ptr<const void> Parsed;
+	typedef std::function<Parsed(std::string_view text)> Parser;
+	typedef std::function<std::string(const Parsed& parsed)> Part;
+	typedef std::function<void(const Parsed& parsed, cache::Writer& out)> Saver;
+	typedef std::function<Parsed(cache::Reader& in)> Loader;
+	typedef std::function<std::pair<std::string, std::string>(StreamInput& in)> Streamer;
+
+	int number;
+	Parser parse;
+	Part part1;
+	Part part2;
+
+	// Only for days whose parsed model can be cached (see ParseCache.h), otherwise empty.
+	// The version must be bumped whenever what save writes changes.
+	int modelVersion = 0;
+	Saver save;
+	Loader load;
+
+	// Only for single pass days, which can solve both parts from a stream in bounded memory, otherwise empty
+	Streamer stream;
+
+	// Answers to the input checked in alongside the day (defaultInput() in defaultInputDir()), empty if there isn't one
+	std::string expected1;
+	std::string expected2;
+
+	std::string defaultInput() const {
+		return "Day" + std::to_string(number) + ".txt";
+	}
+
+	const Part& part(int n) const;
+
+	const std::string& expected(int part) const;
+
+	// Whether inputPath is the input the expected answers are for, so can be checked against them
+	bool isDefaultInput(const std::string& inputPath) const;
+
+	// With a cacheDir, a cached model of the same input is loaded instead of parsing it, if there is one,
+	// and otherwise the model is saved there for next time. fromCache (if given) says which happened.
+	Parsed parseFile(const std::string& inputPath, const std::string& cacheDir = "", bool* fromCache = nullptr) const;
+};
+
+// Exit code of a run giving a different answer to an expected one, as opposed to 1 for anything else failing
+const int EXIT_WRONG_ANSWER = 2;
+
+const std::vector<Day>& allDays();
+
+// Where DayN.txt inputs are looked for, unless overridden on the command line.
+// CMake builds point this at the source directory, so binaries can be run from the build tree.
+std::string defaultInputDir();
+
+// Throws invalid_argument for a day that hasn't been solved
+const Day& getDay(int number);
+
+// inputPath if given, else the day's default input in inputDir. Throws invalid_argument if the file doesn't exist.
+std::string resolveInput(const Day& day, const std::string& inputDir, const std::string& inputPath = "");
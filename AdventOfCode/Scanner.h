@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <stdexcept>
+
+/*
+Allocation-free parsing of fixed-format lines, matching literal text and pulling out numbers/tokens in place.
+Replaces building an istringstream per line and skipping text with ignore(strlen("...")), e.g.
+
+	Scanner s(line); // "Sensor at x=2, y=18: ..."
+	s.expect("Sensor at x=");
+	int x = s.number<int>();
+	s.expect(", y=");
+
+Returned views point into the scanned text, so are only valid as long as it is.
+*/
+class Scanner {
+private:
+	const char* pos;
+	const char* end;
+
+	[[noreturn]] void fail(const std::string& expected) const {
+		throw std::invalid_argument("Expected " + expected + " at '" + std::string(pos, end) + "'");
+	}
+
+public:
+	explicit Scanner(std::string_view text) : pos(text.data()), end(text.data() + text.size()) {}
+
+	bool atEnd() const {
+		return pos == end;
+	}
+
+	// '\0' once at the end
+	char peek() const {
+		return pos == end ? '\0' : *pos;
+	}
+
+	void skip(size_t n = 1) {
+		pos = (static_cast<size_t>(end - pos) < n) ? end : pos + n;
+	}
+
+	void skipSpaces() {
+		while (pos != end && *pos == ' ') pos++;
+	}
+
+	// Skips the literal and returns true if the text continues with it, else leaves position unchanged
+	bool consume(std::string_view literal) {
+		if (static_cast<size_t>(end - pos) < literal.size() || std::string_view(pos, literal.size()) != literal) return false;
+		pos += literal.size();
+		return true;
+	}
+
+	void expect(std::string_view literal) {
+		if (!consume(literal)) fail("'" + std::string(literal) + "'");
+	}
+
+	// Optionally negative integer. Returns false (leaving position unchanged) if there isn't one.
+	template<typename T>
+	bool tryNumber(T& value) {
+		auto [next, ec] = std::from_chars(pos, end, value);
+		if (ec != std::errc()) return false;
+		pos = next;
+		return true;
+	}
+
+	template<typename T>
+	T number() {
+		T value{};
+		if (!tryNumber(value)) fail("a number");
+		return value;
+	}
+
+	// Everything up to (not including) delim, or the rest of the text if delim never appears
+	std::string_view until(char delim) {
+		const char* start = pos;
+		while (pos != end && *pos != delim) pos++;
+		return { start, static_cast<size_t>(pos - start) };
+	}
+
+	std::string_view rest() {
+		std::string_view remaining{ pos, static_cast<size_t>(end - pos) };
+		pos = end;
+		return remaining;
+	}
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdexcept>
+
+/*
+Working memory kept per thread between solves, so solving the same day over and over (e.g. a batch of inputs)
+reuses its buffers rather than allocating them afresh each time:
+
+	Scratch<Proposals> proposals; // borrowed until it goes out of scope
+	proposals->moves.clear();
+
+Whatever the last borrower left behind is still there, so callers must reset what they rely on.
+Only one borrower per type per thread at a time, throws logic_error otherwise (e.g. recursion).
+*/
+template <typename T>
+class Scratch {
+private:
+	struct Slot {
+		T value;
+		bool borrowed = false;
+	};
+
+	static Slot& slot() {
+		thread_local Slot threadSlot;
+		return threadSlot;
+	}
+
+	Slot& borrowed;
+
+public:
+	Scratch() : borrowed(slot()) {
+		if (borrowed.borrowed) throw std::logic_error("Scratch space is already in use on this thread");
+		borrowed.borrowed = true;
+	}
+
+	~Scratch() {
+		borrowed.borrowed = false;
+	}
+
+	Scratch(const Scratch&) = delete;
+	Scratch& operator=(const Scratch&) = delete;
+
+	T& operator*() const {
+		return borrowed.value;
+	}
+
+	T* operator->() const {
+		return &borrowed.value;
+	}
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+/*
+Counters for the branch-and-bound searches (day 16 dfs/dfs2, day 19 Blueprint::search),
+so changes to bounds or search order can be judged by how much of the tree they avoid.
+
+Only built in when AOC_SEARCH_STATS is defined (CMake -DAOC_SEARCH_STATS=ON),
+otherwise SEARCH_STAT expands to nothing and the searches pay nothing for it.
+Counts are per thread. The runner collects them for each part with countSearch(), and so do searches
+split across threads, crediting each task's counts back to the thread that waited for it.
+*/
+#ifdef AOC_SEARCH_STATS
+constexpr bool searchStatsCompiledIn = true;
+#else
+constexpr bool searchStatsCompiledIn = false;
+#endif
+
+struct SearchStats {
+	uint64_t expanded = 0; // nodes whose children were considered
+	uint64_t pruned = 0; // nodes cut off because their upper bound couldn't beat the best score
+	uint64_t improvements = 0; // times the best score was raised
+
+	SearchStats operator-(const SearchStats& other) const {
+		return { expanded - other.expanded, pruned - other.pruned, improvements - other.improvements };
+	}
+
+	SearchStats& operator+=(const SearchStats& other) {
+		expanded += other.expanded;
+		pruned += other.pruned;
+		improvements += other.improvements;
+		return *this;
+	}
+};
+
+// Counts for whatever search is running on this thread
+inline SearchStats& searchStats() {
+	thread_local SearchStats current;
+	return current;
+}
+
+// Runs search() and returns the counts it added on this thread, leaving this thread's own counts as they were
+template <typename Search>
+SearchStats countSearch(Search&& search) {
+	SearchStats before = searchStats();
+	search();
+	SearchStats counted = searchStats() - before;
+	searchStats() = before;
+	return counted;
+}
+
+inline std::ostream& operator<<(std::ostream& out, const SearchStats& s) {
+	return out << s.expanded << " expanded, " << s.pruned << " pruned, " << s.improvements << " improvements";
+}
+
+#ifdef AOC_SEARCH_STATS
+#define SEARCH_STAT(counter) (++searchStats().counter)
+#else
+#define SEARCH_STAT(counter)
+#endif
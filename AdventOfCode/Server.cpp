@@ -0,0 +1,353 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <set>
+
+#include "Server.h"
+#include "Output.h"
+#include "Parallel.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace server {
+	Day::Parsed Models::get(const Day& day, const string& inputPath, bool* resident) {
+		uintmax_t size = filesystem::file_size(inputPath);
+		filesystem::file_time_type modified = filesystem::last_write_time(inputPath);
+
+		{
+			lock_guard<std::mutex> lock(mutex);
+			auto it = models.find({ day.number, inputPath });
+			bool current = it != models.end() && it->second.size == size && it->second.modified == modified;
+			if (resident != nullptr) *resident = current;
+			if (current) return it->second.parsed;
+		}
+
+		// unlocked, so requests for other models aren't held up (two requests for the same one may both parse it)
+		Day::Parsed parsed = day.parseFile(inputPath, cacheDir);
+		lock_guard<std::mutex> lock(mutex);
+		models[{ day.number, inputPath }] = { parsed, size, modified };
+		return parsed;
+	}
+
+#ifdef _WIN32
+
+	// No Unix domain sockets to serve on
+	class Connection {};
+
+	void serve(const string&, const string&, const string&, unsigned) {
+		throw runtime_error("Serving isn't supported on Windows");
+	}
+
+	Client::Client(const string&) {
+		throw runtime_error("Serving isn't supported on Windows");
+	}
+
+	Client::~Client() = default;
+
+	Client::Answer Client::solve(int, int, const string&) {
+		throw runtime_error("Serving isn't supported on Windows");
+	}
+
+	void Client::shutdown() {}
+
+#else
+
+	class Connection {
+	private:
+		int fd;
+		string buffer; // received but not yet consumed
+
+		// False if the other end has closed
+		bool receive() {
+			char chunk[4096];
+			while (true) {
+				ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+				if (count > 0) {
+					buffer.append(chunk, static_cast<size_t>(count));
+					return true;
+				}
+				if (count == 0) return false;
+				if (errno == EAGAIN || errno == EWOULDBLOCK) throw runtime_error("Idle for too long");
+				if (errno != EINTR) throw runtime_error(string("Failed to read from socket: ") + strerror(errno));
+			}
+		}
+
+	public:
+		explicit Connection(int fd) : fd(fd) {}
+
+		~Connection() {
+			close(fd);
+		}
+
+		Connection(const Connection&) = delete;
+		Connection& operator=(const Connection&) = delete;
+
+		// Reads then throw runtime_error if nothing arrives for this long
+		void dropAfterIdle(int seconds) {
+			timeval timeout{};
+			timeout.tv_sec = seconds;
+			if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+				throw runtime_error(string("Failed to set socket timeout: ") + strerror(errno));
+			}
+		}
+
+		// Without the newline. False if the other end closed before sending a whole line.
+		bool readLine(string& line) {
+			size_t newline;
+			while ((newline = buffer.find('\n')) == string::npos) {
+				if (!receive()) return false;
+			}
+			line = buffer.substr(0, newline);
+			buffer.erase(0, newline + 1);
+			return true;
+		}
+
+		// Throws runtime_error if the other end closes first
+		string readBytes(size_t count) {
+			while (buffer.size() < count) {
+				if (!receive()) throw runtime_error("Connection closed mid-message");
+			}
+			string bytes = buffer.substr(0, count);
+			buffer.erase(0, count);
+			return bytes;
+		}
+
+		// Throws runtime_error if the other end has gone, rather than raising SIGPIPE
+		void write(const string& data) {
+			size_t sent = 0;
+			while (sent < data.size()) {
+				ssize_t count = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+				if (count < 0) {
+					if (errno == EINTR) continue;
+					throw runtime_error(string("Failed to write to socket: ") + strerror(errno));
+				}
+				sent += static_cast<size_t>(count);
+			}
+		}
+	};
+
+	sockaddr_un socketAddress(const string& socketPath) {
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+			throw runtime_error("Socket path must be 1 to " + to_string(sizeof(address.sun_path) - 1) + " characters: " + socketPath);
+		}
+		memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+		return address;
+	}
+
+	// -1 if nothing is listening there
+	int connectTo(const string& socketPath) {
+		sockaddr_un address = socketAddress(socketPath);
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) throw runtime_error(string("Failed to create socket: ") + strerror(errno));
+		if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+			int error = errno;
+			close(fd);
+			errno = error;
+			return -1;
+		}
+		return fd;
+	}
+
+	int listenOn(const string& socketPath) {
+		sockaddr_un address = socketAddress(socketPath);
+
+		struct stat info;
+		if (stat(socketPath.c_str(), &info) == 0) {
+			if (!S_ISSOCK(info.st_mode)) throw runtime_error("Not a socket, won't replace it: " + socketPath);
+			int other = connectTo(socketPath);
+			if (other >= 0) {
+				close(other);
+				throw runtime_error("Already being served: " + socketPath);
+			}
+			unlink(socketPath.c_str()); // left behind by a server that was killed
+		}
+
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) throw runtime_error(string("Failed to create socket: ") + strerror(errno));
+		if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+			string error = strerror(errno);
+			close(fd);
+			throw runtime_error("Failed to listen on " + socketPath + ": " + error);
+		}
+		return fd;
+	}
+
+	string response(const string& status, const string& body) {
+		return status + " " + to_string(body.size()) + "\n" + body;
+	}
+
+	// One line to cout, kept whole when connections log at the same time
+	void log(const string& line) {
+		static mutex logMutex;
+		lock_guard<mutex> lock(logMutex);
+		cout << line << endl;
+	}
+
+	// What to send back for a solve request. Logs it, and reports failures to the client rather than throwing.
+	string solveRequest(istringstream& fields, Models& models, const string& inputDir) {
+		auto start = chrono::steady_clock::now();
+		try {
+			int number, part;
+			if (!(fields >> number >> part)) throw invalid_argument("Expected: solve DAY PART [PATH]");
+			string path;
+			getline(fields, path);
+			if (!path.empty() && path[0] == ' ') path.erase(0, 1);
+
+			const Day& day = getDay(number);
+			const Day::Part& solve = day.part(part);
+			string inputPath = resolveInput(day, inputDir, path);
+
+			bool resident;
+			string answer;
+			{
+				OutputCapture capture; // anything printed along the way would just be noise in the log
+				Day::Parsed parsed = models.get(day, inputPath, &resident);
+				answer = solve(parsed);
+			}
+			double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+			ostringstream line;
+			line << "Day " << number << " part " << part << " (" << inputPath << "): " << ms << " ms, "
+				<< (resident ? "resident" : "parsed");
+			log(line.str());
+			return response("ok " + to_string(ms), answer);
+		}
+		catch (const exception& e) {
+			log(string("Failed: ") + e.what());
+			return response("error", e.what());
+		}
+	}
+
+	// Shared by the threads handling connections
+	struct ServerState {
+		string socketPath;
+		string inputDir;
+		Models models;
+		atomic<bool> running{ true };
+		mutex openMutex;
+		set<int> open; // sockets of connections being handled, while running
+	};
+
+	// Stops accepting connections, and ends the others once they've answered what they're working on
+	void stop(ServerState& state) {
+		{
+			lock_guard<mutex> lock(state.openMutex);
+			state.running = false;
+			for (int fd : state.open) ::shutdown(fd, SHUT_RD);
+		}
+		// wakes up the accept() in serve()
+		int wake = connectTo(state.socketPath);
+		if (wake >= 0) close(wake);
+	}
+
+	void handle(int fd, ServerState& state) {
+		Connection connection(fd);
+		try {
+			connection.dropAfterIdle(IDLE_TIMEOUT_SECONDS);
+			string line;
+			while (state.running && connection.readLine(line)) {
+				istringstream fields(line);
+				string command;
+				fields >> command;
+				if (command == "shutdown") {
+					connection.write("ok 0 0\n");
+					stop(state);
+				}
+				else if (command == "solve") connection.write(solveRequest(fields, state.models, state.inputDir));
+				else connection.write(response("error", "Unknown request: " + line));
+			}
+		}
+		catch (const exception& e) {
+			// only this client has gone wrong, so carry on with the others
+			log(string("Dropped connection: ") + e.what());
+		}
+		// before the connection closes it, so stop() never shuts down a reused descriptor
+		lock_guard<mutex> lock(state.openMutex);
+		state.open.erase(fd);
+	}
+
+	void serve(const string& socketPath, const string& inputDir, const string& cacheDir, unsigned threads) {
+		int listener = listenOn(socketPath);
+		cout << "Serving on " << socketPath << endl;
+
+		ServerState state{ socketPath, inputDir, Models(cacheDir) };
+		{
+			// a pool of its own, so connections waiting on their clients never hold up days' parallel work
+			ThreadPool connectionThreads(threads);
+			parallel::TaskGroup connections(connectionThreads);
+			while (true) {
+				int fd = accept(listener, nullptr, nullptr);
+				if (fd < 0) {
+					if (errno == EINTR || errno == ECONNABORTED) continue;
+					string error = strerror(errno);
+					stop(state);
+					connections.wait();
+					close(listener);
+					throw runtime_error("Failed to accept a connection: " + error);
+				}
+
+				lock_guard<mutex> lock(state.openMutex);
+				if (!state.running) {
+					close(fd);
+					break;
+				}
+				state.open.insert(fd);
+				connections.run([fd, &state]() { handle(fd, state); });
+			}
+			connections.wait();
+		}
+
+		close(listener);
+		unlink(socketPath.c_str());
+		cout << "Shut down with " << state.models.size() << " models resident" << endl;
+	}
+
+	Client::Client(const string& socketPath) {
+		int fd = connectTo(socketPath);
+		if (fd < 0) throw runtime_error("No server on " + socketPath + ": " + strerror(errno));
+		connection = make_unique<Connection>(fd);
+	}
+
+	Client::~Client() = default;
+
+	Client::Answer Client::solve(int day, int part, const string& inputPath) {
+		connection->write("solve " + to_string(day) + " " + to_string(part) + " " + inputPath + "\n");
+
+		string header;
+		if (!connection->readLine(header)) throw runtime_error("Server closed the connection");
+		istringstream fields(header);
+		string status;
+		fields >> status;
+
+		Answer answer{};
+		if (status == "ok") fields >> answer.serverMs;
+		size_t bytes;
+		if (!(fields >> bytes) || (status != "ok" && status != "error")) throw runtime_error("Bad response: " + header);
+
+		string body = connection->readBytes(bytes);
+		if (status == "error") throw runtime_error(body);
+		answer.answer = move(body);
+		return answer;
+	}
+
+	void Client::shutdown() {
+		connection->write("shutdown\n");
+		string header;
+		if (!connection->readLine(header) || header.rfind("ok", 0) != 0) throw runtime_error("Server didn't acknowledge shutdown");
+	}
+
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <filesystem>
+
+#include "Registry.h"
+
+/*
+Resident solver, so repeated queries skip process startup and reparsing. `aoc --serve SOCKET` keeps every model
+it parses (and each day's scratch space, see Scratch.h) between requests, and `aoc --connect SOCKET` sends it requests.
+
+Requests and responses are text over a Unix domain socket, any number per connection, one at a time
+(connections are served concurrently, so for more at once, open more connections):
+	solve DAY PART [PATH]   -> "ok MS BYTES\n" then the answer, or "error BYTES\n" then the message
+	shutdown                -> "ok 0 0\n", then the server stops
+where MS is how long the server took, including parsing if the model wasn't resident,
+and PATH (empty = the server's default input for the day) is resolved by the server, so should be absolute.
+*/
+namespace server {
+	// Parsed models by (day, input path), parsed again if the file has changed since. Thread safe.
+	class Models {
+	private:
+		struct Entry {
+			Day::Parsed parsed;
+			std::uintmax_t size;
+			std::filesystem::file_time_type modified;
+		};
+
+		std::map<std::pair<int, std::string>, Entry> models;
+		std::string cacheDir;
+		mutable std::mutex mutex; // of models, not held while parsing
+
+	public:
+		// With a cacheDir, models not yet resident are loaded from the parse cache where possible (see ParseCache.h)
+		explicit Models(const std::string& cacheDir = "") : cacheDir(cacheDir) {}
+
+		// resident (if given) says whether it was already parsed
+		Day::Parsed get(const Day& day, const std::string& inputPath, bool* resident = nullptr);
+
+		size_t size() const {
+			std::lock_guard<std::mutex> lock(mutex);
+			return models.size();
+		}
+	};
+
+	// Connections that send nothing for this long are dropped, so they can't hold on to a thread
+	const int IDLE_TIMEOUT_SECONDS = 60;
+
+	// Answers requests until asked to shut down, logging each to cout. Each connection is handled on one of
+	// `threads` threads (0 = one per core), separate from the pool days use for their own parallel work.
+	// Replaces a stale socket file left by a server that didn't shut down cleanly.
+	// Throws runtime_error if the socket can't be set up.
+	void serve(const std::string& socketPath, const std::string& inputDir, const std::string& cacheDir = "", unsigned threads = 0);
+
+	// One end of an open socket
+	class Connection;
+
+	class Client {
+	private:
+		std::unique_ptr<Connection> connection;
+
+	public:
+		// Throws runtime_error if there's no server listening
+		explicit Client(const std::string& socketPath);
+		~Client();
+
+		Client(const Client&) = delete;
+		Client& operator=(const Client&) = delete;
+
+		struct Answer {
+			std::string answer;
+			double serverMs;
+		};
+
+		// Throws runtime_error with the server's message if it fails to solve it
+		Answer solve(int day, int part, const std::string& inputPath);
+
+		void shutdown();
+	};
+}
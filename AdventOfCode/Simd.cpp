@@ -0,0 +1,252 @@
+#include <bit>
+#include <algorithm>
+
+#include "Simd.h"
+
+#if !defined(AOC_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define SIMD_AVX2_BUILT
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC allows AVX2 intrinsics anywhere, it's only the CPU that has to be checked
+#define AVX2_TARGET
+#else
+// Just these functions are compiled for AVX2, so the rest runs on any x86-64
+#define AVX2_TARGET __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+using namespace std;
+
+namespace simd {
+	namespace scalar {
+		void compareMask(const uint8_t* bytes, size_t count, uint8_t value, bool greater, uint64_t* out) {
+			for (size_t w = 0; w < wordsFor(count); w++) {
+				size_t end = min(count, (w + 1) * 64);
+				uint64_t word = 0;
+				for (size_t i = w * 64; i < end; i++) {
+					bool match = greater ? bytes[i] > value : bytes[i] == value;
+					word |= static_cast<uint64_t>(match) << (i % 64);
+				}
+				out[w] = word;
+			}
+		}
+
+		void equalMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+			compareMask(bytes, count, value, false, out);
+		}
+
+		void greaterMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+			compareMask(bytes, count, value, true, out);
+		}
+
+		void andMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			for (size_t i = 0; i < words; i++) out[i] = a[i] & b[i];
+		}
+
+		void orMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			for (size_t i = 0; i < words; i++) out[i] = a[i] | b[i];
+		}
+
+		void andNotMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			for (size_t i = 0; i < words; i++) out[i] = a[i] & ~b[i];
+		}
+
+		// Word i of in shifted up, as it would be after shifting the whole mask
+		inline uint64_t wordUp(const uint64_t* in, size_t i, size_t offset, size_t shift) {
+			if (i < offset) return 0;
+			uint64_t word = in[i - offset] << shift;
+			if (shift > 0 && i > offset) word |= in[i - offset - 1] >> (64 - shift);
+			return word;
+		}
+
+		inline uint64_t wordDown(const uint64_t* in, size_t words, size_t i, size_t offset, size_t shift) {
+			if (i + offset >= words) return 0;
+			uint64_t word = in[i + offset] >> shift;
+			if (shift > 0 && i + offset + 1 < words) word |= in[i + offset + 1] << (64 - shift);
+			return word;
+		}
+
+		// Each word only depends on those at or below it, so going from the top works in place
+		void shiftUp(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+			for (size_t i = words; i-- > 0;) out[i] = wordUp(in, i, bits / 64, bits % 64);
+		}
+
+		void shiftDown(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+			for (size_t i = 0; i < words; i++) out[i] = wordDown(in, words, i, bits / 64, bits % 64);
+		}
+
+		size_t popcount(const uint64_t* mask, size_t words) {
+			size_t count = 0;
+			for (size_t i = 0; i < words; i++) count += std::popcount(mask[i]);
+			return count;
+		}
+	}
+
+#ifdef SIMD_AVX2_BUILT
+	// 4 words or 32 bytes at a time, leaving whatever's left over to the scalar versions
+	namespace vec {
+		AVX2_TARGET inline __m256i load(const void* p) {
+			return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+		}
+
+		AVX2_TARGET inline void store(void* p, __m256i v) {
+			_mm256_storeu_si256(static_cast<__m256i*>(p), v);
+		}
+
+		AVX2_TARGET inline uint64_t movemask64(__m256i low, __m256i high) {
+			return static_cast<uint32_t>(_mm256_movemask_epi8(low)) | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32;
+		}
+
+		AVX2_TARGET void equalMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+			const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+			size_t i = 0;
+			for (; i + 64 <= count; i += 64) {
+				out[i / 64] = movemask64(_mm256_cmpeq_epi8(load(bytes + i), v), _mm256_cmpeq_epi8(load(bytes + i + 32), v));
+			}
+			if (i < count) scalar::equalMask(bytes + i, count - i, value, out + i / 64);
+		}
+
+		// No unsigned byte comparison, but x > value exactly when max(x, value + 1) == x
+		AVX2_TARGET void greaterMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+			if (value == UINT8_MAX) return scalar::greaterMask(bytes, count, value, out);
+			const __m256i v = _mm256_set1_epi8(static_cast<char>(value + 1));
+			size_t i = 0;
+			for (; i + 64 <= count; i += 64) {
+				__m256i low = load(bytes + i);
+				__m256i high = load(bytes + i + 32);
+				out[i / 64] = movemask64(_mm256_cmpeq_epi8(_mm256_max_epu8(low, v), low), _mm256_cmpeq_epi8(_mm256_max_epu8(high, v), high));
+			}
+			if (i < count) scalar::greaterMask(bytes + i, count - i, value, out + i / 64);
+		}
+
+		AVX2_TARGET void andMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			size_t i = 0;
+			for (; i + 4 <= words; i += 4) store(out + i, _mm256_and_si256(load(a + i), load(b + i)));
+			scalar::andMasks(a + i, b + i, out + i, words - i);
+		}
+
+		AVX2_TARGET void orMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			size_t i = 0;
+			for (; i + 4 <= words; i += 4) store(out + i, _mm256_or_si256(load(a + i), load(b + i)));
+			scalar::orMasks(a + i, b + i, out + i, words - i);
+		}
+
+		AVX2_TARGET void andNotMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+			size_t i = 0;
+			// andnot is ~first & second
+			for (; i + 4 <= words; i += 4) store(out + i, _mm256_andnot_si256(load(b + i), load(a + i)));
+			scalar::andNotMasks(a + i, b + i, out + i, words - i);
+		}
+
+		// Shifts by 64 or more give 0, so a whole number of words needs no special case
+		AVX2_TARGET void shiftUp(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+			const size_t offset = bits / 64;
+			const __m128i shift = _mm_cvtsi64_si128(static_cast<long long>(bits % 64));
+			const __m128i carry = _mm_cvtsi64_si128(static_cast<long long>(64 - bits % 64));
+			// from the top, reading words below the ones being written, so it works in place
+			size_t i = words;
+			while (i >= offset + 1 + 4) {
+				i -= 4;
+				__m256i word = _mm256_sll_epi64(load(in + i - offset), shift);
+				__m256i below = _mm256_srl_epi64(load(in + i - offset - 1), carry);
+				store(out + i, _mm256_or_si256(word, below));
+			}
+			while (i-- > 0) out[i] = scalar::wordUp(in, i, offset, bits % 64);
+		}
+
+		AVX2_TARGET void shiftDown(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+			const size_t offset = bits / 64;
+			const __m128i shift = _mm_cvtsi64_si128(static_cast<long long>(bits % 64));
+			const __m128i carry = _mm_cvtsi64_si128(static_cast<long long>(64 - bits % 64));
+			size_t i = 0;
+			for (; i + offset + 1 + 4 <= words; i += 4) {
+				__m256i word = _mm256_srl_epi64(load(in + i + offset), shift);
+				__m256i above = _mm256_sll_epi64(load(in + i + offset + 1), carry);
+				store(out + i, _mm256_or_si256(word, above));
+			}
+			for (; i < words; i++) out[i] = scalar::wordDown(in, words, i, offset, bits % 64);
+		}
+
+		AVX2_TARGET size_t popcount(const uint64_t* mask, size_t words) {
+			size_t count = 0;
+			for (size_t i = 0; i < words; i++) count += static_cast<size_t>(_mm_popcnt_u64(mask[i]));
+			return count;
+		}
+	}
+
+	bool cpuHasAvx2() {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+		// the OS has to save the AVX registers too
+		__cpuid(info, 1);
+		const int osxsave = 1 << 27, avx = 1 << 28;
+		if ((info[2] & (osxsave | avx)) != (osxsave | avx) || (_xgetbv(0) & 6) != 6) return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+	}
+#else
+	namespace vec = scalar;
+
+	bool cpuHasAvx2() {
+		return false;
+	}
+#endif
+
+	namespace {
+		bool avx2Allowed = true;
+	}
+
+	bool avx2() {
+		static const bool supported = cpuHasAvx2();
+		return supported && avx2Allowed;
+	}
+
+	void useAvx2(bool use) {
+		avx2Allowed = use;
+	}
+
+	void equalMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+		if (avx2()) vec::equalMask(bytes, count, value, out);
+		else scalar::equalMask(bytes, count, value, out);
+	}
+
+	void greaterMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out) {
+		if (avx2()) vec::greaterMask(bytes, count, value, out);
+		else scalar::greaterMask(bytes, count, value, out);
+	}
+
+	void andMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+		if (avx2()) vec::andMasks(a, b, out, words);
+		else scalar::andMasks(a, b, out, words);
+	}
+
+	void orMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+		if (avx2()) vec::orMasks(a, b, out, words);
+		else scalar::orMasks(a, b, out, words);
+	}
+
+	void andNotMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words) {
+		if (avx2()) vec::andNotMasks(a, b, out, words);
+		else scalar::andNotMasks(a, b, out, words);
+	}
+
+	void shiftUp(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+		if (avx2()) vec::shiftUp(in, out, words, bits);
+		else scalar::shiftUp(in, out, words, bits);
+	}
+
+	void shiftDown(const uint64_t* in, uint64_t* out, size_t words, size_t bits) {
+		if (avx2()) vec::shiftDown(in, out, words, bits);
+		else scalar::shiftDown(in, out, words, bits);
+	}
+
+	size_t popcount(const uint64_t* mask, size_t words) {
+		return avx2() ? vec::popcount(mask, words) : scalar::popcount(mask, words);
+	}
+}
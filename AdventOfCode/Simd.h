@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+Byte classification and bitmask kernels, run with AVX2 when the CPU has it and a word at a time otherwise,
+so days can work on whole rows or grids of bits at once without intrinsics or CPU checks of their own.
+
+A mask is an array of 64-bit words, bit i being bit i % 64 of word i / 64, e.g. one bit per cell of a grid:
+
+	vector<uint64_t> tall(simd::wordsFor(width));
+	simd::greaterMask(row, width, 5, tall.data()); // trees taller than 5
+	simd::andNotMasks(tall.data(), seen.data(), visible.data(), tall.size());
+
+Lengths are in words. An output can be the same array as an input, but mustn't otherwise overlap one.
+*/
+namespace simd {
+	// Whether the AVX2 versions are in use: built in (x86-64, without -DAOC_SIMD=OFF), supported by this CPU, and not turned off
+	bool avx2();
+
+	// False makes every function below use the word-at-a-time versions, e.g. to check the AVX2 ones against them
+	// (SimdCheck.cpp). Not thread safe, set before using any of them.
+	void useAvx2(bool use);
+
+	constexpr size_t wordsFor(size_t bits) {
+		return (bits + 63) / 64;
+	}
+
+	// Bit i set where bytes[i] == value, for the wordsFor(count) words of out, with any bits past count clear
+	void equalMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out);
+
+	// Bit i set where bytes[i] > value
+	void greaterMask(const uint8_t* bytes, size_t count, uint8_t value, uint64_t* out);
+
+	void andMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+
+	void orMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+
+	// a & ~b
+	void andNotMasks(const uint64_t* a, const uint64_t* b, uint64_t* out, size_t words);
+
+	// Moves every bit `bits` places towards the end of the mask (bit i -> i + bits), dropping those that go past it
+	void shiftUp(const uint64_t* in, uint64_t* out, size_t words, size_t bits);
+
+	// Moves every bit `bits` places towards the start of the mask (bit i -> i - bits)
+	void shiftDown(const uint64_t* in, uint64_t* out, size_t words, size_t bits);
+
+	// Number of bits set
+	size_t popcount(const uint64_t* mask, size_t words);
+}
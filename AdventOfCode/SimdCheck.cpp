@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include <cstdint>
+
+#include "Simd.h"
+
+using namespace std;
+
+// Checks the kernels in Simd.h, both the AVX2 versions and the word-at-a-time ones, against the obvious bit by bit
+// versions below, on random masks of awkward lengths. Run by ctest, exits with 1 if any differ.
+
+typedef vector<uint64_t> Mask;
+
+mt19937_64 rng(2022);
+int failures = 0;
+
+bool bit(const Mask& mask, size_t i) {
+	return (mask[i / 64] >> (i % 64)) & 1;
+}
+
+void setBit(Mask& mask, size_t i, bool value) {
+	if (value) mask[i / 64] |= uint64_t(1) << (i % 64);
+}
+
+Mask randomMask(size_t words) {
+	Mask mask(words);
+	for (uint64_t& word : mask) word = rng();
+	return mask;
+}
+
+// Mostly from a few values, so there are plenty of equal bytes, with the extremes in there too
+vector<uint8_t> randomBytes(size_t count) {
+	vector<uint8_t> bytes(count);
+	for (uint8_t& b : bytes) {
+		switch (rng() % 4) {
+		case 0: b = 0; break;
+		case 1: b = UINT8_MAX; break;
+		case 2: b = static_cast<uint8_t>(rng() % 4); break;
+		default: b = static_cast<uint8_t>(rng());
+		}
+	}
+	return bytes;
+}
+
+void check(bool ok, const string& what) {
+	if (ok) return;
+	failures++;
+	cout << "FAILED: " << what << endl;
+}
+
+// Runs each check with the word-at-a-time versions, then with AVX2 if the CPU has it
+void bothWays(const function<void(const string& version)>& body) {
+	simd::useAvx2(false);
+	body("scalar");
+	simd::useAvx2(true);
+	if (simd::avx2()) body("avx2");
+}
+
+void checkCompareMasks(size_t count) {
+	vector<uint8_t> bytes = randomBytes(count);
+	for (uint8_t value : { uint8_t(0), uint8_t(1), uint8_t(2), uint8_t(127), uint8_t(128), uint8_t(UINT8_MAX - 1), uint8_t(UINT8_MAX) }) {
+		Mask equal(simd::wordsFor(count)), greater(simd::wordsFor(count));
+		for (size_t i = 0; i < count; i++) {
+			setBit(equal, i, bytes[i] == value);
+			setBit(greater, i, bytes[i] > value);
+		}
+		bothWays([&](const string& version) {
+			string name = " of " + to_string(count) + " bytes against " + to_string(value) + " (" + version + ")";
+			// garbage to start with, to check every word gets written, including the bits past count
+			Mask out = randomMask(equal.size());
+			simd::equalMask(bytes.data(), count, value, out.data());
+			check(out == equal, "equalMask" + name);
+			out = randomMask(greater.size());
+			simd::greaterMask(bytes.data(), count, value, out.data());
+			check(out == greater, "greaterMask" + name);
+		});
+	}
+}
+
+void checkLogic(size_t words) {
+	Mask a = randomMask(words), b = randomMask(words);
+	Mask both(words), either(words), aNotB(words);
+	for (size_t i = 0; i < words; i++) {
+		both[i] = a[i] & b[i];
+		either[i] = a[i] | b[i];
+		aNotB[i] = a[i] & ~b[i];
+	}
+
+	typedef void (*Op)(const uint64_t*, const uint64_t*, uint64_t*, size_t);
+	auto checkOp = [&](const string& name, Op op, const Mask& expected) {
+		bothWays([&](const string& version) {
+			string suffix = " of " + to_string(words) + " words (" + version + ")";
+			Mask out(words);
+			op(a.data(), b.data(), out.data(), words);
+			check(out == expected, name + suffix);
+			Mask inPlace = a;
+			op(inPlace.data(), b.data(), inPlace.data(), words);
+			check(inPlace == expected, name + " in place of a" + suffix);
+			inPlace = b;
+			op(a.data(), inPlace.data(), inPlace.data(), words);
+			check(inPlace == expected, name + " in place of b" + suffix);
+		});
+	};
+	checkOp("andMasks", simd::andMasks, both);
+	checkOp("orMasks", simd::orMasks, either);
+	checkOp("andNotMasks", simd::andNotMasks, aNotB);
+}
+
+void checkShifts(size_t words) {
+	Mask in = randomMask(words);
+	size_t bits = words * 64;
+	for (size_t shift : { size_t(0), size_t(1), size_t(5), size_t(63), size_t(64), size_t(65), size_t(127), size_t(128), size_t(200), bits, bits + 5 }) {
+		Mask up(words), down(words);
+		for (size_t i = 0; i < bits; i++) {
+			setBit(up, i, i >= shift && bit(in, i - shift));
+			setBit(down, i, i + shift < bits && bit(in, i + shift));
+		}
+		bothWays([&](const string& version) {
+			string name = " of " + to_string(words) + " words by " + to_string(shift) + " (" + version + ")";
+			Mask out = randomMask(words);
+			simd::shiftUp(in.data(), out.data(), words, shift);
+			check(out == up, "shiftUp" + name);
+			out = in;
+			simd::shiftUp(out.data(), out.data(), words, shift);
+			check(out == up, "shiftUp in place" + name);
+			out = randomMask(words);
+			simd::shiftDown(in.data(), out.data(), words, shift);
+			check(out == down, "shiftDown" + name);
+			out = in;
+			simd::shiftDown(out.data(), out.data(), words, shift);
+			check(out == down, "shiftDown in place" + name);
+		});
+	}
+}
+
+void checkPopcount(size_t words) {
+	Mask mask = randomMask(words);
+	size_t expected = 0;
+	for (size_t i = 0; i < words * 64; i++) expected += bit(mask, i);
+	bothWays([&](const string& version) {
+		check(simd::popcount(mask.data(), words) == expected, "popcount of " + to_string(words) + " words (" + version + ")");
+	});
+}
+
+int main() {
+	cout << "AVX2 " << (simd::avx2() ? "in use, checking both versions" : "not in use, checking just the word-at-a-time versions") << endl;
+
+	// around the 64 byte / 4 word blocks the AVX2 versions work in, with odd lengths left over
+	for (size_t count : { 0, 1, 31, 32, 33, 63, 64, 65, 127, 128, 129, 200, 255, 256, 257, 1000 }) checkCompareMasks(count);
+	for (size_t words : { 0, 1, 2, 3, 4, 5, 7, 8, 9, 13, 17, 33 }) {
+		checkLogic(words);
+		checkShifts(words);
+		checkPopcount(words);
+	}
+
+	if (failures > 0) {
+		cout << failures << " checks failed" << endl;
+		return 1;
+	}
+	cout << "All passed" << endl;
+	return 0;
+}
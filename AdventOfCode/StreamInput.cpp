@@ -0,0 +1,62 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "StreamInput.h"
+
+using namespace std;
+
+StreamInput::StreamInput(FILE* file, size_t chunkSize) : file(file), buffer(chunkSize) {
+	if (chunkSize == 0) throw invalid_argument("Chunk size must be positive");
+}
+
+bool StreamInput::fill() {
+	if (finished) return false;
+
+	if (begin > 0) {
+		memmove(buffer.data(), buffer.data() + begin, end - begin);
+		end -= begin;
+		begin = 0;
+	}
+	// all one unfinished line, so make room for more of it
+	if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+
+	size_t read = fread(buffer.data() + end, 1, buffer.size() - end, file);
+	if (read == 0) {
+		if (ferror(file)) throw runtime_error("Failed to read input stream");
+		finished = true;
+		return false;
+	}
+	end += read;
+	total += read;
+	return true;
+}
+
+bool StreamInput::nextChunk(string_view& chunk) {
+	if (begin == end && !fill()) return false;
+	chunk = { buffer.data() + begin, end - begin };
+	begin = end;
+	return true;
+}
+
+bool StreamInput::nextLine(string_view& line) {
+	size_t searched = begin; // no need to look through the same bytes again after each fill
+	while (true) {
+		const char* newline = static_cast<const char*>(memchr(buffer.data() + searched, '\n', end - searched));
+		if (newline != nullptr) {
+			size_t lineEnd = newline - buffer.data();
+			line = { buffer.data() + begin, lineEnd - begin };
+			begin = lineEnd + 1;
+			return true;
+		}
+
+		size_t unfinished = end - begin;
+		if (!fill()) {
+			// last line without a trailing newline
+			if (begin == end) return false;
+			line = { buffer.data() + begin, end - begin };
+			begin = end;
+			return true;
+		}
+		searched = begin + unfinished;
+	}
+}
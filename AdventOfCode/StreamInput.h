@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+/*
+Input read from a stream (stdin, a pipe, ...) a fixed-size chunk at a time, for days that only need one pass,
+so memory stays bounded however large the input is. Chunks and lines are handed out as views into the
+buffer, only valid until the next call.
+
+Lines are split the same way as Splitter. A line longer than the chunk size grows the buffer to fit,
+so memory is O(chunk size + longest line).
+*/
+class StreamInput {
+private:
+	std::FILE* file;
+	std::vector<char> buffer;
+	size_t begin = 0; // unconsumed data is [begin, end)
+	size_t end = 0;
+	size_t total = 0;
+	bool finished = false;
+
+	// Moves what's left to the front and reads more after it. False if there's nothing more to read.
+	bool fill();
+
+public:
+	static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	explicit StreamInput(std::FILE* file, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+	// Whatever's been read but not yet consumed, reading more first if that's nothing. False at the end.
+	bool nextChunk(std::string_view& chunk);
+
+	// False at the end. Throws runtime_error if reading fails.
+	bool nextLine(std::string_view& line);
+
+	// Read from the stream so far
+	size_t bytesRead() const {
+		return total;
+	}
+};
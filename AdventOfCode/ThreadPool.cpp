@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+namespace {
+	// Which pool/queue the current thread works for, so tasks can submit to their own queue
+	thread_local const ThreadPool* currentPool = nullptr;
+	thread_local size_t currentQueue = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+	if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+
+	for (unsigned i = 0; i < threadCount; i++) queues.push_back(make_unique<Queue>());
+	for (unsigned i = 0; i < threadCount; i++) threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> lock(stateMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (thread& t : threads) t.join();
+}
+
+void ThreadPool::submit(function<void()> task, const void* owner) {
+	size_t index = currentPool == this ? currentQueue : nextQueue++ % queues.size();
+
+	pending++;
+	{
+		Queue& queue = *queues[index];
+		lock_guard<mutex> lock(queue.mutex);
+		queue.tasks.push_back({ move(task), owner });
+	}
+	{
+		// counted under the lock, so a worker can't check for work and then miss the wakeup
+		lock_guard<mutex> lock(stateMutex);
+		queued++;
+	}
+	workAvailable.notify_one();
+}
+
+bool ThreadPool::take(size_t self, bool any, const void* owner, Task& task) {
+	for (size_t i = 0; i < queues.size(); i++) {
+		Queue& queue = *queues[(self + i) % queues.size()];
+		lock_guard<mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) continue;
+
+		// own queue from the front, others' from the back
+		deque<Task>& tasks = queue.tasks;
+		auto matches = [&](const Task& t) { return any || t.owner == owner; };
+		auto found = tasks.end();
+		if (i == 0) found = find_if(tasks.begin(), tasks.end(), matches);
+		else {
+			auto last = find_if(tasks.rbegin(), tasks.rend(), matches);
+			if (last != tasks.rend()) found = prev(last.base());
+		}
+		if (found == tasks.end()) continue;
+
+		task = move(*found);
+		tasks.erase(found);
+		queued--;
+		return true;
+	}
+	return false;
+}
+
+bool ThreadPool::runOne(const void* owner) {
+	Task task;
+	if (!take(currentPool == this ? currentQueue : 0, false, owner, task)) return false;
+	run(task);
+	return true;
+}
+
+void ThreadPool::run(Task& task) {
+	try {
+		task.run();
+	}
+	catch (...) {
+		lock_guard<mutex> lock(stateMutex);
+		if (!firstError) firstError = current_exception();
+	}
+	task.run = nullptr; // release anything captured before reporting it finished
+
+	if (--pending == 0) {
+		lock_guard<mutex> lock(stateMutex);
+		allDone.notify_all();
+	}
+}
+
+void ThreadPool::work(size_t index) {
+	currentPool = this;
+	currentQueue = index;
+
+	Task task;
+	while (true) {
+		if (take(index, true, nullptr, task)) {
+			run(task);
+			continue;
+		}
+
+		unique_lock<mutex> lock(stateMutex);
+		workAvailable.wait(lock, [this]() { return stopping || queued > 0; });
+		if (stopping && queued == 0) return;
+	}
+}
+
+void ThreadPool::wait() {
+	unique_lock<mutex> lock(stateMutex);
+	allDone.wait(lock, [this]() { return pending == 0; });
+
+	if (firstError) {
+		exception_ptr error = firstError;
+		firstError = nullptr;
+		rethrow_exception(error);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <exception>
+
+/*
+Fixed set of worker threads, each with its own queue of tasks, that steal from each other when idle.
+
+Tasks submitted from outside are dealt round-robin across the queues. Tasks submitted by a running task
+go on that worker's own queue, so follow-on work (e.g. a day's parts once it's parsed) stays local unless
+someone else is idle. Owners take from the front of their queue and thieves from the back, so submitting
+the longest jobs first means they're started first, and stragglers are left the short ones.
+
+Each task can be tagged with an owner (e.g. the TaskGroup in Parallel.h that submitted it), so a thread that's
+waiting on some of its own tasks can help run just those, rather than picking up unrelated work.
+*/
+class ThreadPool {
+private:
+	struct Task {
+		std::function<void()> run;
+		const void* owner;
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+
+	std::mutex stateMutex;
+	std::condition_variable workAvailable;
+	std::condition_variable allDone;
+	std::atomic<size_t> queued{ 0 }; // sitting in a queue
+	std::atomic<size_t> pending{ 0 }; // submitted but not yet finished
+	std::atomic<size_t> nextQueue{ 0 };
+	bool stopping = false;
+	std::exception_ptr firstError;
+
+	// any = take whatever's available, rather than only tasks for owner
+	bool take(size_t self, bool any, const void* owner, Task& task);
+	void run(Task& task);
+	void work(size_t index);
+
+public:
+	// 0 = one thread per core
+	explicit ThreadPool(unsigned threadCount = 0);
+	// Finishes everything already submitted
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	size_t size() const {
+		return threads.size();
+	}
+
+	void submit(std::function<void()> task, const void* owner = nullptr);
+
+	// Runs one queued task for owner on the calling thread, if there are any. Returns whether it did.
+	bool runOne(const void* owner);
+
+	// Blocks until every submitted task, and anything they submitted, has finished.
+	// Rethrows the first exception a task threw, if any.
+	void wait();
+};
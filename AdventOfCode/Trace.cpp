@@ -0,0 +1,85 @@
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "Trace.h"
+
+using namespace std;
+
+namespace trace {
+	struct Event {
+		string name;
+		const char* argName;
+		int64_t argValue;
+		int64_t startUs;
+		int64_t durationUs;
+		int tid;
+	};
+
+	atomic<bool> tracing{ false };
+	const auto epoch = chrono::steady_clock::now();
+
+	mutex eventsMutex;
+	vector<Event> events;
+
+	int64_t nowUs() {
+		return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - epoch).count();
+	}
+
+	// small sequential ids, rather than the platform's thread ids
+	int threadId() {
+		static atomic<int> nextId{ 1 };
+		thread_local int id = nextId++;
+		return id;
+	}
+
+	void enable() {
+		tracing = true;
+	}
+
+	bool enabled() {
+		return tracing;
+	}
+
+	Scope::Scope(string_view name, const char* argName, int64_t argValue)
+		: active(tracing), argName(argName), argValue(argValue), startUs(0) {
+		// don't even copy the name unless recording
+		if (!active) return;
+		this->name = name;
+		startUs = nowUs();
+	}
+
+	Scope::~Scope() {
+		if (!active) return;
+		int64_t end = nowUs();
+		lock_guard<mutex> lock(eventsMutex);
+		events.push_back({ move(name), argName, argValue, startUs, end - startUs, threadId() });
+	}
+
+	string jsonString(const string& s) {
+		string escaped = "\"";
+		for (char c : s) {
+			if (c == '"' || c == '\\') escaped += '\\';
+			escaped += c;
+		}
+		return escaped + "\"";
+	}
+
+	void write(ostream& out) {
+		lock_guard<mutex> lock(eventsMutex);
+
+		// "X" = complete event, with a start and duration in microseconds
+		out << "{\"traceEvents\": [";
+		for (size_t i = 0; i < events.size(); i++) {
+			const Event& e = events[i];
+			out << (i == 0 ? "\n" : ",\n")
+				<< "  {\"name\": " << jsonString(e.name) << ", \"cat\": \"aoc\", \"ph\": \"X\""
+				<< ", \"ts\": " << e.startUs << ", \"dur\": " << e.durationUs
+				<< ", \"pid\": 1, \"tid\": " << e.tid;
+			if (e.argName != nullptr) out << ", \"args\": {" << jsonString(e.argName) << ": " << e.argValue << "}";
+			out << "}";
+		}
+		out << "\n], \"displayTimeUnit\": \"ms\"}" << endl;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstdint>
+
+/*
+Scoped trace events, to see where time goes inside a part, e.g.
+
+	TRACE_SCOPE("floydWarshall");
+	TRACE_SCOPE_ARG("mix", "iteration", i);
+
+Each scope records one complete event from construction to the end of the enclosing block,
+written out in Chrome trace format (open in ui.perfetto.dev or chrome://tracing).
+
+Only built in when AOC_TRACE is defined (CMake -DAOC_TRACE=ON). Otherwise the macros expand to nothing,
+so their arguments aren't evaluated either. Even when built in, nothing is recorded until enable() is called.
+*/
+namespace trace {
+#ifdef AOC_TRACE
+	constexpr bool compiledIn = true;
+#else
+	constexpr bool compiledIn = false;
+#endif
+
+	void enable();
+	bool enabled();
+
+	// Everything recorded so far, as a Chrome trace JSON document
+	void write(std::ostream& out);
+
+	class Scope {
+	private:
+		bool active;
+		std::string name;
+		const char* argName;
+		int64_t argValue;
+		int64_t startUs;
+
+	public:
+		explicit Scope(std::string_view name, const char* argName = nullptr, int64_t argValue = 0);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+}
+
+#ifdef AOC_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) ::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, argName, value) ::trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name, argName, value)
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_SCOPE_ARG(name, argName, value)
+#endif